@@ -60,6 +60,25 @@
 User = get_user_model()
 
 
+def pytest_addoption(parser: pytest.Parser) -> None:
+    """Add the benchmark options (see greenova/tests/test_benchmarks.py)."""
+    parser.addoption(
+        "--timing-budgets",
+        action="store_true",
+        default=False,
+        help="Fail benchmarks over their p95 budget without pytest-benchmark too",
+    )
+
+
+@pytest.fixture(name="eager_background_jobs", autouse=True)
+def eager_background_jobs_fixture(settings: Any) -> None:
+    """Run background jobs inline, so tests need no worker.
+
+    Tests of the job queue itself switch BACKGROUND_JOBS_EAGER back off.
+    """
+    settings.BACKGROUND_JOBS_EAGER = True
+
+
 @pytest.fixture(name="admin_user")
 def admin_user_fixture() -> Any:
     """Create and return a superuser."""
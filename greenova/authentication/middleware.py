@@ -3,6 +3,7 @@
 import logging
 from collections.abc import Callable
 
+from asgiref.sync import iscoroutinefunction, markcoroutinefunction
 from django.http import HttpRequest, HttpResponse
 from django_htmx.middleware import HtmxDetails
 
@@ -16,7 +17,15 @@ class CustomHttpRequest(HttpRequest):
 
 
 class LogoutStateMiddleware:
-    """Middleware to handle post-logout state and ensure proper page rendering."""
+    """Middleware to handle post-logout state and ensure proper page rendering.
+
+    Works in both sync and async mode; under ASGI the async path uses the
+    session's and user's async accessors, so async views stay on the event
+    loop.
+    """
+
+    sync_capable = True
+    async_capable = True
 
     def __init__(self, get_response: Callable[[HttpRequest], HttpResponse]) -> None:
         """Initialize the middleware.
@@ -25,6 +34,9 @@ def __init__(self, get_response: Callable[[HttpRequest], HttpResponse]) -> None:
             get_response: The next middleware/view in the chain
         """
         self.get_response = get_response
+        self.async_mode = iscoroutinefunction(get_response)
+        if self.async_mode:
+            markcoroutinefunction(self)
 
     def __call__(self, request: CustomHttpRequest) -> HttpResponse:
         """Process the request through the middleware.
@@ -35,36 +47,75 @@ def __call__(self, request: CustomHttpRequest) -> HttpResponse:
         Returns:
             HttpResponse: The response from the next middleware/view
         """
-        htmx = getattr(request, "htmx", None)
+        if self.async_mode:
+            return self.__acall__(request)
+
         was_authenticated = request.session.get("_was_authenticated", False)
-        is_landing = request.path == "/landing/"
+        is_authenticated = request.user.is_authenticated
 
         # Mark if user just logged out
-        if was_authenticated and not request.user.is_authenticated:
+        if was_authenticated and not is_authenticated:
             request.session["_post_logout"] = True
             logger.debug("Post-logout state set for user")
 
         # Check if this is a post-logout request
-        request.is_post_logout = (
-            request.session.pop("_post_logout", False) and is_landing
+        self._mark_post_logout(request, request.session.pop("_post_logout", False))
+        for key, value in self._session_flags(request, is_authenticated).items():
+            request.session[key] = value
+
+        response = self.get_response(request)
+
+        # Clean up session flags
+        request.session.pop("_htmx_redirect", None)
+        request.session.pop("_force_refresh", None)
+
+        return response
+
+    async def __acall__(self, request: CustomHttpRequest) -> HttpResponse:
+        """Process the request like __call__, without blocking the event loop."""
+        was_authenticated = await request.session.aget("_was_authenticated", False)
+        user = await request.auser()
+        # Resolved once: later sync code reads it without another query
+        request.user = user
+        is_authenticated = user.is_authenticated
+
+        if was_authenticated and not is_authenticated:
+            await request.session.aset("_post_logout", True)
+            logger.debug("Post-logout state set for user")
+
+        self._mark_post_logout(
+            request, await request.session.apop("_post_logout", False)
         )
+        for key, value in self._session_flags(request, is_authenticated).items():
+            await request.session.aset(key, value)
+
+        response = await self.get_response(request)
 
+        await request.session.apop("_htmx_redirect", None)
+        await request.session.apop("_force_refresh", None)
+
+        return response
+
+    @staticmethod
+    def _mark_post_logout(request: CustomHttpRequest, post_logout: bool) -> None:
+        request.is_post_logout = post_logout and request.path == "/landing/"
+
+    @staticmethod
+    def _session_flags(
+        request: CustomHttpRequest, is_authenticated: bool
+    ) -> dict[str, bool]:
+        """Return the session flags to set before the view runs."""
+        flags = {}
         if request.is_post_logout:
             logger.debug("Processing post-logout request to landing page")
+            htmx = getattr(request, "htmx", None)
             if isinstance(htmx, HtmxDetails) and htmx.is_htmx:
                 # For HTMX requests, ensure smooth transition
-                request.session["_htmx_redirect"] = True
+                flags["_htmx_redirect"] = True
             else:
                 # For regular requests, ensure full page load
-                request.session["_force_refresh"] = True
+                flags["_force_refresh"] = True
 
         # Update authentication state for next request
-        request.session["_was_authenticated"] = request.user.is_authenticated
-
-        response = self.get_response(request)
-
-        # Clean up session flags
-        request.session.pop("_htmx_redirect", None)
-        request.session.pop("_force_refresh", None)
-
-        return response
+        flags["_was_authenticated"] = is_authenticated
+        return flags
@@ -1,10 +1,13 @@
 
 from django.contrib.auth import get_user_model
-from django.db import models
+from django.db import models, transaction
+from django.db.models.signals import post_delete, post_save
+from django.dispatch import receiver
 from django.utils import timezone
 
 # Import proto utility functions at the top level
 from .proto_utils import deserialize_chat_message, serialize_chat_message
+from .retrieval import invalidate_indexes
 
 User = get_user_model()
 
@@ -82,3 +85,13 @@ class TrainingData(models.Model):
     def __str__(self):
         question_str = str(self.question)
         return f"{question_str[:50]}"
+
+@receiver([post_save, post_delete], sender=PredefinedResponse)
+@receiver([post_save, post_delete], sender=TrainingData)
+def invalidate_chatbot_indexes(sender, **kwargs):
+    """Rebuild the reply indexes after training data or triggers change.
+
+    Deferred to commit, so no worker rebuilds from the old rows and then
+    keeps them under the new version.
+    """
+    transaction.on_commit(invalidate_indexes)
@@ -9,73 +9,17 @@
 chatbot application.
 """
 import logging
-import os
 import time
 from typing import Any, Dict, Optional
 
 from django.contrib.auth import get_user_model
 from django.utils import timezone
 
-# Import datetime explicitly to fix the module attribute error
+from .proto import chatbot_pb2
 
 User = get_user_model()
 logger = logging.getLogger(__name__)
 
-# Create minimal stubs for the protocol buffer classes
-class DummyMessage:
-    """Stub class used when protocol buffers are not available."""
-
-    def SerializeToString(self) -> bytes:
-        return b''
-
-    def ParseFromString(self, data: bytes) -> None:
-        pass
-
-# Import generated protobuf modules with improved error handling
-try:
-    # Use relative import to ensure consistent module path
-    from .proto import chatbot_pb2
-    logger.info("Successfully imported chatbot_pb2 from proto package")
-except ImportError:
-    logger.error("Failed to import chatbot_pb2. Protocol buffer definition missing.")
-
-    # Check if the proto file exists
-    current_dir = os.path.dirname(os.path.abspath(__file__))
-    proto_file = os.path.join(current_dir, 'proto', 'chatbot.proto')
-
-    if os.path.exists(proto_file):
-        logger.info(
-            "chatbot.proto exists but chatbot_pb2.py not found. "
-            "Run 'python manage.py compile_protos --app=chatbot' to generate it."
-        )
-    else:
-        logger.error("chatbot.proto file not found in the proto directory.")
-
-    # Create a minimal stub for the module to allow Django to continue loading
-    chatbot_pb2 = type('chatbot_pb2', (), {})
-
-    # Define minimal classes needed for type hinting
-    class ChatMessage(DummyMessage):
-        class MessageType:
-            MESSAGE_TYPE_TEXT_UNSPECIFIED = 0
-            MESSAGE_TYPE_IMAGE = 1
-            MESSAGE_TYPE_AUDIO = 2
-
-        def __init__(self):
-            self.user_id = ""
-            self.content = ""
-            self.timestamp = 0
-            self.type = self.MessageType.MESSAGE_TYPE_TEXT_UNSPECIFIED
-
-    class ChatResponse(DummyMessage):
-        def __init__(self):
-            self.message_id = ""
-            self.content = ""
-            self.timestamp = 0
-
-    chatbot_pb2.ChatMessage = ChatMessage
-    chatbot_pb2.ChatResponse = ChatResponse
-
 
 def serialize_chat_message(chat_message) -> Optional[bytes]:
     """
@@ -0,0 +1,255 @@
+"""
+In-memory retrieval indexes for chatbot replies.
+
+Answering a message used to load every ``TrainingData`` row and every
+matching ``PredefinedResponse`` from the database. Instead, each worker
+builds two structures once and reuses them for every message:
+
+* ``TrainingIndex``: an inverted index from token to training items with
+  precomputed BM25 weights, so scoring a message only touches the postings
+  of the words it contains.
+* ``TriggerMatcher``: an Aho–Corasick automaton over all trigger phrases,
+  which finds every trigger occurring in a message, as whole words, in one
+  pass over it.
+
+Both are rebuilt on the next message after a training item or predefined
+response changes: the save/delete signals bump the ``chatbot`` cache
+namespace version, which every worker compares with the version its
+indexes were built from.
+"""
+
+import logging
+import math
+import re
+import threading
+from collections import Counter, defaultdict, deque
+from dataclasses import dataclass
+from typing import Dict, Iterable, List, Optional, Tuple
+
+from core.utils.cache import get_namespace_version, invalidate_namespace
+
+logger = logging.getLogger(__name__)
+
+CHATBOT_SCOPE = 'chatbot'
+
+# Standard BM25 parameters
+BM25_K1 = 1.2
+BM25_B = 0.75
+
+_TOKEN_PATTERN = re.compile(r'\w+')
+
+
+def tokenize(text: str) -> List[str]:
+    """Split text into lowercase word tokens."""
+    return _TOKEN_PATTERN.findall((text or '').lower())
+
+
+class TrainingIndex:
+    """Inverted index over training questions with precomputed BM25 weights."""
+
+    def __init__(self, items: Iterable[Tuple[int, str, str]]) -> None:
+        """
+        Build the index.
+
+        Args:
+            items: ``(id, question, answer)`` tuples
+        """
+        self.answers: Dict[int, str] = {}
+        term_counts: Dict[int, Counter] = {}
+        for item_id, question, answer in items:
+            counts = Counter(tokenize(question))
+            if counts:
+                self.answers[item_id] = answer
+                term_counts[item_id] = counts
+
+        self.postings: Dict[str, List[Tuple[int, float]]] = defaultdict(list)
+        if not term_counts:
+            return
+        lengths = {
+            item_id: sum(counts.values()) for item_id, counts in term_counts.items()
+        }
+        average_length = sum(lengths.values()) / len(lengths)
+        document_frequency = Counter(
+            token for counts in term_counts.values() for token in counts
+        )
+        total = len(term_counts)
+        for item_id, counts in term_counts.items():
+            norm = BM25_K1 * (1 - BM25_B + BM25_B * lengths[item_id] / average_length)
+            for token, frequency in counts.items():
+                df = document_frequency[token]
+                idf = math.log(1 + (total - df + 0.5) / (df + 0.5))
+                weight = idf * frequency * (BM25_K1 + 1) / (frequency + norm)
+                self.postings[token].append((item_id, weight))
+
+    def __len__(self) -> int:
+        return len(self.answers)
+
+    def best_answer(self, text: str) -> Optional[str]:
+        """Return the answer of the highest scoring item, or None if none match."""
+        scores: Dict[int, float] = defaultdict(float)
+        for token in set(tokenize(text)):
+            for item_id, weight in self.postings.get(token, ()):
+                scores[item_id] += weight
+        if not scores:
+            return None
+        # Oldest item wins ties
+        best = max(scores, key=lambda item_id: (scores[item_id], -item_id))
+        return self.answers[best]
+
+
+def _is_word_char(char: str) -> bool:
+    """Check ``char`` is part of a word, as ``\\w`` matches it."""
+    return char.isalnum() or char == '_'
+
+
+class TriggerMatcher:
+    """
+    Aho–Corasick automaton finding every trigger phrase inside a text.
+
+    A phrase only matches on word boundaries, so "hi" is found in "hi there"
+    but not in "this" or "which".
+    """
+
+    def __init__(self, phrases: Iterable[Tuple[int, str]]) -> None:
+        """
+        Build the automaton.
+
+        Args:
+            phrases: ``(key, phrase)`` tuples; matching is case-insensitive
+        """
+        self._goto: List[Dict[str, int]] = [{}]
+        self._fail: List[int] = [0]
+        # Per state: (key, phrase) of every phrase ending there
+        self._output: List[List[Tuple[int, str]]] = [[]]
+        for key, phrase in phrases:
+            phrase = (phrase or '').lower()
+            if phrase:
+                self._add(key, phrase)
+        self._link()
+
+    def _add(self, key: int, phrase: str) -> None:
+        state = 0
+        for char in phrase:
+            next_state = self._goto[state].get(char)
+            if next_state is None:
+                next_state = len(self._goto)
+                self._goto[state][char] = next_state
+                self._goto.append({})
+                self._fail.append(0)
+                self._output.append([])
+            state = next_state
+        self._output[state].append((key, phrase))
+
+    def _link(self) -> None:
+        """Compute failure links breadth first and merge their outputs."""
+        queue = deque(self._goto[0].values())
+        while queue:
+            state = queue.popleft()
+            for char, next_state in self._goto[state].items():
+                queue.append(next_state)
+                fail = self._fail[state]
+                while fail and char not in self._goto[fail]:
+                    fail = self._fail[fail]
+                self._fail[next_state] = self._goto[fail].get(char, 0)
+                self._output[next_state] += self._output[self._fail[next_state]]
+
+    def find(self, text: str) -> set:
+        """Return the keys of every phrase occurring in ``text`` as whole words."""
+        text = (text or '').lower()
+        found = set()
+        state = 0
+        for end, char in enumerate(text):
+            while state and char not in self._goto[state]:
+                state = self._fail[state]
+            state = self._goto[state].get(char, 0)
+            for key, phrase in self._output[state]:
+                if key not in found and self._on_boundaries(text, end, phrase):
+                    found.add(key)
+        return found
+
+    @staticmethod
+    def _on_boundaries(text: str, end: int, phrase: str) -> bool:
+        """Check ``phrase``, ending at ``text[end]``, does not cut into a word."""
+        before = end - len(phrase)
+        after = end + 1
+        if before >= 0 and _is_word_char(phrase[0]) and _is_word_char(text[before]):
+            return False
+        if after < len(text) and _is_word_char(phrase[-1]):
+            return not _is_word_char(text[after])
+        return True
+
+
+@dataclass
+class ChatbotIndexes:
+    """The indexes one worker answers messages from."""
+
+    version: int
+    training: TrainingIndex
+    triggers: TriggerMatcher
+    # Predefined response id -> (priority, trigger length, response text)
+    responses: Dict[int, Tuple[int, int, str]]
+
+    def predefined_response(self, text: str) -> Optional[str]:
+        """
+        Return the response whose trigger occurs in ``text``.
+
+        The highest priority wins, then the longest (most specific) trigger.
+        """
+        matches = self.triggers.find(text)
+        if not matches:
+            return None
+        best = max(matches, key=lambda response_id: self.responses[response_id][:2])
+        return self.responses[best][2]
+
+
+_indexes: Optional[ChatbotIndexes] = None
+_lock = threading.Lock()
+
+
+def build_indexes(version: int = 0) -> ChatbotIndexes:
+    """Load training data and predefined responses into fresh indexes."""
+    from .models import PredefinedResponse, TrainingData
+
+    rows = list(
+        PredefinedResponse.objects.values_list(
+            'id', 'trigger_phrase', 'response_text', 'priority'
+        )
+    )
+    responses = {
+        response_id: (priority, len(trigger or ''), text)
+        for response_id, trigger, text, priority in rows
+    }
+    indexes = ChatbotIndexes(
+        version=version,
+        training=TrainingIndex(
+            TrainingData.objects.values_list('id', 'question', 'answer').iterator()
+        ),
+        triggers=TriggerMatcher((row[0], row[1]) for row in rows),
+        responses=responses,
+    )
+    logger.info(
+        'Built chatbot indexes: %d training items, %d predefined responses',
+        len(indexes.training),
+        len(responses),
+    )
+    return indexes
+
+
+def get_indexes() -> ChatbotIndexes:
+    """Return this worker's indexes, rebuilding them if the data changed."""
+    global _indexes
+    version = get_namespace_version(CHATBOT_SCOPE)
+    indexes = _indexes
+    if indexes is None or indexes.version != version:
+        with _lock:
+            if _indexes is None or _indexes.version != version:
+                _indexes = build_indexes(version)
+            indexes = _indexes
+    return indexes
+
+
+def invalidate_indexes() -> None:
+    """Make every worker rebuild its indexes before the next message."""
+    global _indexes
+    _indexes = None
+    invalidate_namespace(CHATBOT_SCOPE)
@@ -1,12 +1,22 @@
 import logging
+import re
 
-from django.db.models import Q
+from asgiref.sync import sync_to_async
+from django.db import transaction
+from django.utils import timezone
 
-from .models import ChatMessage, Conversation, PredefinedResponse, TrainingData
+from .models import ChatMessage, Conversation
 from .proto_utils import create_chat_response, parse_chat_response
+from .retrieval import get_indexes
 
 logger = logging.getLogger(__name__)
 
+NO_ANSWER_RESPONSE = "I'm sorry, I don't have an answer for that question."
+
+# Words with their trailing whitespace, the unit bot replies are streamed in
+_CHUNK_PATTERN = re.compile(r'\S+\s*')
+
+
 class ChatbotService:
     """Service class for chatbot logic."""
 
@@ -23,22 +33,56 @@ def create_conversation(user, title=None):
     @staticmethod
     def add_message(conversation_id, content, is_bot=False, attachments=None):
         """Add a new message to a conversation."""
-        try:
-            conversation = Conversation.objects.get(id=conversation_id)
-            message = ChatMessage.objects.create(
-                conversation=conversation,
-                content=content,
-                is_bot=is_bot,
-                attachments=attachments or []
+        messages = ChatbotService.add_messages(
+            conversation_id,
+            [ChatbotService._build_message(content, is_bot, attachments)],
+        )
+        return messages[0] if messages else None
+
+    @staticmethod
+    def _build_message(content, is_bot=False, attachments=None, timestamp=None):
+        return ChatMessage(
+            content=content,
+            is_bot=is_bot,
+            attachments=attachments or [],
+            timestamp=timestamp or timezone.now(),
+        )
+
+    @staticmethod
+    def add_messages(conversation_id, messages):
+        """
+        Save unsaved messages to a conversation in one batch.
+
+        The conversation timestamp is bumped with a single UPDATE instead of
+        loading and re-saving the conversation, and all messages go in with
+        one INSERT, inside one transaction.
+
+        Returns:
+            list: The saved messages, or None if the conversation does not exist
+        """
+        with transaction.atomic():
+            updated = Conversation.objects.filter(id=conversation_id).update(
+                updated_at=timezone.now()
             )
+            if not updated:
+                logger.error("Conversation with ID %s does not exist", conversation_id)
+                return None
+            for message in messages:
+                message.conversation_id = conversation_id
+            return ChatMessage.objects.bulk_create(messages)
 
-            # Update conversation last updated timestamp
-            conversation.save()
+    @staticmethod
+    async def aadd_messages(conversation_id, messages):
+        """
+        Async version of add_messages().
 
-            return message
-        except Conversation.DoesNotExist:
-            logger.error("Conversation with ID %s does not exist", conversation_id)
-            return None
+        The async ORM runs each query in autocommit mode, so the UPDATE and
+        INSERT are run together by add_messages() in the sync thread, where
+        they share one transaction.
+        """
+        return await sync_to_async(ChatbotService.add_messages, thread_sensitive=True)(
+            conversation_id, messages
+        )
 
     @staticmethod
     def get_conversation_messages(conversation_id):
@@ -51,16 +95,20 @@ def get_conversation_messages(conversation_id):
             return []
 
     @staticmethod
-    def process_user_message(conversation_id, message_text):
-        """Process a user message and generate a response."""
+    def generate_reply(message_text):
+        """Return the bot's reply to a message."""
         # First check for predefined responses
-        predefined = ChatbotService._check_predefined_responses(message_text)
+        response_text = ChatbotService._check_predefined_responses(message_text)
 
-        if predefined:
-            response_text = predefined.response_text
-        else:
+        if response_text is None:
             # Otherwise, generate a response based on training data
             response_text = ChatbotService._generate_response(message_text)
+        return response_text
+
+    @staticmethod
+    def process_user_message(conversation_id, message_text):
+        """Process a user message and generate a response."""
+        response_text = ChatbotService.generate_reply(message_text)
 
         # Add the bot's response to the conversation
         ChatbotService.add_message(
@@ -72,41 +120,44 @@ def process_user_message(conversation_id, message_text):
         return response_text
 
     @staticmethod
-    def _check_predefined_responses(message_text):
-        """Check if message matches any predefined responses."""
-        # Search for exact or partial matches in trigger phrases
-        predefined_responses = PredefinedResponse.objects.filter(
-            Q(trigger_phrase__iexact=message_text) |
-            Q(trigger_phrase__icontains=message_text)
-        ).order_by('-priority')
+    async def aexchange(conversation_id, message_text):
+        """
+        Reply to a user message, saving both messages in one batch.
+
+        Returns:
+            tuple: The saved (user message, bot message), or None if the
+            conversation does not exist
+        """
+        user_message = ChatbotService._build_message(message_text)
+        # Rebuilding the reply indexes may query the database
+        response_text = await sync_to_async(ChatbotService.generate_reply)(
+            message_text
+        )
+        bot_message = ChatbotService._build_message(response_text, is_bot=True)
+        messages = await ChatbotService.aadd_messages(
+            conversation_id, [user_message, bot_message]
+        )
+        return tuple(messages) if messages else None
 
-        return predefined_responses.first()
+    @staticmethod
+    def reply_chunks(response_text):
+        """Split a reply into the word-sized pieces it is streamed in."""
+        return _CHUNK_PATTERN.findall(response_text) or [response_text]
+
+    @staticmethod
+    def _check_predefined_responses(message_text):
+        """Return the response of the best trigger phrase in the message, if any."""
+        return get_indexes().predefined_response(message_text)
 
     @staticmethod
     def _generate_response(message_text):
         """Generate a response based on training data."""
-        # Simple keyword matching from training data
-        matches = []
-
-        for training_item in TrainingData.objects.all():
-            # Check if any words in the question match the user's message
-            question_words = set(training_item.question.lower().split())
-            message_words = set(message_text.lower().split())
-
-            # Calculate a simple match score
-            intersection = question_words.intersection(message_words)
-            if intersection:
-                score = len(intersection) / len(question_words)
-                matches.append((score, training_item.answer))
-
-        # Sort by match score
-        matches.sort(reverse=True)
-
-        if matches:
-            return matches[0][1]
+        answer = get_indexes().training.best_answer(message_text)
+        if answer is not None:
+            return answer
 
         # Default response if no match found
-        return "I'm sorry, I don't have an answer for that question."
+        return NO_ANSWER_RESPONSE
 
     @staticmethod
     def serialize_message(message_id, content):
@@ -9,5 +9,6 @@
     path('conversation/new/', views.create_conversation, name='create_conversation'),
     path('conversation/<int:conversation_id>/', views.conversation_detail, name='conversation_detail'),
     path('conversation/<int:conversation_id>/send/', views.send_message, name='send_message'),
+    path('conversation/<int:conversation_id>/stream/', views.stream_message, name='stream_message'),
     path('conversation/<int:conversation_id>/delete/', views.delete_conversation, name='delete_conversation'),
 ]
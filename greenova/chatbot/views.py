@@ -2,7 +2,7 @@
 import logging
 
 from django.contrib.auth.decorators import login_required
-from django.http import JsonResponse
+from django.http import Http404, JsonResponse, StreamingHttpResponse
 from django.shortcuts import get_object_or_404, redirect, render
 from django.utils.html import escape
 from django.views.decorators.http import require_POST
@@ -14,6 +14,26 @@
 logger = logging.getLogger(__name__)
 
 
+async def _get_user_conversation(request, conversation_id):
+    """Return the request user's conversation or raise Http404."""
+    user = await request.auser()
+    try:
+        return await Conversation.objects.aget(id=conversation_id, user=user)
+    except Conversation.DoesNotExist as exc:
+        raise Http404('No conversation matches the given query.') from exc
+
+
+def _message_text(request):
+    """Return the stripped message from a JSON request body."""
+    data = json.loads(request.body)
+    return data.get('message', '').strip()
+
+
+def _sse_event(event, data):
+    """Format one server-sent event."""
+    return f'event: {event}\ndata: {json.dumps(data)}\n\n'
+
+
 @login_required
 def chatbot_home(request):
     """Main chatbot interface showing conversation list and a selected conversation."""
@@ -81,30 +101,21 @@ def conversation_detail(request, conversation_id):
 
 @login_required
 @require_POST
-def send_message(request, conversation_id):
+async def send_message(request, conversation_id):
     """Process a new message in a conversation."""
-    query = {'id': conversation_id, 'user': request.user}
-    conversation = get_object_or_404(Conversation, **query)
+    conversation = await _get_user_conversation(request, conversation_id)
 
     try:
-        data = json.loads(request.body)
-        message_text = data.get('message', '').strip()
+        message_text = _message_text(request)
 
         if not message_text:
             return JsonResponse({'error': 'Message cannot be empty'}, status=400)
 
-        # Save user message
-        user_message = ChatbotService.add_message(
-            conversation_id=conversation.id,
-            content=message_text,
-            is_bot=False
-        )
-
-        # Process and get bot response
-        bot_response = ChatbotService.process_user_message(
-            conversation.id,
-            message_text
-        )
+        # Save the user message and the bot response in one batch
+        exchange = await ChatbotService.aexchange(conversation.id, message_text)
+        if exchange is None:
+            raise Http404('No conversation matches the given query.')
+        user_message, bot_message = exchange
 
         return JsonResponse({
             'user_message': {
@@ -113,7 +124,7 @@ def send_message(request, conversation_id):
                 'timestamp': user_message.timestamp.isoformat(),
             },
             'bot_response': {
-                'content': escape(bot_response),
+                'content': escape(bot_message.content),
             }
         })
     except json.JSONDecodeError as e:
@@ -130,6 +141,51 @@ def send_message(request, conversation_id):
         return JsonResponse({'error': 'A runtime error occurred'}, status=500)
 
 
+@login_required
+@require_POST
+async def stream_message(request, conversation_id):
+    """
+    Process a new message and stream the bot response as server-sent events.
+
+    Emits a ``user`` event with the saved user message, ``token`` events
+    with pieces of the response as they are produced, and a ``done`` event
+    with the saved bot message.
+    """
+    conversation = await _get_user_conversation(request, conversation_id)
+
+    try:
+        message_text = _message_text(request)
+    except json.JSONDecodeError as e:
+        logger.error('Invalid JSON in request body: %s', str(e))
+        return JsonResponse({'error': 'Invalid JSON format'}, status=400)
+    if not message_text:
+        return JsonResponse({'error': 'Message cannot be empty'}, status=400)
+
+    exchange = await ChatbotService.aexchange(conversation.id, message_text)
+    if exchange is None:
+        raise Http404('No conversation matches the given query.')
+    user_message, bot_message = exchange
+
+    async def events():
+        yield _sse_event('user', {
+            'id': user_message.id,
+            'content': escape(user_message.content),
+            'timestamp': user_message.timestamp.isoformat(),
+        })
+        for chunk in ChatbotService.reply_chunks(bot_message.content):
+            yield _sse_event('token', {'content': escape(chunk)})
+        yield _sse_event('done', {
+            'id': bot_message.id,
+            'timestamp': bot_message.timestamp.isoformat(),
+        })
+
+    response = StreamingHttpResponse(events(), content_type='text/event-stream')
+    response['Cache-Control'] = 'no-cache'
+    # Stop proxies from buffering the stream
+    response['X-Accel-Buffering'] = 'no'
+    return response
+
+
 @login_required
 def delete_conversation(request, conversation_id):
     """Delete a conversation."""
@@ -1,9 +1,12 @@
 import logging
 
+from core.utils.files import delete_unreferenced_file, store_content_addressed
 from django.contrib.auth.models import User
 from django.core.exceptions import ValidationError
-from django.db import models
+from django.db import models, transaction
 from django.db.models import QuerySet
+from django.db.models.signals import post_delete
+from django.dispatch import receiver
 from django.utils import timezone
 
 logger = logging.getLogger(__name__)
@@ -196,6 +199,9 @@ def clean(self):
                 raise ValidationError({"role": "A company can only have one owner."})
 
 
+COMPANY_DOCUMENT_STORAGE_PREFIX = "company_documents/sha256"
+
+
 class CompanyDocument(models.Model):
     """Model for storing company documents."""
 
@@ -204,7 +210,7 @@ class CompanyDocument(models.Model):
     )
     name = models.CharField(max_length=255)
     description = models.TextField(blank=True)
-    file = models.FileField(upload_to="company_documents/")
+    file = models.FileField(upload_to="company_documents/", max_length=255)
     document_type = models.CharField(max_length=100, blank=True)
     uploaded_by = models.ForeignKey(
         User,
@@ -213,6 +219,9 @@ class CompanyDocument(models.Model):
         related_name="uploaded_company_documents",
     )
     uploaded_at = models.DateTimeField(auto_now_add=True)
+    original_name = models.CharField(max_length=255, blank=True)
+    sha256 = models.CharField(max_length=64, blank=True, db_index=True)
+    size = models.PositiveBigIntegerField(null=True, blank=True)
 
     class Meta:
         ordering = ["-uploaded_at"]
@@ -222,6 +231,26 @@ class Meta:
     def __str__(self) -> str:
         return f"{self.name} ({self.company.name})"
 
+    @property
+    def display_name(self) -> str:
+        """The uploaded file name, for downloads."""
+        return self.original_name or self.file.name.rsplit("/", 1)[-1]
+
+    def store_upload(self, upload) -> None:
+        """Store an uploaded file content-addressed and record its hash and size."""
+        self.original_name = (upload.name or "")[:255]
+        self.sha256, self.size = store_content_addressed(
+            self, "file", upload, COMPANY_DOCUMENT_STORAGE_PREFIX
+        )
+
+
+@receiver(post_delete, sender=CompanyDocument)
+def delete_company_document_file(sender, instance, **kwargs):
+    """Remove a stored document once no other document shares it."""
+    transaction.on_commit(
+        lambda: delete_unreferenced_file(instance.file, CompanyDocument, "file")
+    )
+
 
 class Obligation(models.Model):
     """Model representing an environmental obligation."""
@@ -59,8 +59,14 @@ class CompanyDocument(models.Model):
     document_type: str
     uploaded_by: User | None
     uploaded_at: datetime
+    original_name: str
+    sha256: str
+    size: int | None
 
     def __str__(self) -> str: ...
+    @property
+    def display_name(self) -> str: ...
+    def store_upload(self, upload: Any) -> None: ...
 
 class Obligation(models.Model):
     company: Company
@@ -1,12 +1,13 @@
 import logging
 from typing import Any
 
+from core.utils.files import file_download_response
 from django.contrib import messages
 from django.contrib.auth import get_user_model
 from django.contrib.auth.decorators import login_required
 from django.contrib.auth.mixins import LoginRequiredMixin
 from django.db.models import Count, Q
-from django.http import HttpRequest, HttpResponse, JsonResponse
+from django.http import Http404, HttpRequest, HttpResponse, JsonResponse
 from django.shortcuts import get_object_or_404, redirect, render
 from django.template.loader import render_to_string
 from django.urls import reverse_lazy
@@ -518,6 +519,7 @@ def upload_document(request: HttpRequest, company_id: int) -> HttpResponse:
             document = form.save(commit=False)
             document.company = company
             document.uploaded_by = request.user
+            document.store_upload(form.cleaned_data["file"])
             document.save()
 
             messages.success(
@@ -546,6 +548,26 @@ def upload_document(request: HttpRequest, company_id: int) -> HttpResponse:
     return render(request, "company/document_form.html", context)
 
 
+@login_required
+def download_document(
+    request: HttpRequest, company_id: int, document_id: int
+) -> HttpResponse:
+    """Serve a company document to the company's members."""
+    document = get_object_or_404(
+        CompanyDocument, id=document_id, company_id=company_id
+    )
+    if not (
+        request.user.is_superuser
+        or CompanyMembership.objects.filter(
+            company_id=company_id, user=request.user
+        ).exists()
+    ):
+        raise Http404("Document not found")
+    return file_download_response(
+        request, document.file, filename=document.display_name, size=document.size
+    )
+
+
 @login_required
 def delete_document(
     request: HttpRequest, company_id: int, document_id: int
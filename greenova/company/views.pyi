@@ -59,6 +59,9 @@ def update_member_role(
     request: HttpRequest, company_id: int, member_id: int
 ) -> HttpResponse: ...
 def upload_document(request: HttpRequest, company_id: int) -> HttpResponse: ...
+def download_document(
+    request: HttpRequest, company_id: int, document_id: int
+) -> HttpResponse: ...
 def delete_document(
     request: HttpRequest, company_id: int, document_id: int
 ) -> HttpResponse: ...
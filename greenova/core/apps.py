@@ -20,3 +20,22 @@ def ready(self):
 
         # Set site-wide settings
         admin.site.enable_nav_sidebar = True
+
+        # Retire cached charts when the data they plot changes
+        # pylint: disable=import-outside-toplevel
+        from core.utils.chart_cache import connect_chart_cache_signals
+
+        connect_chart_cache_signals()
+
+        # Time the queries of instrumented requests (ServerTimingMiddleware)
+        from django.conf import settings
+
+        if getattr(settings, 'PERFORMANCE_INSTRUMENTATION', True):
+            from core.utils.timing import connect_query_timer
+
+            connect_query_timer()
+
+        # Load generated protobuf modules now rather than on first use
+        from core.proto_utils import register_proto_modules
+
+        register_proto_modules()
@@ -0,0 +1,241 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""
+Deduplicated background jobs backed by the database.
+
+Signals and views call ``enqueue_job(name, *keys)`` instead of doing heavy
+work inline. Each (name, key) pair is stored at most once while pending, in
+the same transaction as the change that requested it, and a worker
+(``manage.py run_jobs``) later claims due jobs and hands all the keys of one
+job name to its handler in a single call, so a burst of saves to one
+mechanism costs one recount.
+
+Handlers are registered with ``@register_job(name)`` and take the list of
+keys to process. With ``settings.BACKGROUND_JOBS_EAGER`` (the default
+under DEBUG, and set by the test suite's conftest.py, so those need no
+worker) handlers run immediately instead; otherwise jobs wait for the
+worker.
+
+``@register_job(name, every=timedelta(...))`` also makes the worker run the
+job periodically: one row with an empty key is kept for it and moved to
+its next run time after each success.
+"""
+
+import logging
+from datetime import timedelta
+from typing import Callable, Dict, Iterable, List, Optional
+
+from django.conf import settings
+from django.db import IntegrityError, connection, transaction
+from django.utils import timezone
+
+logger = logging.getLogger(__name__)
+
+JobHandler = Callable[[List[str]], None]
+
+MAX_ATTEMPTS = 5
+RETRY_DELAY = timedelta(seconds=30)
+
+_handlers: Dict[str, JobHandler] = {}
+_intervals: Dict[str, timedelta] = {}
+
+
+def register_job(
+    name: str, every: Optional[timedelta] = None
+) -> Callable[[JobHandler], JobHandler]:
+    """
+    Register ``handler(keys)`` as the handler of jobs called ``name``.
+
+    Args:
+        name: The job name passed to enqueue_job()
+        every: Also run the job (with an empty key) at this interval
+    """
+
+    def decorator(handler: JobHandler) -> JobHandler:
+        _handlers[name] = handler
+        if every is not None:
+            _intervals[name] = every
+        return handler
+
+    return decorator
+
+
+def schedule_periodic_jobs() -> int:
+    """
+    Make sure every periodic job has its row; called by the worker.
+
+    Returns:
+        int: The number of periodic jobs newly scheduled
+    """
+    from core.models import BackgroundJob
+
+    existing = set(
+        BackgroundJob.objects.filter(name__in=list(_intervals), key='')
+        .exclude(status=BackgroundJob.STATUS_FAILED)
+        .values_list('name', flat=True)
+    )
+    missing = [name for name in _intervals if name not in existing]
+    BackgroundJob.objects.bulk_create(
+        [BackgroundJob(name=name, key='') for name in missing],
+        ignore_conflicts=True,
+    )
+    return len(missing)
+
+
+def _requeue_job(job, **fields) -> bool:
+    """
+    Return a claimed job to pending, or merge it into a pending duplicate.
+
+    Only one pending row may exist per name and key, so the update fails if
+    the same work was queued meanwhile; that row covers this one, which is
+    deleted instead. Looking for the duplicate first would race enqueue_job().
+
+    Returns:
+        bool: True if the job was requeued, False if it was merged
+    """
+    from core.models import BackgroundJob
+
+    try:
+        with transaction.atomic():
+            BackgroundJob.objects.filter(pk=job.pk).update(
+                status=BackgroundJob.STATUS_PENDING, **fields
+            )
+    except IntegrityError:
+        BackgroundJob.objects.filter(pk=job.pk).delete()
+        return False
+    return True
+
+
+def _finish_jobs(name: str, jobs: list) -> None:
+    """Delete finished jobs, moving a periodic job's row to its next run."""
+    from core.models import BackgroundJob
+
+    interval = _intervals.get(name)
+    periodic = [job for job in jobs if interval is not None and job.key == '']
+    BackgroundJob.objects.filter(
+        pk__in=[job.pk for job in jobs if job not in periodic]
+    ).delete()
+    for job in periodic:
+        # A run requested meanwhile is covered by the next scheduled one
+        BackgroundJob.objects.filter(
+            name=name, key='', status=BackgroundJob.STATUS_PENDING
+        ).delete()
+        _requeue_job(
+            job, run_after=timezone.now() + interval, attempts=0, last_error=''
+        )
+
+
+def jobs_run_eagerly() -> bool:
+    """Whether enqueue_job() runs handlers inline (settings.BACKGROUND_JOBS_EAGER)."""
+    return getattr(settings, 'BACKGROUND_JOBS_EAGER', False)
+
+
+def enqueue_job(name: str, *keys: object) -> None:
+    """
+    Request that job ``name`` runs for each of ``keys``.
+
+    Keys already pending for the same job are not queued twice. Falsy keys
+    are ignored; call with no keys for a job that takes none.
+    """
+    if name not in _handlers:
+        raise KeyError(f'Unknown background job: {name}')
+    key_list = sorted({str(key) for key in keys if key}) if keys else ['']
+    if not key_list:
+        return
+
+    if jobs_run_eagerly():
+        _handlers[name](key_list)
+        return
+
+    from core.models import BackgroundJob
+
+    BackgroundJob.objects.bulk_create(
+        [BackgroundJob(name=name, key=key) for key in key_list],
+        ignore_conflicts=True,
+    )
+
+
+def _claim_jobs(limit: int) -> list:
+    """Mark up to ``limit`` due jobs as running and return them."""
+    from core.models import BackgroundJob
+    from django.db.models import F
+
+    now = timezone.now()
+    with transaction.atomic():
+        due = BackgroundJob.objects.filter(
+            status=BackgroundJob.STATUS_PENDING, run_after__lte=now
+        ).order_by('id')
+        if connection.features.has_select_for_update_skip_locked:
+            # Concurrent workers each take different rows
+            due = due.select_for_update(skip_locked=True)
+        jobs = list(due[:limit])
+        BackgroundJob.objects.filter(pk__in=[job.pk for job in jobs]).update(
+            status=BackgroundJob.STATUS_RUNNING,
+            started_at=now,
+            attempts=F('attempts') + 1,
+        )
+    return jobs
+
+
+def _fail_jobs(jobs: Iterable, error: Exception) -> None:
+    """Schedule failed jobs for a retry, or park them after MAX_ATTEMPTS."""
+    from core.models import BackgroundJob
+
+    for job in jobs:
+        attempts = job.attempts + 1
+        run_after = timezone.now() + RETRY_DELAY * attempts
+        if attempts < MAX_ATTEMPTS:
+            # Merged if newer work for the same key is already queued
+            _requeue_job(job, run_after=run_after, last_error=str(error))
+            continue
+        BackgroundJob.objects.filter(pk=job.pk).update(
+            status=BackgroundJob.STATUS_FAILED,
+            run_after=run_after,
+            last_error=str(error),
+        )
+
+
+def run_pending_jobs(limit: int = 500) -> int:
+    """
+    Claim due jobs and run them, one handler call per job name.
+
+    Returns:
+        int: The number of jobs claimed
+    """
+    from core.models import BackgroundJob
+
+    jobs = _claim_jobs(limit)
+    by_name: Dict[str, list] = {}
+    for job in jobs:
+        by_name.setdefault(job.name, []).append(job)
+
+    for name, named_jobs in by_name.items():
+        handler = _handlers.get(name)
+        try:
+            if handler is None:
+                raise KeyError(f'Unknown background job: {name}')
+            with transaction.atomic():
+                handler([job.key for job in named_jobs])
+        except Exception as e:  # pylint: disable=broad-except
+            logger.exception('Background job %s failed', name)
+            _fail_jobs(named_jobs, e)
+        else:
+            _finish_jobs(name, named_jobs)
+            logger.debug('Ran background job %s for %d keys', name, len(named_jobs))
+    return len(jobs)
+
+
+def requeue_stale_jobs(older_than: timedelta = timedelta(minutes=30)) -> int:
+    """Return jobs left running by a crashed worker to the queue."""
+    from core.models import BackgroundJob
+
+    stale = BackgroundJob.objects.filter(
+        status=BackgroundJob.STATUS_RUNNING,
+        started_at__lt=timezone.now() - older_than,
+    )
+    requeued = 0
+    for job in stale:
+        _requeue_job(job)
+        requeued += 1
+    return requeued
@@ -0,0 +1,53 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""
+Management command to report shared cache hit/miss counters.
+"""
+
+from core.utils.cache import CACHE_STATS_BUCKETS, get_cache_stats, reset_cache_stats
+from django.conf import settings
+from django.core.management.base import BaseCommand
+
+
+class Command(BaseCommand):
+    help = 'Show cache hit/miss counters per bucket, to help size the cache'
+
+    def add_arguments(self, parser):
+        parser.add_argument(
+            '--bucket',
+            action='append',
+            dest='buckets',
+            help=(
+                'Bucket to report (repeatable). '
+                f'Default: {", ".join(CACHE_STATS_BUCKETS)}'
+            )
+        )
+        parser.add_argument(
+            '--reset',
+            action='store_true',
+            help='Zero the counters after reporting them'
+        )
+
+    def handle(self, *args, **options):
+        backend = settings.CACHES['default']['BACKEND']
+        self.stdout.write(f'Cache backend: {backend}')
+        if 'locmem' in backend:
+            self.stdout.write(self.style.WARNING(
+                'LocMemCache is per process: these counters only cover '
+                'this command, not the running workers'
+            ))
+        if not getattr(settings, 'CACHE_STATS_ENABLED', False):
+            self.stdout.write(self.style.WARNING('CACHE_STATS_ENABLED is off'))
+
+        for bucket, stats in get_cache_stats(options['buckets']).items():
+            ratio = stats['hit_ratio']
+            ratio_text = f'{ratio:.1%}' if ratio is not None else 'n/a'
+            self.stdout.write(
+                f'{bucket:<12} hits={stats["hits"]:<8} '
+                f'misses={stats["misses"]:<8} hit ratio={ratio_text}'
+            )
+
+        if options['reset']:
+            reset_cache_stats(options['buckets'])
+            self.stdout.write(self.style.SUCCESS('Counters reset'))
@@ -19,9 +19,10 @@
     TimeoutExpired,
 )
 
+from core.proto_utils import FAST_PROTOBUF_BACKENDS, protobuf_backend
 from django.apps import apps
 from django.conf import settings
-from django.core.management.base import BaseCommand
+from django.core.management.base import BaseCommand, CommandError
 
 logger = logging.getLogger(__name__)
 
@@ -40,11 +41,22 @@ def add_arguments(self, parser):
             type=str,
             help='Compile protobuf files for specific app'
         )
+        parser.add_argument(
+            '--check',
+            action='store_true',
+            help=(
+                'Compile nothing; fail if a generated module is missing or '
+                'older than its .proto file, or if protobuf is running on the '
+                'pure-Python runtime'
+            )
+        )
 
     def handle(self, *args, **options):
         """Compile protobuf definitions to Python classes."""
         app_name = options.get('app')
         force = options.get('force', False)
+        self.check_only = options.get('check', False)
+        self.problems = []
 
         # Process all apps if no specific app is provided
         if app_name:
@@ -67,12 +79,31 @@ def handle(self, *args, **options):
                     continue
                 self.process_app(app_config, force)
 
+        if self.check_only:
+            self._check_backend()
+            if self.problems:
+                raise CommandError(
+                    "Protocol buffer check failed:\n" + "\n".join(self.problems)
+                )
+            self.stdout.write(self.style.SUCCESS("Protocol buffer modules are current"))
+            return
+
         self.stdout.write(
             self.style.SUCCESS(
                 "Protocol buffer compilation completed successfully"
             )
         )
 
+    def _check_backend(self):
+        """Record a problem unless protobuf runs on a compiled runtime."""
+        backend = protobuf_backend()
+        self.stdout.write(f"Protobuf runtime: {backend}")
+        if backend not in FAST_PROTOBUF_BACKENDS:
+            self.problems.append(
+                f"protobuf is using the '{backend}' runtime; install a protobuf "
+                "wheel with the upb extension"
+            )
+
     def process_app(self, app_config, force=False):
         """Process protocol buffer files for a single app."""
         app_dir = app_config.path
@@ -98,13 +129,20 @@ def process_app(self, app_config, force=False):
                 continue
 
             proto_files_found = True
+            if self.check_only:
+                for proto_file in proto_files:
+                    self._check_proto_file(proto_dir, proto_file)
+                continue
+
             protoc_path = self._get_protoc_path()
             if not protoc_path:
                 return
 
+            # Generated modules sit next to their .proto files, inside the
+            # package the apps import them from
             paths = {
                 "proto_dir": proto_dir,
-                "output_dir": app_dir,
+                "output_dir": proto_dir,
                 "protoc_path": protoc_path,
             }
             self._process_proto_files(proto_files, paths, force)
@@ -114,6 +152,29 @@ def process_app(self, app_config, force=False):
                 self.style.SUCCESS(f"Finished processing {app_name} app")
             )
 
+    @staticmethod
+    def _generated_path(proto_dir, proto_file):
+        base_name = os.path.splitext(proto_file)[0]
+        return os.path.join(proto_dir, f"{base_name}_pb2.py")
+
+    @staticmethod
+    def _is_stale(proto_path, generated_path):
+        return (
+            not os.path.exists(generated_path)
+            or os.path.getmtime(generated_path) < os.path.getmtime(proto_path)
+        )
+
+    def _check_proto_file(self, proto_dir, proto_file):
+        """Record a problem if a .proto file's module is missing or stale."""
+        proto_path = os.path.join(proto_dir, proto_file)
+        generated_path = self._generated_path(proto_dir, proto_file)
+        if not os.path.exists(generated_path):
+            self.problems.append(f"{generated_path} is missing")
+        elif self._is_stale(proto_path, generated_path):
+            self.problems.append(f"{generated_path} is older than {proto_file}")
+        else:
+            self.stdout.write(f"{proto_file} is compiled")
+
     def _get_protoc_path(self):
         """Get the absolute path to the protoc executable."""
         protoc_path = shutil.which('protoc')
@@ -158,13 +219,10 @@ def _compile_proto_file(self, proto_file, paths, force):
         """Compile a single proto file securely."""
         try:
             proto_path = os.path.join(paths["proto_dir"], proto_file)
-            base_name = os.path.splitext(proto_file)[0]
-            expected_output = os.path.join(
-                paths["output_dir"], f"{base_name}_pb2.py"
-            )
+            expected_output = self._generated_path(paths["output_dir"], proto_file)
 
-            # Skip if output file exists and force is not set
-            if os.path.exists(expected_output) and not force:
+            # Skip if the output is up to date and force is not set
+            if not force and not self._is_stale(proto_path, expected_output):
                 self.stdout.write(f"Skipping {proto_file} (already compiled)")
                 return
 
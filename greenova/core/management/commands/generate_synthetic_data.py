@@ -0,0 +1,285 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""
+Management command generating a synthetic multi-tenant dataset.
+
+Creates companies, their users and projects, project and company
+memberships, mechanisms and obligations, with bulk inserts. Obligation
+text, procedures and aspects are drawn from a source CSV (dummy_data.csv by
+default); statuses and due dates follow the distributions below. A JSON
+manifest of users, projects, mechanisms and obligations can be written for
+the load-test scenarios in loadtests/.
+"""
+
+import csv
+import json
+import random
+from datetime import date, timedelta
+from pathlib import Path
+from typing import Any, Dict, List
+
+from chatbot.models import Conversation
+from company.models import Company, CompanyMembership
+from django.conf import settings
+from django.contrib.auth import get_user_model
+from django.contrib.auth.hashers import make_password
+from django.core.management.base import BaseCommand, CommandError
+from django.db import transaction
+from django.utils import timezone
+from mechanisms.models import EnvironmentalMechanism, update_mechanism_counts
+from obligations.constants import (
+    STATUS_COMPLETED,
+    STATUS_IN_PROGRESS,
+    STATUS_NOT_STARTED,
+)
+from obligations.models import (
+    OBLIGATION_NUMBER_PREFIX,
+    Obligation,
+    ObligationNumberSequence,
+    format_obligation_number,
+)
+from obligations.search import index_obligations
+from projects.models import Project, ProjectMembership
+from users.models import Profile
+
+User = get_user_model()
+
+# Share of obligations in each status
+STATUS_WEIGHTS = {
+    STATUS_NOT_STARTED: 0.45,
+    STATUS_IN_PROGRESS: 0.30,
+    STATUS_COMPLETED: 0.25,
+}
+# (share, first day, last day) of due dates relative to today for open
+# obligations: some overdue, most due within the next quarter
+OPEN_DUE_WINDOWS = ((0.15, -90, -1), (0.55, 0, 90), (0.30, 91, 365))
+RECURRING_SHARE = 0.2
+RECURRING_FREQUENCIES = ('weekly', 'monthly', 'quarterly', 'annually')
+# Obligations kept per user in the manifest for the load-test scenarios
+MANIFEST_OBLIGATIONS = 20
+BATCH_SIZE = 1000
+
+
+class Command(BaseCommand):
+    help = 'Generate synthetic companies, projects, users and obligations'
+
+    def add_arguments(self, parser):
+        parser.add_argument(
+            '--companies', type=int, default=5, help='Companies (default: 5)'
+        )
+        parser.add_argument(
+            '--projects-per-company',
+            type=int,
+            default=4,
+            help='Projects per company (default: 4)'
+        )
+        parser.add_argument(
+            '--users-per-company',
+            type=int,
+            default=10,
+            help='Users per company, members of all its projects (default: 10)'
+        )
+        parser.add_argument(
+            '--mechanisms-per-project',
+            type=int,
+            default=5,
+            help='Mechanisms per project (default: 5)'
+        )
+        parser.add_argument(
+            '--obligations-per-mechanism',
+            type=int,
+            default=100,
+            help='Obligations per mechanism (default: 100)'
+        )
+        parser.add_argument(
+            '--prefix',
+            default='Synthetic',
+            help='Prefix of generated company, project and user names'
+        )
+        parser.add_argument(
+            '--password',
+            default='loadtest',
+            help='Password of every generated user (default: loadtest)'
+        )
+        parser.add_argument(
+            '--source',
+            default=str(Path(settings.BASE_DIR) / 'dummy_data.csv'),
+            help='CSV the obligation texts are drawn from'
+        )
+        parser.add_argument(
+            '--seed', type=int, default=0, help='Random seed (default: 0)'
+        )
+        parser.add_argument(
+            '--manifest',
+            help='Write users, projects and obligations to this JSON file'
+        )
+
+    def handle(self, *args, **options):
+        self.random = random.Random(options['seed'])
+        self.today = timezone.now().date()
+        self.source_rows = self._load_source(options['source'])
+        prefix = options['prefix']
+        if Company.objects.filter(name__startswith=f'{prefix} Company ').exists():
+            raise CommandError(
+                f'Synthetic data with prefix "{prefix}" already exists; '
+                'pass another --prefix'
+            )
+
+        password = make_password(options['password'])
+        manifest: Dict[str, Any] = {'password': options['password'], 'users': []}
+        totals = {'projects': 0, 'users': 0, 'mechanisms': 0, 'obligations': 0}
+
+        for company_index in range(options['companies']):
+            with transaction.atomic():
+                users, projects, mechanisms, numbers = self._generate_company(
+                    prefix, company_index, password, options
+                )
+            totals['users'] += len(users)
+            totals['projects'] += len(projects)
+            totals['mechanisms'] += len(mechanisms)
+            totals['obligations'] += len(numbers)
+            manifest['users'].extend(
+                self._manifest_users(users, projects, mechanisms, numbers)
+            )
+
+        if options['manifest']:
+            with open(options['manifest'], 'w', encoding='utf-8') as manifest_file:
+                json.dump(manifest, manifest_file, indent=2)
+            self.stdout.write(f"Wrote manifest to {options['manifest']}")
+
+        self.stdout.write(
+            self.style.SUCCESS(
+                f"Generated {options['companies']} companies, "
+                f"{totals['projects']} projects, {totals['users']} users, "
+                f"{totals['mechanisms']} mechanisms and "
+                f"{totals['obligations']} obligations"
+            )
+        )
+
+    def _load_source(self, path: str) -> List[Dict[str, str]]:
+        try:
+            with open(path, encoding='utf-8', newline='') as source:
+                rows = [row for row in csv.DictReader(source) if row.get('obligation')]
+        except OSError as e:
+            raise CommandError(f'Cannot read source CSV {path}: {e}') from e
+        if not rows:
+            raise CommandError(f'Source CSV {path} has no obligations')
+        return rows
+
+    def _generate_company(self, prefix, company_index, password, options):
+        company = Company.objects.create(name=f'{prefix} Company {company_index}')
+        users = User.objects.bulk_create(
+            User(
+                username=f'{prefix.lower()}-{company_index}-{user_index}',
+                email=f'{prefix.lower()}-{company_index}-{user_index}@example.com',
+                password=password,
+            )
+            for user_index in range(options['users_per_company'])
+        )
+        # bulk_create skips the post_save receiver that creates profiles
+        Profile.objects.bulk_create(Profile(user=user) for user in users)
+        company.users.add(*users)
+        CompanyMembership.objects.bulk_create(
+            CompanyMembership(
+                company=company,
+                user=user,
+                role='owner' if index == 0 else 'member',
+                is_primary=True,
+            )
+            for index, user in enumerate(users)
+        )
+        Conversation.objects.bulk_create(
+            Conversation(user=user, title='Load test') for user in users
+        )
+
+        projects = Project.objects.bulk_create(
+            Project(name=f'{prefix} Project {company_index}-{project_index}')
+            for project_index in range(options['projects_per_company'])
+        )
+        ProjectMembership.objects.bulk_create(
+            ProjectMembership(user=user, project=project)
+            for project in projects
+            for user in users
+        )
+        mechanisms = EnvironmentalMechanism.objects.bulk_create(
+            EnvironmentalMechanism(
+                name=f'{project.name} Mechanism {mechanism_index}', project=project
+            )
+            for project in projects
+            for mechanism_index in range(options['mechanisms_per_project'])
+        )
+
+        count = len(mechanisms) * options['obligations_per_mechanism']
+        numbers: List[str] = []
+        if count:
+            first = ObligationNumberSequence.reserve(OBLIGATION_NUMBER_PREFIX, count)
+            obligations = (
+                self._obligation(
+                    format_obligation_number(first + index),
+                    mechanisms[index % len(mechanisms)],
+                )
+                for index in range(count)
+            )
+            for obligation in Obligation.objects.bulk_create(
+                obligations, batch_size=BATCH_SIZE
+            ):
+                numbers.append(obligation.obligation_number)
+            update_mechanism_counts([mechanism.id for mechanism in mechanisms])
+            for start in range(0, len(numbers), BATCH_SIZE):
+                index_obligations(numbers[start:start + BATCH_SIZE])
+        return users, projects, mechanisms, numbers
+
+    def _obligation(self, number: str, mechanism) -> Obligation:
+        row = self.random.choice(self.source_rows)
+        status = self.random.choices(
+            list(STATUS_WEIGHTS), weights=list(STATUS_WEIGHTS.values())
+        )[0]
+        recurring = self.random.random() < RECURRING_SHARE
+        due = self._due_date(status)
+        return Obligation(
+            obligation_number=number,
+            obligation=row['obligation'],
+            project_id=mechanism.project_id,
+            primary_environmental_mechanism=mechanism,
+            procedure=row.get('procedure', ''),
+            environmental_aspect=(row.get('environmental__aspect') or '')[:255],
+            accountability=(row.get('accountability') or '')[:255],
+            responsibility=(row.get('responsibility') or '')[:255],
+            project_phase=(row.get('project_phase') or '')[:255],
+            status=status,
+            action_due_date=due,
+            close_out_date=due if status == STATUS_COMPLETED else None,
+            recurring_obligation=recurring,
+            recurring_frequency=(
+                self.random.choice(RECURRING_FREQUENCIES) if recurring else ''
+            ),
+        )
+
+    def _due_date(self, status: str) -> date:
+        if status == STATUS_COMPLETED:
+            return self.today - timedelta(days=self.random.randint(1, 365))
+        shares = [window[0] for window in OPEN_DUE_WINDOWS]
+        _, first, last = self.random.choices(OPEN_DUE_WINDOWS, weights=shares)[0]
+        return self.today + timedelta(days=self.random.randint(first, last))
+
+    def _manifest_users(self, users, projects, mechanisms, numbers):
+        conversations = dict(
+            Conversation.objects.filter(user__in=users).values_list('user_id', 'id')
+        )
+        mechanisms_by_project: Dict[str, List[int]] = {}
+        for mechanism in mechanisms:
+            mechanisms_by_project.setdefault(str(mechanism.project_id), []).append(
+                mechanism.id
+            )
+        sample = self.random.sample(numbers, min(len(numbers), MANIFEST_OBLIGATIONS))
+        return [
+            {
+                'username': user.username,
+                'projects': [project.id for project in projects],
+                'mechanisms': mechanisms_by_project,
+                'obligations': sample,
+                'conversation_id': conversations.get(user.id),
+            }
+            for user in users
+        ]
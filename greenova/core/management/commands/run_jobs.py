@@ -0,0 +1,53 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""
+Management command running the background job worker.
+"""
+
+import time
+
+from core.jobs import requeue_stale_jobs, run_pending_jobs, schedule_periodic_jobs
+from django.core.management.base import BaseCommand
+
+
+class Command(BaseCommand):
+    help = 'Run queued background jobs (mechanism recounts, chart refreshes, ...)'
+
+    def add_arguments(self, parser):
+        parser.add_argument(
+            '--once',
+            action='store_true',
+            help='Run the jobs that are due now and exit'
+        )
+        parser.add_argument(
+            '--limit',
+            type=int,
+            default=500,
+            help='Maximum jobs claimed per batch (default: 500)'
+        )
+        parser.add_argument(
+            '--sleep',
+            type=float,
+            default=2.0,
+            help='Seconds to wait when the queue is empty (default: 2)'
+        )
+
+    def handle(self, *args, **options):
+        requeued = requeue_stale_jobs()
+        if requeued:
+            self.stdout.write(f'Requeued {requeued} stale jobs')
+
+        total = 0
+        while True:
+            schedule_periodic_jobs()
+            claimed = run_pending_jobs(limit=options['limit'])
+            total += claimed
+            if options['once']:
+                if not claimed:
+                    break
+                continue
+            if not claimed:
+                time.sleep(options['sleep'])
+
+        self.stdout.write(self.style.SUCCESS(f'Ran {total} background jobs'))
@@ -2,27 +2,159 @@
 # SPDX-License-Identifier: 	AGPL-3.0-or-later
 
 import logging
+from typing import Callable, Optional
 
-from django.http import HttpRequest
+from asgiref.sync import iscoroutinefunction, markcoroutinefunction
+from core.utils.timing import (
+    RequestTimings,
+    log_slow_request,
+    prometheus_metrics,
+    request_timings,
+)
+from django.conf import settings
+from django.core.exceptions import MiddlewareNotUsed
+from django.http import HttpRequest, HttpResponse
 from django.utils.deprecation import MiddlewareMixin
+from projects.models import get_project_roles
 
 logger = logging.getLogger(__name__)
 
+SELECTED_PROJECT_SESSION_KEY = 'selected_project_id'
+
+
+def requested_project_id(request: HttpRequest) -> Optional[str]:
+    """Return the last non-empty ``project_id`` in the query string."""
+    project_ids = request.GET.getlist('project_id')
+    return next((pid for pid in reversed(project_ids) if pid), None)
+
+
+def can_select_project(request: HttpRequest, project_id: str) -> bool:
+    """
+    Check the user may select ``project_id``.
+
+    Members may select their projects (checked against the roles map);
+    staff and superusers may select any project.
+    """
+    if not str(project_id).isdigit():
+        return False
+    user = request.user
+    if getattr(user, 'is_superuser', False) or getattr(user, 'is_staff', False):
+        return True
+    return int(project_id) in get_project_roles(user)
+
 
 class ProjectSelectionMiddleware(MiddlewareMixin):
     """
     Middleware to manage selected_project_id in session and request.
     Ensures project selection is consistent for all views, including HTMX.
+
+    The selection is resolved once per request into
+    ``request.selected_project_id``. A ``project_id`` from the query string
+    is only stored if the user may select that project (see
+    can_select_project()), and a stored selection is checked again on every
+    request, so it is dropped once the user leaves the project. The session
+    is only written when the stored value changes, so requests that keep
+    the same selection do not save the session. Dashboard views treat the
+    query string as authoritative: no ``project_id`` clears the selection.
     """
 
     def process_request(self, request: HttpRequest):
-        project_ids = request.GET.getlist("project_id")
-        project_id = next((pid for pid in reversed(project_ids) if pid), None)
-        if project_id:
-            request.session["selected_project_id"] = project_id
-            request.selected_project_id = project_id
-            logger.debug("ProjectSelectionMiddleware: Set project_id %s", project_id)
-        elif "selected_project_id" in request.session:
-            request.selected_project_id = request.session["selected_project_id"]
-        else:
+        stored = request.session.get(SELECTED_PROJECT_SESSION_KEY)
+        project_id = requested_project_id(request)
+        if project_id and project_id != stored:
+            if can_select_project(request, project_id):
+                request.session[SELECTED_PROJECT_SESSION_KEY] = project_id
+                request.selected_project_id = project_id
+                logger.debug('ProjectSelectionMiddleware: Set project_id %s', project_id)
+                return
+            logger.debug(
+                'ProjectSelectionMiddleware: Ignored project_id %s', project_id
+            )
+        if stored is not None and not can_select_project(request, stored):
+            # Removed from the project since selecting it
+            del request.session[SELECTED_PROJECT_SESSION_KEY]
+            stored = None
+            logger.debug('ProjectSelectionMiddleware: Dropped stored project_id')
+        request.selected_project_id = stored
+
+    def process_view(self, request: HttpRequest, view_func, view_args, view_kwargs):
+        # The URL is already resolved by now; no need to resolve it again
+        match = request.resolver_match
+        if (
+            match is not None
+            and match.app_name == 'dashboard'
+            and not requested_project_id(request)
+            and request.selected_project_id is not None
+        ):
+            del request.session[SELECTED_PROJECT_SESSION_KEY]
             request.selected_project_id = None
+            logger.debug('ProjectSelectionMiddleware: Cleared project selection')
+
+
+class ServerTimingMiddleware:
+    """
+    Measure each request and report where its time went.
+
+    Queries, template and chart rendering and cache lookups are counted by
+    ``core.utils.timing`` while the request runs. The totals are sent in a
+    ``Server-Timing`` header (settings.SERVER_TIMING_HEADER, or always for
+    staff users), observed as Prometheus metrics labelled by view name when
+    ``prometheus_client`` is installed, and logged with the slowest queries
+    when the request took longer than settings.PERFORMANCE_SLOW_REQUEST_MS.
+    Streaming bodies are produced after the response leaves this middleware
+    and are not included. Set settings.PERFORMANCE_INSTRUMENTATION to False
+    to remove the middleware altogether.
+
+    Under ASGI the middleware runs in async mode, so async views are not
+    pushed into the sync thread on its account.
+    """
+
+    sync_capable = True
+    async_capable = True
+
+    def __init__(self, get_response: Callable[[HttpRequest], HttpResponse]) -> None:
+        if not getattr(settings, 'PERFORMANCE_INSTRUMENTATION', True):
+            raise MiddlewareNotUsed
+        self.get_response = get_response
+        self.async_mode = iscoroutinefunction(get_response)
+        if self.async_mode:
+            markcoroutinefunction(self)
+        self.slow_ms = getattr(settings, 'PERFORMANCE_SLOW_REQUEST_MS', 1000)
+        self.header_enabled = getattr(settings, 'SERVER_TIMING_HEADER', settings.DEBUG)
+
+    def __call__(self, request: HttpRequest) -> HttpResponse:
+        if self.async_mode:
+            return self.__acall__(request)
+        with request_timings() as timings:
+            response = self.get_response(request)
+        return self.report(request, response, timings, getattr(request, 'user', None))
+
+    async def __acall__(self, request: HttpRequest) -> HttpResponse:
+        with request_timings() as timings:
+            response = await self.get_response(request)
+        user = None
+        if not self.header_enabled and hasattr(request, 'auser'):
+            # Cached by LogoutStateMiddleware; request.user may be unloaded
+            user = await request.auser()
+        return self.report(request, response, timings, user)
+
+    def report(
+        self,
+        request: HttpRequest,
+        response: HttpResponse,
+        timings: RequestTimings,
+        user: Optional[object],
+    ) -> HttpResponse:
+        """Add the header, observe the metrics and log the request if slow."""
+        if self.header_enabled or getattr(user, 'is_staff', False):
+            response['Server-Timing'] = timings.server_timing()
+
+        metrics = prometheus_metrics()
+        if metrics is not None:
+            match = request.resolver_match
+            view = match.view_name if match is not None else 'unresolved'
+            metrics.observe(timings, view, request.method, response.status_code)
+
+        if self.slow_ms and timings.total_ms >= self.slow_ms:
+            log_slow_request(timings, request.method, request.path)
+        return response
@@ -0,0 +1,60 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""
+Models for the core app.
+"""
+
+from typing import Any
+
+from django.db import models
+from django.db.models import Q
+from django.utils import timezone
+
+
+class BackgroundJob(models.Model):
+    """
+    One unit of deferred work, executed by ``manage.py run_jobs``.
+
+    A job is identified by its ``name`` (the registered handler) and a
+    ``key`` such as a mechanism or project id. At most one pending job
+    exists per name and key, so repeated requests for the same work
+    collapse into a single row until a worker picks it up.
+    """
+
+    STATUS_PENDING = 'pending'
+    STATUS_RUNNING = 'running'
+    STATUS_FAILED = 'failed'
+    STATUS_CHOICES = [
+        (STATUS_PENDING, 'Pending'),
+        (STATUS_RUNNING, 'Running'),
+        (STATUS_FAILED, 'Failed'),
+    ]
+
+    name: Any = models.CharField(max_length=100)
+    key: Any = models.CharField(max_length=100, blank=True, default='')
+    status: Any = models.CharField(
+        max_length=10, choices=STATUS_CHOICES, default=STATUS_PENDING
+    )
+    attempts: Any = models.PositiveSmallIntegerField(default=0)
+    last_error: Any = models.TextField(blank=True)
+    run_after: Any = models.DateTimeField(default=timezone.now)
+    created_at: Any = models.DateTimeField(auto_now_add=True)
+    started_at: Any = models.DateTimeField(null=True, blank=True)
+
+    class Meta:
+        verbose_name = 'Background Job'
+        verbose_name_plural = 'Background Jobs'
+        constraints = [
+            models.UniqueConstraint(
+                fields=['name', 'key'],
+                condition=Q(status='pending'),
+                name='backgroundjob_unique_pending',
+            ),
+        ]
+        indexes = [
+            models.Index(fields=['status', 'run_after'], name='backgroundjob_due'),
+        ]
+
+    def __str__(self) -> str:
+        return f'{self.name}[{self.key}] ({self.status})'
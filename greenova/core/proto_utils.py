@@ -6,17 +6,24 @@
 
 This module provides common functionality for Protocol Buffer operations
 across all apps in the Greenova project.
+
+Every app's generated ``proto/*_pb2.py`` modules are imported once at
+startup (``CoreConfig.ready``), so message types are resolved from an
+in-memory map. Batches are written in the standard length-delimited
+format (each message preceded by its varint-encoded size), which can be
+produced and consumed one message at a time.
 """
 
 import importlib
 import logging
 import os
-from typing import Dict, List, Optional, Type
+from typing import IO, Dict, Iterable, Iterator, List, Optional, Type, TypeVar
 
 from django.apps import apps
 from django.conf import settings
 from google.protobuf import message as proto_message
 from google.protobuf import symbol_database as _symbol_database
+from google.protobuf.internal import api_implementation
 
 logger = logging.getLogger(__name__)
 
@@ -26,14 +33,32 @@
 # Cache for loaded message types
 _message_type_cache: Dict[str, Type[proto_message.Message]] = {}
 
+# Runtimes backed by compiled code; 'python' is the slow pure-Python one
+FAST_PROTOBUF_BACKENDS = ('upb', 'cpp')
+PROTO_PACKAGE = 'proto'
+
+# Largest message accepted by read_delimited()
+MAX_DELIMITED_MESSAGE_SIZE = 64 * 1024 * 1024
+
+MessageT = TypeVar('MessageT', bound=proto_message.Message)
+
+
+def protobuf_backend() -> str:
+    """Return the active protobuf runtime: 'upb', 'cpp' or 'python'."""
+    return api_implementation.Type()
+
+
+def has_fast_protobuf_backend() -> bool:
+    """Check protobuf is running on a compiled (upb or C++) runtime."""
+    return protobuf_backend() in FAST_PROTOBUF_BACKENDS
+
 
 def get_proto_message_type(full_name: str) -> Optional[Type[proto_message.Message]]:
     """
     Get a Protocol Buffer message type by its fully qualified name.
 
-    This function checks the cache first, then falls back to the symbol database.
-    If the message type isn't found, it attempts to load appropriate modules
-    that might contain the message definition.
+    Message types are registered at startup by register_proto_modules();
+    this function checks that map, then the symbol database.
 
     Args:
         full_name: Fully qualified name of the message (e.g., 'feedback.BugReportProto')
@@ -45,64 +70,140 @@ def get_proto_message_type(full_name: str) -> Optional[Type[proto_message.Messag
     if full_name in _message_type_cache:
         return _message_type_cache[full_name]
 
-    # Try to get from symbol database
     try:
         message_type = _sym_db.GetSymbol(full_name)
-        _message_type_cache[full_name] = message_type
-        return message_type
     except KeyError:
-        # Message type not found, attempt to import relevant modules
-        namespace = full_name.split('.')[0]
-
-        # Try to find and import the relevant *_pb2.py files
-        for app_config in apps.get_app_configs():
-            if app_config.name == namespace or namespace in app_config.name:
-                app_path = app_config.path
-                pb2_files = _find_pb2_files(app_path)
-
-                for pb2_file in pb2_files:
-                    module_name = _get_module_name(pb2_file)
-                    try:
-                        importlib.import_module(module_name)
-                    except ImportError as e:
-                        logger.warning("Failed to import %s: %s", module_name, e)
-
-        # Try again after importing modules
+        logger.error("Could not find Protocol Buffer message type: %s", full_name)
+        return None
+    _message_type_cache[full_name] = message_type
+    return message_type
+
+
+def find_proto_modules() -> List[str]:
+    """Return the module names of every local app's generated *_pb2 files."""
+    base_dir = str(settings.BASE_DIR)
+    module_names = []
+    for app_config in apps.get_app_configs():
+        if not str(app_config.path).startswith(base_dir):
+            continue
+        proto_dir = os.path.join(app_config.path, PROTO_PACKAGE)
+        if not os.path.isdir(proto_dir):
+            continue
+        module_names.extend(
+            f'{app_config.name}.{PROTO_PACKAGE}.{file[:-3]}'
+            for file in sorted(os.listdir(proto_dir))
+            if file.endswith('_pb2.py')
+        )
+    return module_names
+
+
+def register_proto_modules() -> Dict[str, Type[proto_message.Message]]:
+    """
+    Import every generated module and register its message types.
+
+    Called once from ``CoreConfig.ready`` so no request pays for imports.
+
+    Returns:
+        dict: The registered message types keyed by full name
+    """
+    for module_name in find_proto_modules():
         try:
-            message_type = _sym_db.GetSymbol(full_name)
-            _message_type_cache[full_name] = message_type
-            return message_type
-        except KeyError:
-            logger.error("Could not find Protocol Buffer message type: %s", full_name)
+            module = importlib.import_module(module_name)
+        except ImportError as e:
+            logger.error("Failed to import %s: %s", module_name, e)
+            continue
+        pending = list(module.DESCRIPTOR.message_types_by_name.values())
+        while pending:
+            descriptor = pending.pop()
+            pending.extend(descriptor.nested_types)
+            _message_type_cache[descriptor.full_name] = _sym_db.GetSymbol(
+                descriptor.full_name
+            )
+
+    backend = protobuf_backend()
+    if backend not in FAST_PROTOBUF_BACKENDS:
+        logger.warning(
+            "Protocol buffers are using the pure-Python runtime; install a "
+            "protobuf wheel with the upb extension for faster serialization"
+        )
+    logger.debug(
+        "Registered %d protobuf message types (%s runtime)",
+        len(_message_type_cache),
+        backend,
+    )
+    return dict(_message_type_cache)
+
+
+def _encode_varint(value: int) -> bytes:
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def _read_varint(stream: IO[bytes]) -> Optional[int]:
+    """Read a varint from ``stream``; None at a clean end of stream."""
+    result = 0
+    shift = 0
+    while True:
+        byte = stream.read(1)
+        if not byte:
+            if shift:
+                raise ValueError("Truncated length prefix in delimited stream")
             return None
+        result |= (byte[0] & 0x7F) << shift
+        if not byte[0] & 0x80:
+            return result
+        shift += 7
+        if shift > 63:
+            raise ValueError("Length prefix in delimited stream is too long")
 
 
-def _find_pb2_files(directory: str) -> List[str]:
-    """Find all *_pb2.py files in a directory and its subdirectories."""
-    pb2_files = []
-    for root, _, files in os.walk(directory):
-        for file in files:
-            if file.endswith('_pb2.py'):
-                # Get the absolute path to the file
-                file_path = os.path.join(root, file)
-                pb2_files.append(file_path)
-    return pb2_files
+def encode_delimited(message: proto_message.Message) -> bytes:
+    """Serialize one message with its varint length prefix."""
+    data = message.SerializeToString()
+    return _encode_varint(len(data)) + data
 
 
-def _get_module_name(file_path: str) -> str:
+def write_delimited(
+    messages: Iterable[proto_message.Message], stream: IO[bytes]
+) -> int:
     """
-    Convert a file path to a module name.
-
-    Args:
-        file_path: The path to the file
+    Write messages to ``stream`` in length-delimited form.
 
     Returns:
-        The module name for import
+        int: The number of messages written
+    """
+    count = 0
+    for message in messages:
+        stream.write(encode_delimited(message))
+        count += 1
+    return count
+
+
+def read_delimited(
+    stream: IO[bytes], message_type: Type[MessageT]
+) -> Iterator[MessageT]:
+    """
+    Yield messages from a length-delimited stream one at a time.
+
+    Raises:
+        ValueError: If the stream is truncated or a message is oversized
     """
-    base_dir = os.path.dirname(settings.BASE_DIR)
-    relative_path = os.path.relpath(file_path, base_dir)
-    # Remove the .py extension
-    module_path = os.path.splitext(relative_path)[0]
-    # Replace directory separators with dots
-    module_name = module_path.replace(os.path.sep, '.')
-    return module_name
+    while True:
+        size = _read_varint(stream)
+        if size is None:
+            return
+        if size > MAX_DELIMITED_MESSAGE_SIZE:
+            raise ValueError(f"Delimited message of {size} bytes is too large")
+        data = stream.read(size)
+        if len(data) != size:
+            raise ValueError("Truncated message in delimited stream")
+        message = message_type()
+        message.ParseFromString(data)
+        yield message
@@ -0,0 +1,47 @@
+"""
+Template backends that time rendering for ``core.utils.timing``.
+
+Drop-in subclasses of Django's DjangoTemplates and Jinja2 backends: the
+templates they return add their render time to the 'template' span of the
+current request. Includes and extends render inside the outer template, so
+each page is counted once.
+"""
+
+from typing import Any, Optional
+
+from core.utils.timing import timed
+from django.http import HttpRequest
+from django.template.backends.django import DjangoTemplates as BaseDjangoTemplates
+from django.template.backends.jinja2 import Jinja2 as BaseJinja2
+
+
+class TimedTemplate:
+    """Wrap a backend template, timing ``render``."""
+
+    def __init__(self, template: Any) -> None:
+        self._template = template
+
+    def render(
+        self, context: Optional[Any] = None, request: Optional[HttpRequest] = None
+    ) -> str:
+        with timed('template'):
+            return self._template.render(context, request)
+
+    def __getattr__(self, name: str) -> Any:
+        return getattr(self._template, name)
+
+
+class DjangoTemplates(BaseDjangoTemplates):
+    def from_string(self, template_code: str) -> TimedTemplate:
+        return TimedTemplate(super().from_string(template_code))
+
+    def get_template(self, template_name: str) -> TimedTemplate:
+        return TimedTemplate(super().get_template(template_name))
+
+
+class Jinja2(BaseJinja2):
+    def from_string(self, template_code: str) -> TimedTemplate:
+        return TimedTemplate(super().from_string(template_code))
+
+    def get_template(self, template_name: str) -> TimedTemplate:
+        return TimedTemplate(super().get_template(template_name))
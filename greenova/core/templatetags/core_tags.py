@@ -7,6 +7,7 @@
     THEME_OPTIONS,
     USER_NAVIGATION,
 )
+from core.utils.chart_cache import chart_data_url, get_chart_render_mode
 from django import template
 from django.conf import settings
 from django.urls import NoReverseMatch, reverse
@@ -132,7 +133,7 @@ def main_navigation(context):
 
 @register.filter
 def user_role_in_project(project, user):
-    """Get user's role in a project."""
+    """Get user's role in a project from the user's per-request role map."""
     if hasattr(project, "get_user_role"):
         return project.get_user_role(user)
     return None
@@ -156,3 +157,23 @@ def format_date(date_value, format_string="%d %b %Y"):
         return date_value.strftime(format_string)
     except (AttributeError, ValueError):
         return str(date_value)
+
+
+@register.inclusion_tag("core/components/chart.html")
+def chart_embed(src, alt, width=None, height=None, css_class=""):
+    """
+    Embed a chart served by the dashboard chart endpoint.
+
+    In 'image' mode this is a lazily loaded <img>. In 'data' mode the
+    browser fetches the chart's JSON series and draws it with
+    data-charts.js; the image stays as the fallback without JavaScript.
+    """
+    data_mode = get_chart_render_mode() == "data"
+    return {
+        "src": src,
+        "data_src": chart_data_url(src) if data_mode else None,
+        "alt": alt,
+        "width": width,
+        "height": height,
+        "css_class": css_class,
+    }
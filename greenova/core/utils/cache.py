@@ -0,0 +1,166 @@
+"""
+Namespaced, versioned access to the shared cache.
+
+Entries live under a scope such as ``project:12`` or ``company:3``. Every
+scope has its own version counter that is part of each key, so invalidating
+a tenant is a single INCR; superseded entries are never read again and age
+out through their timeout. Counters start from the current time rather
+than 1, so one restarted after an eviction never repeats a version that
+workers may still hold. Hits and misses are counted per bucket in the
+shared cache itself, so the numbers add up across all workers
+(``manage.py cache_stats``).
+"""
+
+import logging
+import time
+from typing import Any, Callable, Dict, Iterable, Optional
+
+from core.utils.timing import count_cache_access
+from django.conf import settings
+from django.core.cache import cache
+
+logger = logging.getLogger(__name__)
+
+GLOBAL_SCOPE = 'global'
+NAMESPACE_PREFIX = 'ns'
+STATS_PREFIX = 'cache-stats'
+DEFAULT_BUCKET = 'default'
+# Buckets reported by get_cache_stats() when none are given
+CACHE_STATS_BUCKETS = ('charts', 'dashboard', 'fragments', DEFAULT_BUCKET)
+
+_MISSING = object()
+
+
+def project_scope(project_id: Optional[Any]) -> str:
+    """Cache scope for one project; the global scope when none is selected."""
+    return f'project:{project_id}' if project_id else GLOBAL_SCOPE
+
+
+def company_scope(company_id: Optional[Any]) -> str:
+    """Cache scope for one company; the global scope when none is given."""
+    return f'company:{company_id}' if company_id else GLOBAL_SCOPE
+
+
+def _version_key(scope: str) -> str:
+    return f'{NAMESPACE_PREFIX}:{scope}:version'
+
+
+def _initial_version() -> int:
+    # Microseconds since the epoch, ahead of any version handed out before
+    return time.time_ns() // 1000
+
+
+def get_namespace_version(scope: str) -> int:
+    """Return the current version of a scope, starting it if it has none."""
+    return cache.get_or_set(_version_key(scope), _initial_version, timeout=None)
+
+
+def invalidate_namespace(scope: str) -> None:
+    """Retire every entry cached under ``scope``."""
+    key = _version_key(scope)
+    try:
+        cache.incr(key)
+    except ValueError:
+        # Never used or evicted: restart past every version already handed out
+        if not cache.add(key, _initial_version(), timeout=None):
+            cache.incr(key)
+    logger.debug('Invalidated cache namespace %s', scope)
+
+
+def namespaced_key(scope: str, key: str) -> str:
+    """Build the versioned cache key for ``key`` within ``scope``."""
+    return f'{NAMESPACE_PREFIX}:{scope}:v{get_namespace_version(scope)}:{key}'
+
+
+def cached(
+    scope: str,
+    key: str,
+    compute: Callable[[], Any],
+    timeout: Optional[int] = None,
+    bucket: str = DEFAULT_BUCKET,
+) -> Any:
+    """
+    Return a cached value for ``key`` in ``scope``, computing it on a miss.
+
+    Args:
+        scope: Tenant scope from project_scope()/company_scope()
+        key: Key within the scope
+        compute: Zero-argument callable producing the value
+        timeout: Seconds to keep the value (cache default if None)
+        bucket: Name the hit/miss counters are recorded under
+
+    Returns:
+        The cached or freshly computed value
+    """
+    full_key = namespaced_key(scope, key)
+    value = cache.get(full_key, _MISSING)
+    if value is not _MISSING:
+        record_cache_access(bucket, hit=True)
+        return value
+
+    record_cache_access(bucket, hit=False)
+    value = compute()
+    if timeout is None:
+        cache.set(full_key, value)
+    else:
+        cache.set(full_key, value, timeout=timeout)
+    return value
+
+
+def _stats_key(bucket: str, outcome: str) -> str:
+    return f'{STATS_PREFIX}:{bucket}:{outcome}'
+
+
+def record_cache_access(bucket: str, hit: bool) -> None:
+    """Count one hit or miss for ``bucket`` (settings.CACHE_STATS_ENABLED)."""
+    count_cache_access(hit)
+    if not getattr(settings, 'CACHE_STATS_ENABLED', False):
+        return
+    key = _stats_key(bucket, 'hits' if hit else 'misses')
+    try:
+        cache.incr(key)
+    except ValueError:
+        # First access since start/reset; another worker may win the add
+        if not cache.add(key, 1, timeout=None):
+            cache.incr(key)
+
+
+def get_cache_stats(
+    buckets: Optional[Iterable[str]] = None,
+) -> Dict[str, Dict[str, Any]]:
+    """
+    Return hit/miss counters per bucket.
+
+    Returns:
+        Dict mapping bucket name to ``{'hits', 'misses', 'hit_ratio'}``
+    """
+    buckets = list(buckets or CACHE_STATS_BUCKETS)
+    keys = [
+        _stats_key(bucket, outcome)
+        for bucket in buckets
+        for outcome in ('hits', 'misses')
+    ]
+    counters = cache.get_many(keys)
+
+    stats: Dict[str, Dict[str, Any]] = {}
+    for bucket in buckets:
+        hits = counters.get(_stats_key(bucket, 'hits'), 0)
+        misses = counters.get(_stats_key(bucket, 'misses'), 0)
+        total = hits + misses
+        stats[bucket] = {
+            'hits': hits,
+            'misses': misses,
+            'hit_ratio': hits / total if total else None,
+        }
+    return stats
+
+
+def reset_cache_stats(buckets: Optional[Iterable[str]] = None) -> None:
+    """Zero the hit/miss counters of the given (or default) buckets."""
+    cache.delete_many(
+        [
+            _stats_key(bucket, outcome)
+            for bucket in (buckets or CACHE_STATS_BUCKETS)
+            for outcome in ('hits', 'misses')
+        ]
+    )
@@ -0,0 +1,26 @@
+# Stub file for core.utils.cache
+from typing import Any, Callable, Dict, Iterable, Optional, Tuple
+
+GLOBAL_SCOPE: str
+NAMESPACE_PREFIX: str
+STATS_PREFIX: str
+DEFAULT_BUCKET: str
+CACHE_STATS_BUCKETS: Tuple[str, ...]
+
+def project_scope(project_id: Optional[Any]) -> str: ...
+def company_scope(company_id: Optional[Any]) -> str: ...
+def get_namespace_version(scope: str) -> int: ...
+def invalidate_namespace(scope: str) -> None: ...
+def namespaced_key(scope: str, key: str) -> str: ...
+def cached(
+    scope: str,
+    key: str,
+    compute: Callable[[], Any],
+    timeout: Optional[int] = ...,
+    bucket: str = ...,
+) -> Any: ...
+def record_cache_access(bucket: str, hit: bool) -> None: ...
+def get_cache_stats(
+    buckets: Optional[Iterable[str]] = ...,
+) -> Dict[str, Dict[str, Any]]: ...
+def reset_cache_stats(buckets: Optional[Iterable[str]] = ...) -> None: ...
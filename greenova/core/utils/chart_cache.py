@@ -0,0 +1,290 @@
+"""
+Render-once cache for matplotlib charts.
+
+Charts are keyed on (chart kind, size, format, fingerprint of the data they
+plot) and the encoded image bytes are stored in the Django cache, so a
+repeated request for the same data never touches matplotlib. A global
+version number is mixed into every key and bumped by the 'charts.refresh'
+background job, which the obligation and mechanism save/delete signals
+enqueue; this retires every cached chart at once.
+"""
+
+import hashlib
+import io
+import json
+import logging
+import sys
+from dataclasses import dataclass
+from typing import Any, Callable, Dict, Optional
+
+from core.jobs import enqueue_job, register_job
+from core.utils.cache import record_cache_access
+from core.utils.timing import timed
+from django.conf import settings
+from django.core.cache import cache
+from django.db.models.signals import post_delete, post_save
+from django.http import Http404, HttpRequest, HttpResponse, JsonResponse
+from django.urls import reverse
+from django.utils.cache import get_conditional_response, patch_cache_control
+from django.utils.http import urlencode
+
+logger = logging.getLogger(__name__)
+
+CHART_CACHE_PREFIX = 'charts'
+CHART_CACHE_VERSION_KEY = f'{CHART_CACHE_PREFIX}:version'
+CHART_URL_NAME = 'dashboard:chart_image'
+CHART_CONTENT_TYPES = {
+    'png': 'image/png',
+    'svg': 'image/svg+xml',
+    'pdf': 'application/pdf',
+}
+# Served from the chart series without loading matplotlib
+CHART_DATA_FORMAT = 'json'
+CHART_RENDER_MODES = ('image', 'data')
+
+
+def get_chart_render_mode() -> str:
+    """
+    How pages embed charts (settings.CHART_RENDER_MODE).
+
+    'image' embeds server-rendered PNGs; 'data' embeds the JSON series and
+    leaves drawing to static/js/modules/data-charts.js in the browser.
+    """
+    mode = getattr(settings, 'CHART_RENDER_MODE', 'image')
+    return mode if mode in CHART_RENDER_MODES else 'image'
+
+
+def get_chart_cache_timeout() -> int:
+    """Seconds a rendered chart stays cached (settings.CHART_CACHE_TIMEOUT)."""
+    return getattr(settings, 'CHART_CACHE_TIMEOUT', 60 * 60)
+
+
+def fingerprint(data: Any) -> str:
+    """
+    Return a stable hash of the data a chart is drawn from.
+
+    Args:
+        data: JSON-serialisable counts/labels (dict keys are sorted)
+
+    Returns:
+        str: Hex digest identifying the data
+    """
+    payload = json.dumps(data, sort_keys=True, default=str, separators=(',', ':'))
+    return hashlib.sha256(payload.encode('utf-8')).hexdigest()[:32]
+
+
+def get_chart_cache_version() -> int:
+    """Return the current chart cache generation."""
+    return cache.get_or_set(CHART_CACHE_VERSION_KEY, 1, timeout=None)
+
+
+def bump_chart_cache_version(*args: Any, **kwargs: Any) -> None:
+    """Retire every cached chart; usable directly as a signal receiver."""
+    try:
+        cache.incr(CHART_CACHE_VERSION_KEY)
+    except ValueError:
+        # Key expired or was never set; start a fresh generation
+        cache.set(CHART_CACHE_VERSION_KEY, 1, timeout=None)
+
+
+@register_job('charts.refresh')
+def run_chart_refresh(keys: Any = None) -> None:
+    """Background job: retire cached charts once for a burst of changes."""
+    bump_chart_cache_version()
+
+
+def schedule_chart_refresh(*args: Any, **kwargs: Any) -> None:
+    """Signal receiver enqueueing a deduplicated 'charts.refresh' job."""
+    enqueue_job('charts.refresh')
+
+
+def chart_cache_key(
+    kind: str,
+    data_fingerprint: str,
+    width: Optional[int] = None,
+    height: Optional[int] = None,
+    fmt: str = 'png',
+) -> str:
+    """Build the cache key for one rendered chart."""
+    size = f'{width or 0}x{height or 0}'
+    return (
+        f'{CHART_CACHE_PREFIX}:v{get_chart_cache_version()}:'
+        f'{kind}:{size}:{fmt}:{data_fingerprint}'
+    )
+
+
+def figure_to_bytes(figure: Any, fmt: str = 'png') -> bytes:
+    """
+    Encode a matplotlib figure and release it.
+
+    Args:
+        figure: Matplotlib Figure to encode
+        fmt: Output format ('png', 'svg' or 'pdf')
+
+    Returns:
+        bytes: The encoded image
+    """
+    buf = io.BytesIO()
+    try:
+        figure.savefig(buf, format=fmt, bbox_inches='tight')
+    finally:
+        # Figures created through pyplot stay registered until closed; if
+        # pyplot was never imported there is nothing to close, and importing
+        # it just to find out would load pyplot and a backend on every worker
+        pyplot = sys.modules.get('matplotlib.pyplot')
+        if pyplot is not None:
+            pyplot.close(figure)
+    return buf.getvalue()
+
+
+def get_or_render_chart(
+    kind: str,
+    data: Any,
+    render: Callable[[], Any],
+    width: Optional[int] = None,
+    height: Optional[int] = None,
+    fmt: str = 'png',
+) -> bytes:
+    """
+    Return encoded chart bytes, rendering with matplotlib only on a miss.
+
+    Args:
+        kind: Chart type, e.g. 'mechanism_status'
+        data: The counts the chart plots; hashed into the cache key
+        render: Zero-argument callable returning a matplotlib Figure
+        width: Chart width in pixels (part of the key)
+        height: Chart height in pixels (part of the key)
+        fmt: Output format ('png', 'svg' or 'pdf')
+
+    Returns:
+        bytes: The encoded image
+    """
+    key = chart_cache_key(kind, fingerprint(data), width, height, fmt)
+    image = cache.get(key)
+    record_cache_access('charts', hit=image is not None)
+    if image is None:
+        with timed('chart'):
+            image = figure_to_bytes(render(), fmt)
+        cache.set(key, image, timeout=get_chart_cache_timeout())
+        logger.debug('Rendered chart %s', key)
+    return image
+
+
+@dataclass(frozen=True)
+class ChartSpec:
+    """
+    Everything needed to identify and, if necessary, draw one chart.
+
+    Building a spec only runs the queries that produce ``data``; ``render``
+    is invoked on a cache miss. ``series`` is the same data shaped for
+    client-side drawing: ``{'type': 'pie'|'bar', 'title', 'labels',
+    'values', 'colors'}``.
+    """
+
+    kind: str
+    data: Any
+    render: Callable[[], Any]
+    width: Optional[int] = None
+    height: Optional[int] = None
+    series: Optional[Dict[str, Any]] = None
+
+    def etag(self, fmt: str = 'png') -> str:
+        """
+        Strong ETag for this chart.
+
+        Derived from the data fingerprint rather than the cache generation,
+        so a browser copy stays valid until this chart's own data changes.
+        """
+        digest = fingerprint(
+            [self.kind, self.width, self.height, fmt, fingerprint(self.data)]
+        )
+        return f'"{digest}"'
+
+    def image(self, fmt: str = 'png') -> bytes:
+        """Return the encoded chart, rendering only on a cache miss."""
+        return get_or_render_chart(
+            self.kind, self.data, self.render, self.width, self.height, fmt
+        )
+
+
+def chart_response(
+    request: HttpRequest, spec: ChartSpec, fmt: str = 'png'
+) -> HttpResponse:
+    """
+    Serve a chart as image bytes, or as its JSON series, with a strong ETag.
+
+    A matching If-None-Match gets a 304 without touching the chart cache or
+    matplotlib. Responses are private (charts sit behind login) and must be
+    revalidated, which costs the browser one conditional request.
+
+    Raises:
+        Http404: If ``fmt`` is not supported, or is 'json' for a chart
+            without a series
+    """
+    if fmt == CHART_DATA_FORMAT:
+        if spec.series is None:
+            raise Http404(f'Chart {spec.kind} has no data series')
+    elif fmt not in CHART_CONTENT_TYPES:
+        raise Http404(f'Unsupported chart format: {fmt}')
+
+    etag = spec.etag(fmt)
+    response = get_conditional_response(request, etag=etag)
+    if response is None and fmt == CHART_DATA_FORMAT:
+        response = JsonResponse({'kind': spec.kind, **spec.series})
+    elif response is None:
+        response = HttpResponse(
+            spec.image(fmt), content_type=CHART_CONTENT_TYPES[fmt]
+        )
+    response['ETag'] = etag
+    patch_cache_control(response, private=True, no_cache=True)
+    return response
+
+
+def chart_url(
+    kind: str,
+    object_id: Optional[int] = None,
+    fmt: str = 'png',
+    params: Optional[Dict[str, Any]] = None,
+) -> str:
+    """
+    Return the image URL of a chart served by ``dashboard:chart_image``.
+
+    Args:
+        kind: Chart kind registered with the dashboard chart endpoint
+        object_id: Project or mechanism the chart plots (0/None for all)
+        fmt: Output format ('png', 'svg' or 'pdf')
+        params: Extra query parameters, e.g. filters; empty values are dropped
+
+    Returns:
+        str: The chart URL
+    """
+    url = reverse(
+        CHART_URL_NAME,
+        kwargs={'kind': kind, 'object_id': object_id or 0, 'fmt': fmt},
+    )
+    query = {key: value for key, value in (params or {}).items() if value}
+    if query:
+        url = f'{url}?{urlencode(query)}'
+    return url
+
+
+def chart_data_url(image_url: str) -> str:
+    """Return the JSON series URL for a chart image URL from chart_url()."""
+    path, sep, query = image_url.partition('?')
+    base, _, _ = path.rpartition('.')
+    return f'{base}.{CHART_DATA_FORMAT}{sep}{query}'
+
+
+def connect_chart_cache_signals() -> None:
+    """Invalidate cached charts whenever obligations or mechanisms change."""
+    for sender in ('obligations.Obligation', 'mechanisms.EnvironmentalMechanism'):
+        post_save.connect(
+            schedule_chart_refresh,
+            sender=sender,
+            dispatch_uid=f'chart_cache_save_{sender}',
+        )
+        post_delete.connect(
+            schedule_chart_refresh,
+            sender=sender,
+            dispatch_uid=f'chart_cache_delete_{sender}',
+        )
@@ -0,0 +1,59 @@
+# Stub file for core.utils.chart_cache
+from dataclasses import dataclass
+from typing import Any, Callable, Dict, Optional
+
+from django.http import HttpRequest, HttpResponse
+
+CHART_CACHE_PREFIX: str
+CHART_CACHE_VERSION_KEY: str
+CHART_URL_NAME: str
+CHART_CONTENT_TYPES: Dict[str, str]
+CHART_DATA_FORMAT: str
+CHART_RENDER_MODES: tuple[str, ...]
+
+def get_chart_render_mode() -> str: ...
+
+def get_chart_cache_timeout() -> int: ...
+def fingerprint(data: Any) -> str: ...
+def get_chart_cache_version() -> int: ...
+def bump_chart_cache_version(*args: Any, **kwargs: Any) -> None: ...
+def run_chart_refresh(keys: Any = ...) -> None: ...
+def schedule_chart_refresh(*args: Any, **kwargs: Any) -> None: ...
+def chart_cache_key(
+    kind: str,
+    data_fingerprint: str,
+    width: Optional[int] = ...,
+    height: Optional[int] = ...,
+    fmt: str = ...,
+) -> str: ...
+def figure_to_bytes(figure: Any, fmt: str = ...) -> bytes: ...
+def get_or_render_chart(
+    kind: str,
+    data: Any,
+    render: Callable[[], Any],
+    width: Optional[int] = ...,
+    height: Optional[int] = ...,
+    fmt: str = ...,
+) -> bytes: ...
+@dataclass(frozen=True)
+class ChartSpec:
+    kind: str
+    data: Any
+    render: Callable[[], Any]
+    width: Optional[int] = ...
+    height: Optional[int] = ...
+    series: Optional[Dict[str, Any]] = ...
+    def etag(self, fmt: str = ...) -> str: ...
+    def image(self, fmt: str = ...) -> bytes: ...
+
+def chart_response(
+    request: HttpRequest, spec: ChartSpec, fmt: str = ...
+) -> HttpResponse: ...
+def chart_url(
+    kind: str,
+    object_id: Optional[int] = ...,
+    fmt: str = ...,
+    params: Optional[Dict[str, Any]] = ...,
+) -> str: ...
+def chart_data_url(image_url: str) -> str: ...
+def connect_chart_cache_signals() -> None: ...
@@ -0,0 +1,33 @@
+"""
+Database helpers shared by code that reads large result sets.
+"""
+
+from typing import Iterator
+
+from django.db import transaction
+from django.db.models import QuerySet
+
+DEFAULT_CHUNK_SIZE = 2000
+
+
+def iterate_queryset(
+    queryset: QuerySet, chunk_size: int = DEFAULT_CHUNK_SIZE
+) -> Iterator:
+    """
+    Stream a queryset through a server-side cursor in ``chunk_size`` batches.
+
+    On PostgreSQL ``QuerySet.iterator()`` uses a named cursor, so memory
+    stays flat however many rows there are. The cursor is only valid inside
+    a transaction when connections go through pgbouncer in transaction
+    pooling mode, so iteration runs in one; on SQLite this is a plain
+    chunked fetch.
+
+    Args:
+        queryset: Rows to read (models, values() dicts or values_list tuples)
+        chunk_size: Rows fetched from the cursor per round trip
+
+    Yields:
+        The queryset's rows, one at a time
+    """
+    with transaction.atomic(using=queryset.db):
+        yield from queryset.iterator(chunk_size=chunk_size)
@@ -0,0 +1,8 @@
+# Stub file for core.utils.db
+from typing import Any, Iterator
+
+from django.db.models import QuerySet
+
+DEFAULT_CHUNK_SIZE: int
+
+def iterate_queryset(queryset: QuerySet[Any], chunk_size: int = ...) -> Iterator[Any]: ...
@@ -0,0 +1,210 @@
+"""
+Content-addressed storage and ranged downloads for uploaded files.
+
+Uploads larger than ``FILE_UPLOAD_MAX_MEMORY_SIZE`` are spooled to a
+temporary file by Django, and everything here reads them in chunks, so no
+upload is held in worker memory whole. Files are stored under their SHA-256
+digest: the same document attached to many records is written once, and its
+size and hash are kept on the row so listing files never touches storage.
+
+Downloads are handed to the front-end server with ``X-Accel-Redirect`` when
+``settings.X_ACCEL_REDIRECT_PREFIX`` is set, and otherwise streamed by
+Django with HTTP Range support. Under ASGI the streamed bytes go out one
+64 KiB chunk at a time (``core.utils.streaming``), each read costing a
+thread hop; set the prefix in production so nginx serves them instead.
+"""
+
+import hashlib
+import mimetypes
+import os
+import re
+from typing import IO, Iterator, Optional, Tuple
+
+from core.utils.streaming import stream_async
+from django.conf import settings
+from django.core.files.base import File
+from django.db.models import Model
+from django.db.models.fields.files import FieldFile
+from django.http import FileResponse, HttpRequest, HttpResponse, StreamingHttpResponse
+from django.utils.http import content_disposition_header
+
+DOWNLOAD_CHUNK_SIZE = 64 * 1024
+
+_RANGE_PATTERN = re.compile(r'^bytes=(\d*)-(\d*)$')
+# Extensions kept on stored names; anything else is dropped, so a stored
+# name is at most len(prefix) + 82 characters
+_EXTENSION_PATTERN = re.compile(r'^\.[a-z0-9]{1,10}$')
+
+
+def hash_file(file: File) -> Tuple[str, int]:
+    """
+    Return the SHA-256 hex digest and size of a file, reading it in chunks.
+
+    The file is left positioned at its start.
+    """
+    digest = hashlib.sha256()
+    size = 0
+    file.seek(0)
+    for chunk in file.chunks():
+        digest.update(chunk)
+        size += len(chunk)
+    file.seek(0)
+    return digest.hexdigest(), size
+
+
+def content_addressed_name(prefix: str, sha256: str, original_name: str) -> str:
+    """
+    Return the storage path of a file with digest ``sha256``.
+
+    The original extension is kept, lower-cased, when it is 1-10 letters or
+    digits; longer or unusual extensions are dropped rather than overflowing
+    the FileField (the download name comes from ``original_name`` anyway).
+    """
+    extension = os.path.splitext(original_name)[1].lower()
+    if not _EXTENSION_PATTERN.match(extension):
+        extension = ''
+    return f'{prefix}/{sha256[:2]}/{sha256[2:4]}/{sha256}{extension}'
+
+
+def store_content_addressed(
+    instance: Model, field_name: str, upload: File, prefix: str
+) -> Tuple[str, int]:
+    """
+    Point a FileField at the stored copy of ``upload``, writing it only once.
+
+    Args:
+        instance: The model instance to fill in (not saved)
+        field_name: Name of its FileField
+        upload: The uploaded file
+        prefix: Storage directory, e.g. 'evidence_files/sha256'
+
+    Returns:
+        tuple: The SHA-256 hex digest and size of the upload
+    """
+    sha256, size = hash_file(upload)
+    name = content_addressed_name(prefix, sha256, upload.name or '')
+    storage = instance._meta.get_field(field_name).storage
+    if not storage.exists(name):
+        name = storage.save(name, upload)
+    # A plain name is a committed file, so saving the row writes nothing
+    setattr(instance, field_name, name)
+    return sha256, size
+
+
+def delete_unreferenced_file(
+    field_file: FieldFile, model: type[Model], field_name: str
+) -> bool:
+    """
+    Delete a stored file once no row of ``model`` refers to it any more.
+
+    Returns:
+        bool: True if the file was deleted
+    """
+    if not field_file.name:
+        return False
+    if model.objects.filter(**{field_name: field_file.name}).exists():
+        return False
+    field_file.storage.delete(field_file.name)
+    return True
+
+
+def parse_range(header: str, size: int) -> Optional[Tuple[int, int]]:
+    """
+    Parse a single-range ``Range`` header into inclusive (start, end).
+
+    Returns:
+        tuple: The byte range, or None if the header is absent, has several
+        ranges or is malformed (the whole file is then sent)
+
+    Raises:
+        ValueError: If the range lies outside the file
+    """
+    match = _RANGE_PATTERN.match((header or '').strip())
+    if not match:
+        return None
+    first, last = match.groups()
+    if not first and not last:
+        return None
+    if first:
+        start = int(first)
+        end = min(int(last), size - 1) if last else size - 1
+    else:
+        # Suffix range: the last N bytes
+        start = max(size - int(last), 0)
+        end = size - 1
+    if start > end or start >= size:
+        raise ValueError('Unsatisfiable range')
+    return start, end
+
+
+def _content_type(filename: str) -> str:
+    return mimetypes.guess_type(filename)[0] or 'application/octet-stream'
+
+
+def _read_range(file: IO[bytes], start: int, length: int) -> Iterator[bytes]:
+    try:
+        file.seek(start)
+        while length > 0:
+            chunk = file.read(min(DOWNLOAD_CHUNK_SIZE, length))
+            if not chunk:
+                break
+            length -= len(chunk)
+            yield chunk
+    finally:
+        file.close()
+
+
+def file_download_response(
+    request: HttpRequest,
+    field_file: FieldFile,
+    filename: Optional[str] = None,
+    size: Optional[int] = None,
+    as_attachment: bool = True,
+) -> HttpResponse:
+    """
+    Serve a stored file without loading it into memory.
+
+    Args:
+        request: The download request; its Range header is honoured
+        field_file: The stored file
+        filename: Name offered to the browser (default: the stored name)
+        size: Known size in bytes, to avoid asking the storage
+        as_attachment: Send Content-Disposition: attachment
+    """
+    filename = filename or os.path.basename(field_file.name)
+    accel_prefix = getattr(settings, 'X_ACCEL_REDIRECT_PREFIX', '')
+    if accel_prefix:
+        # nginx serves the bytes, ranges included
+        response = HttpResponse(content_type=_content_type(filename))
+        response['X-Accel-Redirect'] = f'{accel_prefix.rstrip("/")}/{field_file.name}'
+        response['Content-Disposition'] = content_disposition_header(
+            as_attachment, filename
+        )
+        return response
+
+    if size is None:
+        size = field_file.size
+    try:
+        byte_range = parse_range(request.headers.get('Range', ''), size)
+    except ValueError:
+        response = HttpResponse(status=416)
+        response['Content-Range'] = f'bytes */{size}'
+        return response
+
+    file = field_file.storage.open(field_file.name, 'rb')
+    if byte_range is None:
+        response = FileResponse(file, as_attachment=as_attachment, filename=filename)
+    else:
+        start, end = byte_range
+        response = StreamingHttpResponse(
+            _read_range(file, start, end - start + 1),
+            status=206,
+            content_type=_content_type(filename),
+        )
+        response['Content-Range'] = f'bytes {start}-{end}/{size}'
+        response['Content-Length'] = str(end - start + 1)
+        response['Content-Disposition'] = content_disposition_header(
+            as_attachment, filename
+        )
+    response['Accept-Ranges'] = 'bytes'
+    return stream_async(request, response)
@@ -0,0 +1,26 @@
+# Stub file for core.utils.files
+from typing import Optional, Tuple
+
+from django.core.files.base import File
+from django.db.models import Model
+from django.db.models.fields.files import FieldFile
+from django.http import HttpRequest, HttpResponse
+
+DOWNLOAD_CHUNK_SIZE: int
+
+def hash_file(file: File) -> Tuple[str, int]: ...
+def content_addressed_name(prefix: str, sha256: str, original_name: str) -> str: ...
+def store_content_addressed(
+    instance: Model, field_name: str, upload: File, prefix: str
+) -> Tuple[str, int]: ...
+def delete_unreferenced_file(
+    field_file: FieldFile, model: type[Model], field_name: str
+) -> bool: ...
+def parse_range(header: str, size: int) -> Optional[Tuple[int, int]]: ...
+def file_download_response(
+    request: HttpRequest,
+    field_file: FieldFile,
+    filename: Optional[str] = ...,
+    size: Optional[int] = ...,
+    as_attachment: bool = ...,
+) -> HttpResponse: ...
@@ -0,0 +1,97 @@
+"""
+Versioned caching and conditional GET for HTMX partials.
+
+A fragment is keyed on its cache scope's data version (see
+``core.utils.cache``; obligation save/delete signals bump the project and
+global scopes), today's date (overdue badges depend on it), the request's
+query string and any extra parts the view adds, such as the template or
+the user's edit permission. The same digest is the response's ETag, so a
+repeated HTMX swap is answered with a 304 after one version lookup, and a
+different client asking for the same fragment gets the cached HTML without
+a template render.
+"""
+
+import hashlib
+import json
+from typing import Any, Callable, Iterable, Optional, Tuple
+
+from core.utils.cache import get_namespace_version, namespaced_key, record_cache_access
+from django.core.cache import cache
+from django.http import HttpRequest, HttpResponse
+from django.utils import timezone
+from django.utils.cache import get_conditional_response, patch_cache_control
+
+FRAGMENT_CACHE_BUCKET = 'fragments'
+FRAGMENT_CACHE_TIMEOUT = 60 * 60
+
+
+def fragment_etag(
+    request: HttpRequest, scope: str, parts: Iterable[Any] = ()
+) -> str:
+    """
+    Return the strong ETag of a fragment in ``scope``.
+
+    Args:
+        request: The request; its path and sorted query string are hashed
+        scope: Cache scope whose version the fragment follows
+        parts: Anything else the rendered HTML depends on
+    """
+    query = sorted(
+        (key, value)
+        for key in request.GET
+        for value in request.GET.getlist(key)
+    )
+    payload = json.dumps(
+        [
+            scope,
+            get_namespace_version(scope),
+            timezone.now().date().isoformat(),
+            request.path,
+            query,
+            list(parts),
+        ],
+        default=str,
+        separators=(',', ':'),
+    )
+    return f'"{hashlib.sha256(payload.encode("utf-8")).hexdigest()[:32]}"'
+
+
+def fragment_response(
+    request: HttpRequest,
+    scope: str,
+    build: Callable[[], Tuple[str, bool]],
+    parts: Iterable[Any] = (),
+    timeout: Optional[int] = None,
+) -> HttpResponse:
+    """
+    Serve an HTMX partial from the fragment cache, or a 304 if unchanged.
+
+    Args:
+        request: The GET request for the partial
+        scope: Cache scope whose version the fragment follows
+        build: Renders the fragment; returns (html, cacheable). Fragments
+            that are not cacheable (error notices) get no ETag either.
+        parts: Anything else the rendered HTML depends on
+        timeout: Seconds to keep the HTML (default FRAGMENT_CACHE_TIMEOUT)
+
+    Returns:
+        HttpResponse: 304, cached HTML or freshly rendered HTML
+    """
+    etag = fragment_etag(request, scope, parts)
+    response = get_conditional_response(request, etag=etag)
+    if response is None:
+        key = namespaced_key(scope, f'fragment:{etag[1:-1]}')
+        html = cache.get(key)
+        record_cache_access(FRAGMENT_CACHE_BUCKET, hit=html is not None)
+        cacheable = True
+        if html is None:
+            html, cacheable = build()
+            if cacheable:
+                cache.set(key, html, timeout=timeout or FRAGMENT_CACHE_TIMEOUT)
+        response = HttpResponse(html)
+        if not cacheable:
+            return response
+    response['ETag'] = etag
+    # Private (behind login) and revalidated on every swap
+    patch_cache_control(response, private=True, no_cache=True)
+    return response
@@ -0,0 +1,18 @@
+# Stub file for core.utils.fragments
+from typing import Any, Callable, Iterable, Optional, Tuple
+
+from django.http import HttpRequest, HttpResponse
+
+FRAGMENT_CACHE_BUCKET: str
+FRAGMENT_CACHE_TIMEOUT: int
+
+def fragment_etag(
+    request: HttpRequest, scope: str, parts: Iterable[Any] = ...
+) -> str: ...
+def fragment_response(
+    request: HttpRequest,
+    scope: str,
+    build: Callable[[], Tuple[str, bool]],
+    parts: Iterable[Any] = ...,
+    timeout: Optional[int] = ...,
+) -> HttpResponse: ...
@@ -0,0 +1,232 @@
+"""
+Keyset (cursor) pagination for list partials.
+
+``Paginator`` runs ``COUNT(*)`` and then ``OFFSET n``, so every page scans
+all the rows before it. Keyset pagination instead remembers the sort value
+and primary key of the last row shown and asks for the rows after it, which
+an index on the sort column serves directly: page N costs the same as
+page 1. Rows with a NULL sort value are always listed last.
+
+Cursors are opaque URL-safe tokens. Orderings that cannot be expressed as a
+column filter (e.g. search rank) fall back to offset cursors.
+"""
+
+import base64
+import binascii
+import json
+from dataclasses import dataclass, field
+from typing import Any, Callable, List, Optional
+
+from django.core.exceptions import ValidationError
+from django.db.models import F, Q, QuerySet
+
+DEFAULT_PER_PAGE = 15
+CURSOR_PARAM = 'cursor'
+
+
+class InvalidCursor(ValueError):
+    """Raised for cursor tokens that cannot be decoded."""
+
+
+def encode_cursor(payload: dict) -> str:
+    """Encode a cursor payload as a URL-safe token."""
+    raw = json.dumps(payload, separators=(',', ':'), default=str).encode()
+    return base64.urlsafe_b64encode(raw).decode().rstrip('=')
+
+
+def decode_cursor(token: str) -> dict:
+    """Decode a token produced by encode_cursor()."""
+    try:
+        padded = token + '=' * (-len(token) % 4)
+        payload = json.loads(base64.urlsafe_b64decode(padded.encode()))
+    except (binascii.Error, ValueError, UnicodeDecodeError) as exc:
+        raise InvalidCursor(token) from exc
+    if not isinstance(payload, dict):
+        raise InvalidCursor(token)
+    return payload
+
+
+@dataclass
+class KeysetPage:
+    """One page of results plus the cursors of its neighbours."""
+
+    object_list: List[Any]
+    per_page: int
+    next_cursor: Optional[str] = None
+    previous_cursor: Optional[str] = None
+    _count: Optional[Callable[[], int]] = field(default=None, repr=False)
+    _total: Optional[int] = field(default=None, init=False, repr=False)
+
+    def __iter__(self):
+        return iter(self.object_list)
+
+    def __len__(self) -> int:
+        return len(self.object_list)
+
+    def __bool__(self) -> bool:
+        return bool(self.object_list)
+
+    @property
+    def has_next(self) -> bool:
+        return self.next_cursor is not None
+
+    @property
+    def has_previous(self) -> bool:
+        return self.previous_cursor is not None
+
+    @property
+    def has_other_pages(self) -> bool:
+        return self.has_next or self.has_previous
+
+    @property
+    def total_count(self) -> Optional[int]:
+        """Total rows, from the count callable given to paginate_keyset()."""
+        if self._total is None and self._count is not None:
+            self._total = self._count()
+        return self._total
+
+
+def _seek_q(
+    sort_field: str, value: Any, pk: Any, descending: bool, forward: bool
+) -> Q:
+    """
+    Match rows after (``forward``) or before the row ``(value, pk)``.
+
+    Ordering is ``sort_field`` then ``pk`` in the same direction, NULLs last.
+    """
+    # Going backwards is going forwards in the opposite direction
+    later = 'lt' if descending == forward else 'gt'
+    if forward:
+        if value is None:
+            return Q(**{f'{sort_field}__isnull': True, f'pk__{later}': pk})
+        return (
+            Q(**{f'{sort_field}__{later}': value})
+            | Q(**{sort_field: value, f'pk__{later}': pk})
+            | Q(**{f'{sort_field}__isnull': True})
+        )
+    if value is None:
+        return Q(**{f'{sort_field}__isnull': False}) | Q(
+            **{f'{sort_field}__isnull': True, f'pk__{later}': pk}
+        )
+    return Q(**{f'{sort_field}__{later}': value}) | Q(
+        **{sort_field: value, f'pk__{later}': pk}
+    )
+
+
+def _ordering(sort_field: str, descending: bool, forward: bool) -> list:
+    """
+    Order by ``sort_field`` then pk, reversed when paging backwards.
+
+    NULLs are placed explicitly (last going forward, first going back) so
+    every backend, including Postgres with its NULLs-largest default, lists
+    them in the same place. Django only accepts True or None for nulls_first
+    and nulls_last.
+    """
+    field_expr = F(sort_field)
+    pk_expr = F('pk')
+    if forward:
+        nulls = {'nulls_last': True}
+    else:
+        nulls = {'nulls_first': True}
+    if descending == forward:
+        return [field_expr.desc(**nulls), pk_expr.desc()]
+    return [field_expr.asc(**nulls), pk_expr.asc()]
+
+
+def _row_cursor(row: Any, sort_field: str, direction: str) -> str:
+    return encode_cursor({
+        'd': direction,
+        'v': getattr(row, sort_field),
+        'pk': row.pk,
+    })
+
+
+def _paginate_offset(
+    queryset: QuerySet,
+    payload: dict,
+    per_page: int,
+    count: Optional[Callable[[], int]],
+) -> KeysetPage:
+    """Offset fallback for orderings that are not a plain column."""
+    try:
+        offset = max(int(payload.get('o', 0)), 0)
+    except (TypeError, ValueError) as exc:
+        raise InvalidCursor(str(payload)) from exc
+    rows = list(queryset[offset:offset + per_page + 1])
+    return KeysetPage(
+        object_list=rows[:per_page],
+        per_page=per_page,
+        next_cursor=(
+            encode_cursor({'o': offset + per_page}) if len(rows) > per_page else None
+        ),
+        previous_cursor=(
+            encode_cursor({'o': max(offset - per_page, 0)}) if offset else None
+        ),
+        _count=count,
+    )
+
+
+def paginate_keyset(
+    queryset: QuerySet,
+    sort_field: Optional[str],
+    cursor: Optional[str] = None,
+    descending: bool = False,
+    per_page: int = DEFAULT_PER_PAGE,
+    count: Optional[Callable[[], int]] = None,
+) -> KeysetPage:
+    """
+    Return the page of ``queryset`` that ``cursor`` points at.
+
+    Args:
+        queryset: Rows to paginate; its ordering is replaced
+        sort_field: Concrete field to order by, or None to keep the
+            queryset's own ordering with offset cursors
+        cursor: Token from a previous page's next/previous cursor
+        descending: Sort ``sort_field`` high to low
+        per_page: Rows per page
+        count: Optional callable returning the total row count (e.g. a
+            cached count); it is only called if the template asks for it
+
+    Returns:
+        KeysetPage: The rows with next/previous cursors
+
+    Raises:
+        InvalidCursor: If ``cursor`` is malformed
+    """
+    payload = decode_cursor(cursor) if cursor else {}
+    if sort_field is None or 'o' in payload:
+        return _paginate_offset(queryset, payload, per_page, count)
+
+    forward = payload.get('d', 'next') == 'next'
+    if payload:
+        # Cursor values went through JSON; convert them back to field types
+        model_field = queryset.model._meta.get_field(sort_field)
+        value = payload.get('v')
+        try:
+            value = model_field.to_python(value) if value is not None else None
+            pk = queryset.model._meta.pk.to_python(payload.get('pk'))
+        except ValidationError as exc:
+            raise InvalidCursor(str(payload)) from exc
+        queryset = queryset.filter(_seek_q(sort_field, value, pk, descending, forward))
+
+    rows = list(
+        queryset.order_by(*_ordering(sort_field, descending, forward))[:per_page + 1]
+    )
+    has_more = len(rows) > per_page
+    rows = rows[:per_page]
+    if not forward:
+        rows.reverse()
+
+    has_next = has_more if forward else bool(payload)
+    has_previous = bool(payload) if forward else has_more
+    return KeysetPage(
+        object_list=rows,
+        per_page=per_page,
+        next_cursor=(
+            _row_cursor(rows[-1], sort_field, 'next') if rows and has_next else None
+        ),
+        previous_cursor=(
+            _row_cursor(rows[0], sort_field, 'prev') if rows and has_previous else None
+        ),
+        _count=count,
+    )
@@ -0,0 +1,46 @@
+# Stub file for core.utils.pagination
+from typing import Any, Callable, Iterator, List, Optional
+
+from django.db.models import QuerySet
+
+DEFAULT_PER_PAGE: int
+CURSOR_PARAM: str
+
+class InvalidCursor(ValueError): ...
+
+def encode_cursor(payload: dict) -> str: ...
+def decode_cursor(token: str) -> dict: ...
+
+class KeysetPage:
+    object_list: List[Any]
+    per_page: int
+    next_cursor: Optional[str]
+    previous_cursor: Optional[str]
+    def __init__(
+        self,
+        object_list: List[Any],
+        per_page: int,
+        next_cursor: Optional[str] = ...,
+        previous_cursor: Optional[str] = ...,
+        _count: Optional[Callable[[], int]] = ...,
+    ) -> None: ...
+    def __iter__(self) -> Iterator[Any]: ...
+    def __len__(self) -> int: ...
+    def __bool__(self) -> bool: ...
+    @property
+    def has_next(self) -> bool: ...
+    @property
+    def has_previous(self) -> bool: ...
+    @property
+    def has_other_pages(self) -> bool: ...
+    @property
+    def total_count(self) -> Optional[int]: ...
+
+def paginate_keyset(
+    queryset: QuerySet[Any],
+    sort_field: Optional[str],
+    cursor: Optional[str] = ...,
+    descending: bool = ...,
+    per_page: int = ...,
+    count: Optional[Callable[[], int]] = ...,
+) -> KeysetPage: ...
@@ -0,0 +1,72 @@
+"""
+Streaming responses that stay streamed under ASGI.
+
+Django serves a StreamingHttpResponse (FileResponse included) over ASGI by
+iterating it asynchronously; a synchronous iterator is first read whole
+with ``sync_to_async(list)``, so an export or download served by the
+uvicorn workers would be held in memory until its last byte. stream_async()
+gives ASGI responses an async iterator that pulls one chunk at a time
+through ``sync_to_async`` instead. Each chunk costs a hop to the request's
+sync thread, so the producers hand out large chunks (thousands of rows or
+64 KiB of file). WSGI responses keep their synchronous iterator, and
+FileResponse keeps ``wsgi.file_wrapper`` there.
+"""
+
+from typing import AsyncIterator, Iterable, TypeVar
+
+from asgiref.sync import sync_to_async
+from django.core.handlers.asgi import ASGIRequest
+from django.http import FileResponse, HttpRequest, StreamingHttpResponse
+
+ResponseT = TypeVar('ResponseT', bound=StreamingHttpResponse)
+
+# Block size of FileResponses streamed under ASGI (Django reads 4 KiB)
+ASGI_FILE_BLOCK_SIZE = 64 * 1024
+
+_DONE = object()
+
+
+def is_asgi_request(request: HttpRequest) -> bool:
+    """Check the request is being served by the ASGI handler."""
+    return isinstance(request, ASGIRequest)
+
+
+async def iterate_in_thread(chunks: Iterable[bytes]) -> AsyncIterator[bytes]:
+    """
+    Yield ``chunks`` asynchronously, producing each one in the sync thread.
+
+    The iterator runs thread-sensitively, so database cursors and open
+    files it holds are always used from the same thread; it is closed when
+    the client goes away.
+    """
+    iterator = iter(chunks)
+    next_chunk = sync_to_async(next, thread_sensitive=True)
+    try:
+        while True:
+            chunk = await next_chunk(iterator, _DONE)
+            if chunk is _DONE:
+                return
+            yield chunk
+    finally:
+        close = getattr(iterator, 'close', None)
+        if close is not None:
+            await sync_to_async(close, thread_sensitive=True)()
+
+
+def stream_async(request: HttpRequest, response: ResponseT) -> ResponseT:
+    """
+    Make a streaming response stream chunk by chunk under ASGI.
+
+    Args:
+        request: The request being answered
+        response: A StreamingHttpResponse or FileResponse over a sync iterator
+
+    Returns:
+        The same response; under ASGI its content is an async iterator
+    """
+    if is_asgi_request(request) and not response.is_async:
+        if isinstance(response, FileResponse):
+            # Read lazily per block, so this applies to the wrapped file
+            response.block_size = max(response.block_size, ASGI_FILE_BLOCK_SIZE)
+        response.streaming_content = iterate_in_thread(response.streaming_content)
+    return response
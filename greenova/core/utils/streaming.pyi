@@ -0,0 +1,12 @@
+# Stub file for core.utils.streaming
+from typing import AsyncIterator, Iterable, TypeVar
+
+from django.http import HttpRequest, StreamingHttpResponse
+
+ResponseT = TypeVar('ResponseT', bound=StreamingHttpResponse)
+
+ASGI_FILE_BLOCK_SIZE: int
+
+def is_asgi_request(request: HttpRequest) -> bool: ...
+def iterate_in_thread(chunks: Iterable[bytes]) -> AsyncIterator[bytes]: ...
+def stream_async(request: HttpRequest, response: ResponseT) -> ResponseT: ...
@@ -0,0 +1,259 @@
+"""
+Cheap per-request performance counters.
+
+``core.middleware.ServerTimingMiddleware`` opens a ``RequestTimings`` for
+each request; while it is active, database queries (through an execute
+wrapper installed on every connection as it opens), template rendering (``core.template_backends``), chart
+rendering (``core.utils.chart_cache``) and cache hits/misses
+(``record_cache_access``) add to it. Outside a request every hook is a
+no-op, so jobs and management commands pay nothing. The counters live in
+a context variable, so they follow a request across ``sync_to_async``
+threads under ASGI.
+
+The totals are reported in a ``Server-Timing`` header and, when
+``prometheus_client`` is installed, as Prometheus metrics. Requests slower
+than ``settings.PERFORMANCE_SLOW_REQUEST_MS`` are logged with their slowest
+queries.
+"""
+
+import heapq
+import logging
+import time
+from contextlib import contextmanager
+from contextvars import ContextVar
+from typing import Any, Callable, Dict, Iterator, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+# Spans reported in the Server-Timing header, in this order
+TIMING_SPANS = ('template', 'chart')
+# Slowest statements kept per request, for the slow-request log
+SLOW_QUERY_SAMPLES = 5
+
+_current: ContextVar[Optional['RequestTimings']] = ContextVar(
+    'request_timings', default=None
+)
+
+
+class RequestTimings:
+    """Counters collected while one request is handled."""
+
+    __slots__ = (
+        'started',
+        'db_queries',
+        'db_ms',
+        'spans',
+        'cache_hits',
+        'cache_misses',
+        'slow_queries',
+        '_depth',
+    )
+
+    def __init__(self) -> None:
+        self.started = time.perf_counter()
+        self.db_queries = 0
+        self.db_ms = 0.0
+        self.spans: Dict[str, float] = dict.fromkeys(TIMING_SPANS, 0.0)
+        self.cache_hits = 0
+        self.cache_misses = 0
+        # Min-heap of (ms, sql); only the slowest SLOW_QUERY_SAMPLES survive
+        self.slow_queries: List[Tuple[float, str]] = []
+        self._depth: Dict[str, int] = {}
+
+    @property
+    def total_ms(self) -> float:
+        """Milliseconds since the request started."""
+        return (time.perf_counter() - self.started) * 1000
+
+    def add_query(self, sql: str, ms: float) -> None:
+        """Count one executed statement."""
+        self.db_queries += 1
+        self.db_ms += ms
+        if len(self.slow_queries) < SLOW_QUERY_SAMPLES:
+            heapq.heappush(self.slow_queries, (ms, sql))
+        elif ms > self.slow_queries[0][0]:
+            heapq.heapreplace(self.slow_queries, (ms, sql))
+
+    def server_timing(self) -> str:
+        """Format the counters as a ``Server-Timing`` header value."""
+        metrics = [f'db;dur={self.db_ms:.1f};desc="{self.db_queries} queries"']
+        metrics.extend(
+            f'{name};dur={ms:.1f}' for name, ms in self.spans.items() if ms
+        )
+        if self.cache_hits or self.cache_misses:
+            metrics.append(
+                f'cache;desc="{self.cache_hits} hits, {self.cache_misses} misses"'
+            )
+        metrics.append(f'total;dur={self.total_ms:.1f}')
+        return ', '.join(metrics)
+
+    def summary(self) -> Dict[str, Any]:
+        """Counters as a dict, for logging."""
+        return {
+            'total_ms': round(self.total_ms, 1),
+            'db_queries': self.db_queries,
+            'db_ms': round(self.db_ms, 1),
+            **{f'{name}_ms': round(ms, 1) for name, ms in self.spans.items()},
+            'cache_hits': self.cache_hits,
+            'cache_misses': self.cache_misses,
+        }
+
+
+def current_timings() -> Optional[RequestTimings]:
+    """Return the counters of the request being handled, if any."""
+    return _current.get()
+
+
+@contextmanager
+def request_timings() -> Iterator[RequestTimings]:
+    """Collect counters for the duration of the block."""
+    timings = RequestTimings()
+    token = _current.set(timings)
+    try:
+        yield timings
+    finally:
+        _current.reset(token)
+
+
+@contextmanager
+def timed(span: str) -> Iterator[None]:
+    """
+    Add the time spent in the block to ``span`` of the current request.
+
+    Nested blocks of the same span (a template rendering another) are
+    counted once, by the outermost block.
+    """
+    timings = _current.get()
+    if timings is None or timings._depth.get(span):
+        yield
+        return
+    timings._depth[span] = 1
+    started = time.perf_counter()
+    try:
+        yield
+    finally:
+        timings._depth[span] = 0
+        elapsed = (time.perf_counter() - started) * 1000
+        timings.spans[span] = timings.spans.get(span, 0.0) + elapsed
+
+
+def count_cache_access(hit: bool) -> None:
+    """Count a cache hit or miss against the current request."""
+    timings = _current.get()
+    if timings is None:
+        return
+    if hit:
+        timings.cache_hits += 1
+    else:
+        timings.cache_misses += 1
+
+
+def query_timer(
+    execute: Callable[..., Any], sql: str, params: Any, many: bool, context: Any
+) -> Any:
+    """Connection execute wrapper timing every statement of the request."""
+    timings = _current.get()
+    if timings is None:
+        return execute(sql, params, many, context)
+    started = time.perf_counter()
+    try:
+        return execute(sql, params, many, context)
+    finally:
+        timings.add_query(sql, (time.perf_counter() - started) * 1000)
+
+
+def _install_query_timer(sender: Any, connection: Any, **kwargs: Any) -> None:
+    if query_timer not in connection.execute_wrappers:
+        connection.execute_wrappers.append(query_timer)
+
+
+def connect_query_timer() -> None:
+    """Time the queries of every connection opened from now on."""
+    # pylint: disable=import-outside-toplevel
+    from django.db import connections
+    from django.db.backends.signals import connection_created
+
+    connection_created.connect(
+        _install_query_timer, dispatch_uid='core.utils.timing.query_timer'
+    )
+    for connection in connections.all(initialized_only=True):
+        _install_query_timer(None, connection)
+
+
+class _PrometheusMetrics:
+    """Prometheus collectors, created only if prometheus_client is present."""
+
+    def __init__(self) -> None:
+        # pylint: disable=import-outside-toplevel
+        from prometheus_client import Counter, Histogram
+
+        self.duration = Histogram(
+            'greenova_request_duration_seconds',
+            'Time to handle a request',
+            ['view', 'method', 'status'],
+        )
+        self.db_queries = Histogram(
+            'greenova_request_db_queries',
+            'Database queries per request',
+            ['view'],
+            buckets=(0, 1, 2, 5, 10, 20, 50, 100, 200),
+        )
+        self.db_duration = Histogram(
+            'greenova_request_db_seconds',
+            'Database time per request',
+            ['view'],
+        )
+        self.span_duration = Histogram(
+            'greenova_request_span_seconds',
+            'Template and chart rendering time per request',
+            ['view', 'span'],
+        )
+        self.cache_accesses = Counter(
+            'greenova_cache_accesses',
+            'Cache lookups made while handling requests',
+            ['view', 'outcome'],
+        )
+
+    def observe(
+        self, timings: RequestTimings, view: str, method: str, status: int
+    ) -> None:
+        self.duration.labels(view, method, str(status)).observe(
+            timings.total_ms / 1000
+        )
+        self.db_queries.labels(view).observe(timings.db_queries)
+        self.db_duration.labels(view).observe(timings.db_ms / 1000)
+        for span, ms in timings.spans.items():
+            if ms:
+                self.span_duration.labels(view, span).observe(ms / 1000)
+        if timings.cache_hits:
+            self.cache_accesses.labels(view, 'hit').inc(timings.cache_hits)
+        if timings.cache_misses:
+            self.cache_accesses.labels(view, 'miss').inc(timings.cache_misses)
+
+
+_prometheus: Optional[_PrometheusMetrics] = None
+_prometheus_checked = False
+
+
+def prometheus_metrics() -> Optional[_PrometheusMetrics]:
+    """Return the Prometheus collectors, or None without prometheus_client."""
+    global _prometheus, _prometheus_checked  # pylint: disable=global-statement
+    if not _prometheus_checked:
+        _prometheus_checked = True
+        try:
+            _prometheus = _PrometheusMetrics()
+        except ImportError:
+            logger.debug('prometheus_client not installed; metrics disabled')
+    return _prometheus
+
+
+def log_slow_request(timings: RequestTimings, method: str, path: str) -> None:
+    """Log the counters and the slowest statements of a slow request."""
+    queries = sorted(timings.slow_queries, reverse=True)
+    logger.warning(
+        'Slow request %s %s: %s; slowest queries: %s',
+        method,
+        path,
+        timings.summary(),
+        [f'{ms:.1f}ms {sql[:200]}' for ms, sql in queries],
+    )
@@ -0,0 +1,36 @@
+# Stub file for core.utils.timing
+from typing import Any, Callable, ContextManager, Dict, List, Optional, Tuple
+
+TIMING_SPANS: Tuple[str, ...]
+SLOW_QUERY_SAMPLES: int
+
+class RequestTimings:
+    started: float
+    db_queries: int
+    db_ms: float
+    spans: Dict[str, float]
+    cache_hits: int
+    cache_misses: int
+    slow_queries: List[Tuple[float, str]]
+    def __init__(self) -> None: ...
+    @property
+    def total_ms(self) -> float: ...
+    def add_query(self, sql: str, ms: float) -> None: ...
+    def server_timing(self) -> str: ...
+    def summary(self) -> Dict[str, Any]: ...
+
+class _PrometheusMetrics:
+    def observe(
+        self, timings: RequestTimings, view: str, method: str, status: int
+    ) -> None: ...
+
+def current_timings() -> Optional[RequestTimings]: ...
+def request_timings() -> ContextManager[RequestTimings]: ...
+def timed(span: str) -> ContextManager[None]: ...
+def count_cache_access(hit: bool) -> None: ...
+def query_timer(
+    execute: Callable[..., Any], sql: str, params: Any, many: bool, context: Any
+) -> Any: ...
+def connect_query_timer() -> None: ...
+def prometheus_metrics() -> Optional[_PrometheusMetrics]: ...
+def log_slow_request(timings: RequestTimings, method: str, path: str) -> None: ...
@@ -1,9 +1,10 @@
+import hmac
 import logging
 import os
 from typing import Any
 
 from django.conf import settings
-from django.http import HttpRequest, HttpResponse, JsonResponse
+from django.http import Http404, HttpRequest, HttpResponse, JsonResponse
 from django.shortcuts import redirect
 from django.views.generic import TemplateView, View
 
@@ -40,6 +41,46 @@ def get(self, request: HttpRequest) -> JsonResponse:  # pylint: disable=unused-a
         )
 
 
+class MetricsView(View):
+    """
+    Prometheus scrape endpoint for the counters of ``core.utils.timing``.
+
+    Staff users may read it; scrapers send ``Authorization: Bearer
+    <settings.METRICS_TOKEN>``. Answers 404 when prometheus_client is not
+    installed. Under several gunicorn workers, set PROMETHEUS_MULTIPROC_DIR
+    so every worker's samples are merged.
+    """
+
+    def get(self, request: HttpRequest) -> HttpResponse:
+        """Return the metrics in the Prometheus text format."""
+        token = getattr(settings, "METRICS_TOKEN", "")
+        supplied = request.headers.get("Authorization", "").removeprefix("Bearer ")
+        allowed = getattr(request.user, "is_staff", False) or (
+            token and hmac.compare_digest(supplied, token)
+        )
+        if not allowed:
+            return HttpResponse(status=403)
+
+        try:
+            # pylint: disable=import-outside-toplevel
+            from prometheus_client import (
+                CONTENT_TYPE_LATEST,
+                CollectorRegistry,
+                generate_latest,
+                multiprocess,
+            )
+        except ImportError as e:
+            raise Http404("prometheus_client is not installed") from e
+
+        if os.environ.get("PROMETHEUS_MULTIPROC_DIR"):
+            registry = CollectorRegistry()
+            multiprocess.MultiProcessCollector(registry)
+            data = generate_latest(registry)
+        else:
+            data = generate_latest()
+        return HttpResponse(data, content_type=CONTENT_TYPE_LATEST)
+
+
 class BaseTemplateView(TemplateView):
     """Base view with common template context."""
 
@@ -4,3 +4,8 @@
 class DashboardConfig(AppConfig):
     default_auto_field = "django.db.models.BigAutoField"
     name = "dashboard"
+
+    def ready(self):
+        """Connect dashboard signal handlers."""
+        # pylint: disable=import-outside-toplevel,unused-import
+        from . import signals  # noqa: F401
@@ -0,0 +1,61 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""
+WebSocket consumers for the dashboard application.
+
+DashboardConsumer streams the deltas built by dashboard.live to members
+of the project whose dashboard is open, and to staff, who may select any
+project (see core.middleware.can_select_project).
+"""
+
+import logging
+from typing import Any
+
+from channels.db import database_sync_to_async
+from channels.generic.websocket import AsyncJsonWebsocketConsumer
+from projects.models import Project
+
+from .live import dashboard_group
+
+logger = logging.getLogger(__name__)
+
+# Close code sent to users who may not watch the project
+CLOSE_FORBIDDEN = 4403
+
+
+class DashboardConsumer(AsyncJsonWebsocketConsumer):
+    """Push one project's dashboard changes to a permitted user's browser."""
+
+    group_name: str | None = None
+
+    async def connect(self) -> None:
+        """Join the project's group if the user may view the project."""
+        user = self.scope.get("user")
+        project_id = self.scope["url_route"]["kwargs"]["project_id"]
+        if not getattr(user, "is_authenticated", False) or not (
+            await self.can_watch(user, project_id)
+        ):
+            await self.close(code=CLOSE_FORBIDDEN)
+            return
+        self.group_name = dashboard_group(project_id)
+        await self.channel_layer.group_add(self.group_name, self.channel_name)
+        await self.accept()
+        logger.debug("User %s watching dashboard of project %s", user.pk, project_id)
+
+    async def disconnect(self, code: int) -> None:
+        """Leave the project's group."""
+        if self.group_name:
+            await self.channel_layer.group_discard(self.group_name, self.channel_name)
+
+    async def dashboard_update(self, event: dict[str, Any]) -> None:
+        """Forward a ``dashboard.update`` group message to the browser."""
+        await self.send_json(event["delta"])
+
+    @database_sync_to_async
+    def can_watch(self, user: Any, project_id: int) -> bool:
+        """Check the user is staff or a member of the project."""
+        projects = Project.objects.filter(pk=project_id)
+        if not (user.is_staff or user.is_superuser):
+            projects = projects.filter(members=user)
+        return projects.exists()
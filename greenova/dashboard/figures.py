@@ -8,25 +8,62 @@
 used in the dashboard views and components.
 """
 
-import io
 import logging
+from typing import TYPE_CHECKING, Any, Callable
 
-import matplotlib
-import matplotlib.pyplot as plt
+from core.utils.chart_cache import ChartSpec
 from django.db.models import Count
+from django.http import Http404, QueryDict
+from django.shortcuts import get_object_or_404
+from mechanisms.figures import get_mechanism_chart_spec, get_overall_chart_spec
+from mechanisms.models import EnvironmentalMechanism
 from obligations.models import Obligation
+from procedures.figures import get_procedure_chart_spec, get_procedure_status_counts
+from procedures.filters import apply_obligation_filters
+from projects.models import get_project_roles
+from responsibility.figures import get_responsibility_chart_spec
 
-# Configure matplotlib for non-interactive backend to avoid GUI requirements
-matplotlib.use("Agg")
+if TYPE_CHECKING:
+    from matplotlib.figure import Figure
 
 # Set up logger
 logger = logging.getLogger(__name__)
 
 
-def create_obligations_status_chart(
-    project_id: int | None = None,
-) -> tuple[plt.Figure, bytes]:
-    """Create a pie chart of obligation statuses."""
+def _draw_status_chart(labels: list[str], sizes: list[int]) -> "Figure":
+    """Draw the obligation status pie chart."""
+    # Loaded on the first render so workers start without matplotlib
+    # pylint: disable=import-outside-toplevel
+    from matplotlib.figure import Figure
+
+    fig = Figure()
+    ax = fig.add_subplot(111)
+    if sizes:
+        ax.pie(sizes, labels=labels, autopct="%1.1f%%")
+    else:
+        ax.text(0.5, 0.5, "No data", ha="center", va="center")
+    ax.set_title("Obligation Status Distribution")
+    return fig
+
+
+def _draw_placeholder_chart(text: str) -> "Figure":
+    """Draw a blank chart carrying a single caption."""
+    # pylint: disable=import-outside-toplevel
+    from matplotlib.figure import Figure
+
+    fig = Figure()
+    ax = fig.add_subplot(111)
+    ax.text(0.5, 0.5, text, ha="center", va="center")
+    return fig
+
+
+def _placeholder_series(title: str) -> dict:
+    """Series for a chart that has no data yet."""
+    return {"type": "pie", "title": title, "labels": [], "values": []}
+
+
+def obligations_status_chart_spec(project_id: int | None = None) -> ChartSpec:
+    """Describe the pie chart of obligation statuses."""
     filters = {}
     if project_id:
         filters["project_id"] = project_id
@@ -42,48 +79,158 @@ def create_obligations_status_chart(
     labels = [item["status"] for item in status_counts]
     sizes = [item["count"] for item in status_counts]
 
-    fig, ax = plt.subplots()
-    if sizes:
-        ax.pie(sizes, labels=labels, autopct="%1.1f%%")
-    else:
-        ax.text(0.5, 0.5, "No data", ha="center", va="center")
-    ax.set_title("Obligation Status Distribution")
+    # Only the counts are hashed, so projects with identical data share a PNG
+    return ChartSpec(
+        "obligation_status",
+        {"labels": labels, "sizes": sizes},
+        lambda: _draw_status_chart(labels, sizes),
+        series={
+            "type": "pie",
+            "title": "Obligation Status Distribution",
+            "labels": labels,
+            "values": sizes,
+        },
+    )
+
+
+def timeline_chart_spec(project_id: int | None = None) -> ChartSpec:
+    """Stub: Describes a blank chart for timeline."""
+    return ChartSpec(
+        "timeline",
+        None,
+        lambda: _draw_placeholder_chart("Timeline Chart"),
+        series=_placeholder_series("Timeline Chart"),
+    )
+
+
+def project_compliance_chart_spec(project_id: int | None = None) -> ChartSpec:
+    """Stub: Describes a blank chart for project compliance."""
+    return ChartSpec(
+        "project_compliance",
+        None,
+        lambda: _draw_placeholder_chart("Project Compliance Chart"),
+        series=_placeholder_series("Project Compliance Chart"),
+    )
+
+
+def _mechanism_chart_spec(mechanism_id: int, params: QueryDict) -> ChartSpec:
+    mechanism = get_object_or_404(EnvironmentalMechanism, pk=mechanism_id)
+    return get_mechanism_chart_spec(mechanism)
 
-    buf = io.BytesIO()
-    fig.savefig(buf, format="png")
-    plt.close(fig)
-    buf.seek(0)
-    return fig, buf.getvalue()
-
-
-def create_obligations_status_chart_svg(project_id=None):
-    """Create an SVG chart of obligation statuses."""
-    fig, ax = plt.subplots()
-    ax.text(0.5, 0.5, "Obligations Status Chart", ha="center", va="center")
-    buf = io.BytesIO()
-    fig.savefig(buf, format="svg")
-    plt.close(fig)
-    buf.seek(0)
-    return buf.getvalue().decode("utf-8")
-
-
-def create_timeline_chart(project_id: int | None = None) -> tuple[plt.Figure, bytes]:
-    """Stub: Returns a blank chart for timeline."""
-    fig, ax = plt.subplots()
-    ax.text(0.5, 0.5, "Timeline Chart", ha="center", va="center")
-    buf = io.BytesIO()
-    fig.savefig(buf, format="png")
-    plt.close(fig)
-    buf.seek(0)
-    return fig, buf.getvalue()
-
-
-def create_project_compliance_chart(projects) -> tuple[plt.Figure, bytes]:
-    """Stub: Returns a blank chart for project compliance."""
-    fig, ax = plt.subplots()
-    ax.text(0.5, 0.5, "Project Compliance Chart", ha="center", va="center")
-    buf = io.BytesIO()
-    fig.savefig(buf, format="png")
-    plt.close(fig)
-    buf.seek(0)
-    return fig, buf.getvalue()
+
+def _filtered_obligation_ids(mechanism_id: int, params: QueryDict):
+    """Obligation pks matching the procedure page filters, or None if unfiltered."""
+    obligations = Obligation.objects.filter(
+        primary_environmental_mechanism_id=mechanism_id
+    )
+    filtered, filter_params = apply_obligation_filters(obligations, params)
+    if not filter_params["filters_applied"]:
+        return None
+    return filtered.values_list("pk", flat=True)
+
+
+def _responsibility_chart_spec(mechanism_id: int, params: QueryDict) -> ChartSpec:
+    return get_responsibility_chart_spec(
+        mechanism_id, filtered_ids=_filtered_obligation_ids(mechanism_id, params)
+    )
+
+
+def _procedure_chart_spec(mechanism_id: int, params: QueryDict) -> ChartSpec:
+    procedure = params.get("procedure")
+    if not procedure:
+        raise Http404("No procedure given")
+    counts = get_procedure_status_counts(
+        mechanism_id,
+        filtered_ids=_filtered_obligation_ids(mechanism_id, params),
+        procedure=procedure,
+    )
+    if procedure not in counts:
+        raise Http404(f"No obligations for procedure {procedure}")
+    return get_procedure_chart_spec(procedure, counts[procedure])
+
+
+# Chart kinds served by dashboard:chart_image. Each builder takes the object
+# id from the URL (a project or mechanism; 0 means "all") and the query string.
+CHART_SPEC_BUILDERS: dict[str, Callable[[int, QueryDict], ChartSpec]] = {
+    "obligation-status": lambda project_id, params: obligations_status_chart_spec(
+        project_id
+    ),
+    "timeline": lambda project_id, params: timeline_chart_spec(project_id),
+    "compliance": lambda project_id, params: project_compliance_chart_spec(
+        project_id
+    ),
+    "mechanism": _mechanism_chart_spec,
+    "mechanism-overall": lambda project_id, params: get_overall_chart_spec(
+        project_id
+    ),
+    "responsibility": _responsibility_chart_spec,
+    "procedure": _procedure_chart_spec,
+}
+
+
+# Chart kinds whose object id is a mechanism rather than a project
+MECHANISM_CHART_KINDS = frozenset({"mechanism", "responsibility", "procedure"})
+# Placeholder charts that plot no project data
+UNSCOPED_CHART_KINDS = frozenset({"timeline", "compliance"})
+
+
+def chart_project_id(kind: str, object_id: int) -> int | None:
+    """
+    Return the project a chart plots, or None for the all-projects charts.
+
+    Raises:
+        Http404: If a mechanism chart names a mechanism that does not exist
+    """
+    if kind not in MECHANISM_CHART_KINDS:
+        return object_id or None
+    project_id = (
+        EnvironmentalMechanism.objects.filter(pk=object_id)
+        .values_list("project_id", flat=True)
+        .first()
+    )
+    if project_id is None:
+        raise Http404(f"No mechanism {object_id}")
+    return project_id
+
+
+def check_chart_access(user: Any, kind: str, object_id: int) -> None:
+    """
+    Allow project members to see their projects' charts.
+
+    Superusers see every chart; the all-projects charts (object id 0) need
+    staff. Membership comes from the user's per-request roles map.
+
+    Raises:
+        Http404: If the user may not see the chart; existence is not leaked
+    """
+    if kind in UNSCOPED_CHART_KINDS or getattr(user, "is_superuser", False):
+        return
+    project_id = chart_project_id(kind, object_id)
+    if project_id is None:
+        if not getattr(user, "is_staff", False):
+            raise Http404("Chart not found")
+    elif project_id not in get_project_roles(user):
+        raise Http404("Chart not found")
+
+
+def get_chart_spec(
+    kind: str, object_id: int, params: QueryDict, user: Any
+) -> ChartSpec:
+    """
+    Build the spec for a chart requested by URL.
+
+    Args:
+        kind: Chart kind registered in CHART_SPEC_BUILDERS
+        object_id: Project or mechanism id from the URL (0 means "all")
+        params: The request's query string
+        user: The requesting user; the chart must belong to their projects
+
+    Raises:
+        Http404: If the chart kind or the object it plots does not exist, or
+            the user may not see it
+    """
+    builder = CHART_SPEC_BUILDERS.get(kind)
+    if builder is None:
+        raise Http404(f"Unknown chart: {kind}")
+    check_chart_access(user, kind, object_id)
+    return builder(object_id, params)
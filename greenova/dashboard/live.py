@@ -0,0 +1,158 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""
+Live dashboard updates pushed over WebSockets.
+
+Each project has a channel-layer group that DashboardConsumer joins for
+members viewing that project's dashboard. When an obligation or mechanism
+change commits, a ``dashboard.push`` background job is queued for the
+project (and obligation); the job sends each project one delta per run:
+the summary card numbers from its stats snapshot and the rendered status
+and due date of every changed row. Open dashboards patch themselves in
+place (static/js/modules/live-dashboard.js).
+
+Queued keys are deduplicated and handled together, so a burst of saves
+costs one snapshot refresh and one message per project, and none of it
+runs in the request. Pushes are off unless ``DASHBOARD_LIVE_UPDATES`` is
+set, which defaults to on only with a Redis channel layer: the in-memory
+layer cannot reach sockets held by other workers. Without the channels
+package they stay off and the dashboard renders as before.
+"""
+
+import logging
+from typing import Any, Dict, Iterable, List
+
+from asgiref.sync import async_to_sync
+from core.jobs import enqueue_job, register_job
+from django.conf import settings
+from obligations.models import Obligation
+from obligations.templatetags.obligation_tags import display_status, format_due_date
+
+from .models import get_project_stats, summarize_project_stats
+
+try:
+    from channels.layers import get_channel_layer
+except ImportError:  # pragma: no cover - channels is an optional dependency
+    get_channel_layer = None
+
+logger = logging.getLogger(__name__)
+
+DASHBOARD_GROUP_PREFIX = "dashboard.project"
+DASHBOARD_UPDATE_EVENT = "dashboard.update"
+DASHBOARD_PUSH_JOB = "dashboard.push"
+LIVE_DASHBOARD_ROUTE = "ws/dashboard/"
+# Snapshot numbers shown on the summary cards (data-live-stat attributes)
+LIVE_STATS_FIELDS = (
+    "overdue_count",
+    "active_count",
+    "upcoming_count",
+    "active_mechanisms_count",
+)
+
+
+def dashboard_group(project_id: Any) -> str:
+    """Return the channel-layer group of a project's dashboards."""
+    return f"{DASHBOARD_GROUP_PREFIX}.{int(project_id)}"
+
+
+def live_dashboard_path(project_id: Any) -> str:
+    """Return the WebSocket path of a project's dashboard (see routing.py)."""
+    return f"/{LIVE_DASHBOARD_ROUTE}{int(project_id)}/"
+
+
+def live_updates_enabled() -> bool:
+    """Check pushes are on (settings.DASHBOARD_LIVE_UPDATES) and a layer exists."""
+    if not getattr(settings, "DASHBOARD_LIVE_UPDATES", False):
+        return False
+    return get_channel_layer is not None and get_channel_layer() is not None
+
+
+def obligation_row(obligation: Any) -> dict[str, Any]:
+    """Describe one obligation table row as the dashboard shows it."""
+    return {
+        "obligation_number": obligation.obligation_number,
+        "deleted": False,
+        "status_html": str(display_status(obligation)),
+        "due_date_html": str(format_due_date(obligation.action_due_date)),
+    }
+
+
+def push_key(project_id: Any, obligation_number: str = "") -> str:
+    """Return the dashboard.push job key of a project's (obligation's) change."""
+    return f"{int(project_id)}:{obligation_number}"
+
+
+def request_dashboard_push(project_id: Any, obligation: Any = None) -> None:
+    """Queue a push of a committed change to the project's dashboards."""
+    number = obligation.obligation_number if obligation is not None else ""
+    enqueue_job(DASHBOARD_PUSH_JOB, push_key(project_id, number))
+
+
+def build_dashboard_deltas(keys: Iterable[str]) -> Dict[int, Dict[str, Any]]:
+    """
+    Return the delta for each project with changes among ``keys``.
+
+    Args:
+        keys: dashboard.push job keys (see push_key())
+
+    Returns:
+        dict: Project id to its delta: ``project_id``, ``stats`` and
+        ``obligations``, one obligation_row() per changed obligation (rows
+        no longer in the project are sent as deleted)
+    """
+    changed: Dict[int, set] = {}
+    for key in keys:
+        project_id, _, number = key.partition(":")
+        numbers = changed.setdefault(int(project_id), set())
+        if number:
+            numbers.add(number)
+
+    snapshots = get_project_stats(list(changed))
+    current: Dict[tuple, Any] = {
+        (obligation.project_id, obligation.pk): obligation
+        for obligation in Obligation.objects.filter(
+            project_id__in=list(changed),
+            pk__in={number for numbers in changed.values() for number in numbers},
+        )
+    }
+    deltas = {}
+    for project_id, numbers in changed.items():
+        snapshot = snapshots.get(project_id)
+        stats = summarize_project_stats([snapshot] if snapshot else [])
+        rows: List[Dict[str, Any]] = []
+        for number in sorted(numbers):
+            obligation = current.get((project_id, number))
+            if obligation is None:
+                rows.append({"obligation_number": number, "deleted": True})
+            else:
+                rows.append(obligation_row(obligation))
+        deltas[project_id] = {
+            "project_id": project_id,
+            "stats": {field: stats[field] for field in LIVE_STATS_FIELDS},
+            "obligations": rows,
+        }
+    return deltas
+
+
+@register_job(DASHBOARD_PUSH_JOB)
+def push_dashboard_updates(keys: List[str]) -> None:
+    """
+    Send each changed project's dashboards one delta.
+
+    Failures are logged, never raised: the changes are already saved and
+    dashboards still show them on their next load.
+    """
+    if not live_updates_enabled():
+        return
+    channel_layer = get_channel_layer()
+    for project_id, delta in build_dashboard_deltas(keys).items():
+        try:
+            async_to_sync(channel_layer.group_send)(
+                dashboard_group(project_id),
+                {"type": DASHBOARD_UPDATE_EVENT, "delta": delta},
+            )
+        except Exception as e:
+            logger.exception(
+                "Error pushing dashboard update for %s: %s", project_id, e
+            )
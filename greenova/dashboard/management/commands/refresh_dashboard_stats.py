@@ -0,0 +1,36 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""
+Management command to recompute the per-project dashboard snapshots.
+
+Snapshots are recomputed lazily when they go stale or the day changes;
+scheduling this shortly after midnight keeps the first dashboard read of the
+day a plain lookup.
+"""
+
+from dashboard.models import refresh_project_stats
+from django.core.management.base import BaseCommand
+from projects.models import Project
+
+
+class Command(BaseCommand):
+    help = 'Recompute dashboard statistics snapshots for all or some projects'
+
+    def add_arguments(self, parser):
+        parser.add_argument(
+            '--project',
+            action='append',
+            type=int,
+            dest='project_ids',
+            help='Project id to refresh (repeatable). Default: all projects'
+        )
+
+    def handle(self, *args, **options):
+        projects = Project.objects.all()
+        if options['project_ids']:
+            projects = projects.filter(pk__in=options['project_ids'])
+        refreshed = refresh_project_stats(projects.values_list('pk', flat=True))
+        self.stdout.write(
+            self.style.SUCCESS(f'Refreshed dashboard stats for {len(refreshed)} projects')
+        )
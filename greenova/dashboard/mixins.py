@@ -8,22 +8,16 @@
 dashboard-specific functionality and context data.
 """
 
-import base64
 import logging
 from typing import Any
 
 from core.mixins import BreadcrumbMixin, PageTitleMixin
+from core.utils.chart_cache import chart_url
 from django.contrib.auth.mixins import LoginRequiredMixin
 from django.db.models import Count
 from django.utils import timezone
 from projects.models import Project
 
-from .figures import (
-    create_obligations_status_chart,
-    create_project_compliance_chart,
-    create_timeline_chart,
-)
-
 logger = logging.getLogger(__name__)
 
 
@@ -105,30 +99,13 @@ def _add_chart_data(self, context: dict[str, Any], project_id: int | None) -> No
             context: The context dictionary to update
             project_id: The current project ID (if any)
         """
-        try:
-            # Generate obligation status chart
-            _, status_chart_data = create_obligations_status_chart(project_id)
-            context["status_chart"] = base64.b64encode(status_chart_data).decode(
-                "utf-8"
-            )
-
-            # Generate timeline chart
-            _, timeline_chart_data = create_timeline_chart(project_id)
-            context["timeline_chart"] = base64.b64encode(timeline_chart_data).decode(
-                "utf-8"
-            )
+        # Charts load from the chart image endpoint; only their URLs go here
+        context["status_chart_url"] = chart_url("obligation-status", project_id)
+        context["timeline_chart_url"] = chart_url("timeline", project_id)
 
-            # Generate project compliance chart if no specific project is selected
-            if not project_id:
-                projects = self._get_user_projects()
-                _, compliance_chart_data = create_project_compliance_chart(projects)
-                context["compliance_chart"] = base64.b64encode(
-                    compliance_chart_data
-                ).decode("utf-8")
-
-        except Exception as e:
-            logger.exception("Error generating chart data: %s", e)
-            context["chart_error"] = str(e)
+        # Add project compliance chart if no specific project is selected
+        if not project_id:
+            context["compliance_chart_url"] = chart_url("compliance")
 
     def _add_statistics(self, context: dict[str, Any], project_id: int | None) -> None:
         """
@@ -0,0 +1,247 @@
+"""Materialized statistics backing the dashboard summary cards.
+
+``ProjectDashboardStats`` keeps one row of headline numbers per project so
+the dashboard home reads them by primary key instead of counting obligations
+on every request. Rows are computed by one grouped aggregate query, marked
+stale from the ``dashboard_data_updated`` signal and recomputed on the next
+read; counts relative to today are also recomputed once the day rolls over,
+or ahead of time by ``manage.py refresh_dashboard_stats``.
+
+Changes mark a snapshot stale once they commit, and each mark bumps its
+``version``. A refresh stores its counts only if the version is still the
+one it read before counting, so a read racing a change cannot overwrite
+the mark with numbers from before that change.
+"""
+
+import logging
+from datetime import date, timedelta
+from typing import Any, Iterable
+
+from dateutil.relativedelta import relativedelta
+from django.db import models
+from django.db.models import Count, F, Q
+from django.utils import timezone
+from obligations.constants import STATUS_COMPLETED
+from obligations.utils import overdue_q
+
+logger = logging.getLogger(__name__)
+
+UPCOMING_DAYS = 7
+
+# Counter fields computed by project_stats_aggregates()
+STATS_FIELDS = (
+    "total_count",
+    "active_count",
+    "completed_count",
+    "overdue_count",
+    "upcoming_count",
+    "active_month_ago_count",
+    "active_mechanisms_count",
+)
+
+
+class ProjectDashboardStats(models.Model):
+    """Snapshot of a project's dashboard numbers as of one day."""
+
+    project: Any = models.OneToOneField(
+        "projects.Project",
+        on_delete=models.CASCADE,
+        primary_key=True,
+        related_name="dashboard_stats",
+    )
+    total_count: Any = models.PositiveIntegerField(default=0)
+    active_count: Any = models.PositiveIntegerField(default=0)
+    completed_count: Any = models.PositiveIntegerField(default=0)
+    overdue_count: Any = models.PositiveIntegerField(default=0)
+    upcoming_count: Any = models.PositiveIntegerField(default=0)
+    # Active obligations that already existed a month before as_of
+    active_month_ago_count: Any = models.PositiveIntegerField(default=0)
+    # Mechanisms with at least one active obligation
+    active_mechanisms_count: Any = models.PositiveIntegerField(default=0)
+    as_of: Any = models.DateField(help_text="Day the date-relative counts refer to")
+    is_stale: Any = models.BooleanField(default=False)
+    # Bumped by every mark_project_stats_stale(); guards refresh writes
+    version: Any = models.PositiveIntegerField(default=0)
+    refreshed_at: Any = models.DateTimeField(auto_now=True)
+
+    class Meta:
+        verbose_name = "Project Dashboard Stats"
+        verbose_name_plural = "Project Dashboard Stats"
+
+    def __str__(self) -> str:
+        return f"Dashboard stats for project {self.project_id} ({self.as_of})"
+
+    def is_current(self, today: date | None = None) -> bool:
+        """Return True if the snapshot can be served for ``today``."""
+        return not self.is_stale and self.as_of == (today or timezone.now().date())
+
+
+def active_obligations_q() -> Q:
+    """Match obligations that still need work."""
+    return ~Q(status=STATUS_COMPLETED)
+
+
+def project_stats_aggregates(today: date) -> dict[str, Count]:
+    """Return the aggregates computing every STATS_FIELDS value in one query."""
+    active = active_obligations_q()
+    return {
+        "total_count": Count("pk"),
+        "active_count": Count("pk", filter=active),
+        "completed_count": Count("pk", filter=Q(status=STATUS_COMPLETED)),
+        "overdue_count": Count("pk", filter=overdue_q(today)),
+        "upcoming_count": Count(
+            "pk",
+            filter=active
+            & Q(
+                action_due_date__gte=today,
+                action_due_date__lte=today + timedelta(days=UPCOMING_DAYS),
+            ),
+        ),
+        "active_month_ago_count": Count(
+            "pk",
+            filter=active & Q(created_at__date__lt=today - relativedelta(months=1)),
+        ),
+        "active_mechanisms_count": Count(
+            "primary_environmental_mechanism", filter=active, distinct=True
+        ),
+    }
+
+
+def refresh_project_stats(
+    project_ids: Iterable[int], today: date | None = None
+) -> dict[int, ProjectDashboardStats]:
+    """
+    Recompute and store the snapshots of the given projects.
+
+    All projects are counted by one grouped aggregate query, whatever their
+    number of obligations. Each snapshot's version is read first (missing
+    snapshots are created stale) and its counts are written only if that
+    version is unchanged; a snapshot marked stale meanwhile stays stale and
+    is recomputed by the next read.
+
+    Args:
+        project_ids: Primary keys of the projects to refresh
+        today: Day the date-relative counts refer to (defaults to today)
+
+    Returns:
+        dict: The refreshed snapshots keyed by project id
+    """
+    from obligations.models import Obligation
+
+    ids = {int(project_id) for project_id in project_ids if project_id}
+    if not ids:
+        return {}
+    today = today or timezone.now().date()
+
+    versions = _snapshot_versions(ids)
+    if len(versions) < len(ids):
+        # Created before counting, so a change committed after the count
+        # finds a row to mark
+        ProjectDashboardStats.objects.bulk_create(
+            [
+                ProjectDashboardStats(project_id=project_id, as_of=today, is_stale=True)
+                for project_id in ids - versions.keys()
+            ],
+            ignore_conflicts=True,
+        )
+        versions = _snapshot_versions(ids)
+
+    rows = {
+        row.pop("project_id"): row
+        for row in Obligation.objects.filter(project_id__in=ids)
+        .order_by()
+        .values("project_id")
+        .annotate(**project_stats_aggregates(today))
+    }
+    now = timezone.now()
+    snapshots = {}
+    for project_id, version in versions.items():
+        counts = rows.get(project_id, dict.fromkeys(STATS_FIELDS, 0))
+        stored = ProjectDashboardStats.objects.filter(
+            project_id=project_id, version=version
+        ).update(as_of=today, is_stale=False, refreshed_at=now, **counts)
+        snapshots[project_id] = ProjectDashboardStats(
+            project_id=project_id,
+            as_of=today,
+            is_stale=not stored,
+            version=version,
+            refreshed_at=now,
+            **counts,
+        )
+    logger.debug("Refreshed dashboard stats for projects %s", sorted(ids))
+    return snapshots
+
+
+def _snapshot_versions(ids: set[int]) -> dict[int, int]:
+    return dict(
+        ProjectDashboardStats.objects.filter(project_id__in=ids).values_list(
+            "project_id", "version"
+        )
+    )
+
+
+def get_project_stats(
+    project_ids: Iterable[int], today: date | None = None
+) -> dict[int, ProjectDashboardStats]:
+    """
+    Return current snapshots for the given projects.
+
+    Snapshots are read with one primary-key lookup; only missing, stale or
+    out-of-date ones are recomputed.
+    """
+    ids = {int(project_id) for project_id in project_ids if project_id}
+    if not ids:
+        return {}
+    today = today or timezone.now().date()
+
+    snapshots = ProjectDashboardStats.objects.in_bulk(ids)
+    outdated = [
+        project_id
+        for project_id in ids
+        if project_id not in snapshots or not snapshots[project_id].is_current(today)
+    ]
+    if outdated:
+        snapshots.update(refresh_project_stats(outdated, today))
+    return snapshots
+
+
+def mark_project_stats_stale(project_ids: Iterable[int]) -> int:
+    """
+    Flag snapshots for recomputation on their next read.
+
+    Call once the change has committed (``transaction.on_commit``): a read
+    between the mark and the commit would store the old counts as current.
+    """
+    ids = {int(project_id) for project_id in project_ids if project_id}
+    if not ids:
+        return 0
+    return ProjectDashboardStats.objects.filter(project_id__in=ids).update(
+        is_stale=True, version=F("version") + 1
+    )
+
+
+def percent_change(current: int, previous: int) -> int:
+    """Return the rounded percentage change from ``previous`` to ``current``."""
+    if not previous:
+        return 100 if current else 0
+    return round((current - previous) / previous * 100)
+
+
+def summarize_project_stats(
+    snapshots: Iterable[ProjectDashboardStats],
+) -> dict[str, int]:
+    """
+    Add up snapshots into the numbers shown on the dashboard cards.
+
+    Returns:
+        dict: Summed STATS_FIELDS values plus ``active_trend``, the
+        month-over-month change of active obligations in percent
+    """
+    totals = dict.fromkeys(STATS_FIELDS, 0)
+    for snapshot in snapshots:
+        for field in STATS_FIELDS:
+            totals[field] += getattr(snapshot, field)
+    totals["active_trend"] = percent_change(
+        totals["active_count"], totals["active_month_ago_count"]
+    )
+    return totals
@@ -0,0 +1,26 @@
+# Stub file for dashboard.models
+from datetime import date
+from typing import Iterable, Optional
+
+from django.db import models
+from django.db.models import Count, Q
+
+UPCOMING_DAYS: int
+STATS_FIELDS: tuple[str, ...]
+
+class ProjectDashboardStats(models.Model):
+    def is_current(self, today: Optional[date] = ...) -> bool: ...
+
+def active_obligations_q() -> Q: ...
+def project_stats_aggregates(today: date) -> dict[str, Count]: ...
+def refresh_project_stats(
+    project_ids: Iterable[int], today: Optional[date] = ...
+) -> dict[int, ProjectDashboardStats]: ...
+def get_project_stats(
+    project_ids: Iterable[int], today: Optional[date] = ...
+) -> dict[int, ProjectDashboardStats]: ...
+def mark_project_stats_stale(project_ids: Iterable[int]) -> int: ...
+def percent_change(current: int, previous: int) -> int: ...
+def summarize_project_stats(
+    snapshots: Iterable[ProjectDashboardStats],
+) -> dict[str, int]: ...
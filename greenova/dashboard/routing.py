@@ -0,0 +1,17 @@
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+"""WebSocket URL routes for the dashboard application."""
+
+from django.urls import path
+
+from .consumers import DashboardConsumer
+from .live import LIVE_DASHBOARD_ROUTE
+
+websocket_urlpatterns = [
+    path(
+        f"{LIVE_DASHBOARD_ROUTE}<int:project_id>/",
+        DashboardConsumer.as_asgi(),
+        name="dashboard_live",
+    ),
+]
@@ -9,14 +9,22 @@
 """
 
 import logging
+from functools import partial
 from typing import Any
 
+from company.models import CompanyMembership
+from core.utils.cache import GLOBAL_SCOPE, invalidate_namespace, project_scope
 from django.contrib.auth.signals import user_logged_in
-from django.db.models.signals import post_save
+from django.db import transaction
+from django.db.models.signals import post_delete, post_save
 from django.dispatch import Signal, receiver
 from django.http import HttpRequest
+from mechanisms.models import COUNT_FIELDS, EnvironmentalMechanism
 from obligations.models import Obligation
-from projects.models import Project
+from projects.models import Project, ProjectMembership
+
+from .live import live_updates_enabled, request_dashboard_push
+from .models import mark_project_stats_stale
 
 logger = logging.getLogger(__name__)
 
@@ -74,8 +82,12 @@ def restore_dashboard_state(
     # Check if user had a previously selected project
     try:
         # Try to get the user's last accessed project
+        # Projects have no access timestamp; use the most recently touched
+        # membership instead
         last_project = (
-            Project.objects.filter(members=user).order_by("-last_accessed").first()
+            Project.objects.filter(memberships__user=user)
+            .order_by("-memberships__updated_at")
+            .first()
         )
 
         if last_project:
@@ -90,24 +102,147 @@ def restore_dashboard_state(
 
 
 @receiver(post_save, sender=Obligation)
+@receiver(post_delete, sender=Obligation)
 def update_dashboard_data(
     sender: Any, instance: Obligation, **kwargs: dict[str, Any]
 ) -> None:
     """
-    Signal handler to update dashboard data when obligations change.
+    Signal handler to update dashboard data when obligations change or are deleted.
+
+    An obligation moved to another project is signalled for the project it
+    left as well, so that dashboard stops counting and showing it.
 
     Args:
         sender: The model class sending the signal
         instance: The Obligation instance that was saved
         **kwargs: Additional keyword arguments
     """
-    # This currently just logs the event
-    # In a real-time application, this might trigger WebSocket updates
-    logger.debug("Dashboard data updated due to change in obligation %s", instance.id)
+    logger.debug("Dashboard data updated due to change in obligation %s", instance.pk)
+
+    project_id = instance.project_id if hasattr(instance, "project") else None
+    previous_project_id = instance.get_original_value("project_id")
+    for changed_project_id in dict.fromkeys((project_id, previous_project_id)):
+        # Send the custom signal
+        dashboard_data_updated.send(
+            sender=sender,
+            obligation_id=instance.pk,
+            project_id=changed_project_id,
+            obligation=instance,
+        )
+
+
+@receiver(post_save, sender=EnvironmentalMechanism)
+@receiver(post_delete, sender=EnvironmentalMechanism)
+def update_dashboard_data_for_mechanism(
+    sender: Any, instance: EnvironmentalMechanism, **kwargs: Any
+) -> None:
+    """
+    Retire cached data showing a mechanism that was renamed or deleted.
+
+    Saves that only store recomputed counters are skipped: the obligation
+    change behind them has already been signalled.
 
-    # Send the custom signal
+    Args:
+        sender: The model class sending the signal
+        instance: The EnvironmentalMechanism instance that changed
+        **kwargs: Additional keyword arguments
+    """
+    update_fields = kwargs.get("update_fields")
+    if update_fields and set(update_fields) <= {*COUNT_FIELDS, "updated_at"}:
+        return
     dashboard_data_updated.send(
-        sender=sender,
-        obligation_id=instance.id,
-        project_id=instance.project_id if hasattr(instance, "project") else None,
+        sender=sender, obligation_id=None, project_id=instance.project_id
     )
+
+
+@receiver(post_save, sender=CompanyMembership)
+@receiver(post_delete, sender=CompanyMembership)
+@receiver(post_save, sender=ProjectMembership)
+@receiver(post_delete, sender=ProjectMembership)
+def update_dashboard_data_for_membership(
+    sender: Any, instance: Any, **kwargs: Any
+) -> None:
+    """
+    Retire cached summaries that depend on the user's memberships.
+
+    Without a mechanism, the obligation summary lists the overdue obligations
+    matching the user's company roles in the user's projects. It is cached
+    per user in the global scope, so a membership change retires that scope.
+
+    Args:
+        sender: The model class sending the signal
+        instance: The CompanyMembership or ProjectMembership that changed
+        **kwargs: Additional keyword arguments
+    """
+    dashboard_data_updated.send(sender=sender, obligation_id=None, project_id=None)
+
+
+@receiver(dashboard_data_updated)
+def invalidate_dashboard_cache(
+    sender: Any, project_id: Any = None, **kwargs: dict[str, Any]
+) -> None:
+    """
+    Retire cached dashboard data for the project whose data changed.
+
+    The global scope holds the cross-project figures shown when no project
+    is selected, so it is invalidated on every change. The namespaces are
+    retired once the change commits: a read racing the writer would
+    otherwise cache the pre-commit rows under the new version.
+
+    Args:
+        sender: The object sending the signal
+        project_id: The project whose data changed, if known
+        **kwargs: Additional keyword arguments
+    """
+    transaction.on_commit(partial(retire_dashboard_namespaces, project_id))
+
+
+def retire_dashboard_namespaces(project_id: Any = None) -> None:
+    """Bump the cache namespaces of a project and the global dashboard."""
+    if project_id:
+        invalidate_namespace(project_scope(project_id))
+    invalidate_namespace(GLOBAL_SCOPE)
+
+
+@receiver(dashboard_data_updated)
+def mark_dashboard_stats_stale(
+    sender: Any, project_id: Any = None, **kwargs: dict[str, Any]
+) -> None:
+    """
+    Flag the changed project's dashboard snapshot for recomputation.
+
+    The snapshot is marked once the change commits and recomputed by the
+    next dashboard read, so a burst of obligation changes costs one
+    aggregate query instead of one per change.
+
+    Args:
+        sender: The object sending the signal
+        project_id: The project whose data changed, if known
+        **kwargs: Additional keyword arguments
+    """
+    if project_id:
+        transaction.on_commit(partial(mark_project_stats_stale, [project_id]))
+
+
+@receiver(dashboard_data_updated)
+def push_live_dashboard_update(
+    sender: Any,
+    project_id: Any = None,
+    obligation: Obligation | None = None,
+    **kwargs: Any,
+) -> None:
+    """
+    Queue a push of the change to the project's open dashboards.
+
+    The dashboard.push job is queued once the change commits and refreshes
+    the stats snapshot, so the pushed numbers come from committed data and
+    a burst of changes is pushed together (see dashboard/live.py).
+
+    Args:
+        sender: The object sending the signal
+        project_id: The project whose data changed, if known
+        obligation: The obligation that changed, if any
+        **kwargs: Additional keyword arguments
+    """
+    if project_id and live_updates_enabled():
+        transaction.on_commit(partial(request_dashboard_push, project_id, obligation))
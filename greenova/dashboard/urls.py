@@ -14,4 +14,9 @@
     path(
         "projects-at-risk/", views.ProjectsAtRiskView.as_view(), name="projects_at_risk"
     ),
+    path(
+        "charts/<slug:kind>/<int:object_id>.<str:fmt>",
+        views.ChartImageView.as_view(),
+        name="chart_image",
+    ),
 ]
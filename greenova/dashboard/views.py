@@ -5,12 +5,13 @@
 
 """
 
-import base64
 import logging
 from datetime import datetime, timedelta  # Use timedelta from datetime
 from typing import Any, TypedDict, cast
 
+from core.utils.chart_cache import chart_response, chart_url
 from django.conf import settings
+from django.contrib.auth.mixins import LoginRequiredMixin
 from django.contrib.auth.models import AbstractUser
 from django.db.models import QuerySet
 from django.http import HttpRequest, HttpResponse
@@ -18,16 +19,15 @@
 from django.utils.decorators import method_decorator
 from django.views.decorators.cache import cache_control
 from django.views.decorators.vary import vary_on_headers
-from django.views.generic import ListView, TemplateView
+from django.views.generic import ListView, TemplateView, View
 from obligations.models import Obligation
 from projects.models import Project
 
 # Import our new components
-from .figures import (
-    create_obligations_status_chart_svg,
-    create_project_compliance_chart,
-)
+from .figures import get_chart_spec
+from .live import live_dashboard_path, live_updates_enabled
 from .mixins import ChartMixin, ProjectAwareDashboardMixin
+from .models import get_project_stats, summarize_project_stats
 
 # Constants for system information
 SYSTEM_STATUS = "operational"  # or fetch from settings/environment
@@ -40,7 +40,7 @@
 class DashboardContext(TypedDict):
     """Type definition for dashboard context data."""
 
-    projects: QuerySet[Project]
+    projects: list[Project]
     selected_project_id: str | None
     system_status: str
     app_version: str
@@ -51,15 +51,9 @@ class DashboardContext(TypedDict):
     user_roles: dict[str, str]
 
 
-def get_selected_project_id(request: HttpRequest) -> int | None:
-    """Return the last non-empty project_id from the query string or session."""
-    project_ids = request.GET.getlist("project_id")
-    project_id = next((pid for pid in reversed(project_ids) if pid), None)
-    if project_id:
-        request.session["selected_project_id"] = project_id
-    elif "selected_project_id" in request.session:
-        del request.session["selected_project_id"]
-    return project_id or request.session.get("selected_project_id")
+def get_selected_project_id(request: HttpRequest) -> str | None:
+    """Return the project selection resolved by ProjectSelectionMiddleware."""
+    return getattr(request, "selected_project_id", None)
 
 
 @method_decorator(cache_control(max_age=60), name="dispatch")
@@ -98,13 +92,12 @@ def get_context_data(self, **kwargs: dict[str, Any]) -> dict[str, Any]:
         try:
             user = cast(AbstractUser, self.request.user)
 
-            # Get projects for the current user with prefetch_related
-            projects = self.get_projects().prefetch_related("memberships")
-
-            # Build user_roles dictionary
-            user_roles = {}
-            for project in projects:
-                user_roles[str(project.pk)] = project.get_user_role(user)
+            # Roles come from the request's membership map: one query in total
+            projects = list(self.get_projects())
+            user_roles = {
+                str(project.pk): project.get_user_role(user) for project in projects
+            }
+            stats = self.get_dashboard_stats(projects)
 
             # Get dashboard statistics
             context.update(
@@ -118,12 +111,12 @@ def get_context_data(self, **kwargs: dict[str, Any]) -> dict[str, Any]:
                     "error": None,
                     "user_roles": user_roles,
                     "show_feedback_link": True,
-                    "overdue_obligations_count": self.get_overdue_obligations_count(),
-                    "active_obligations_count": self.get_active_obligations_count(),
-                    "active_obligations_trend": self.get_obligations_trend(),
-                    "upcoming_deadlines_count": self.get_upcoming_deadlines_count(),
-                    "active_projects_count": projects.count(),
-                    "active_mechanisms_count": self.get_active_mechanisms_count(),
+                    "overdue_obligations_count": stats["overdue_count"],
+                    "active_obligations_count": stats["active_count"],
+                    "active_obligations_trend": stats["active_trend"],
+                    "upcoming_deadlines_count": stats["upcoming_count"],
+                    "active_projects_count": len(projects),
+                    "active_mechanisms_count": stats["active_mechanisms_count"],
                     "selected_project_id": get_selected_project_id(self.request),
                 }
             )
@@ -133,27 +126,23 @@ def get_context_data(self, **kwargs: dict[str, Any]) -> dict[str, Any]:
             self.add_specific_charts(context)
 
             # Add a flag to check if project selector should exist
-            context["project_selector_exists"] = self.get_projects().exists()
+            context["project_selector_exists"] = bool(projects)
 
         except (AttributeError, ValueError) as e:
             logger.exception("Error in dashboard context: %s", e)
             context["error"] = str(e)
 
-        try:
-            _, compliance_chart = create_project_compliance_chart(context["projects"])
-            context["compliance_chart"] = base64.b64encode(compliance_chart).decode(
-                "utf-8"
-            )
-        except Exception as exc:
-            logger.exception("Error generating compliance chart: %s", exc)
-
-        try:
-            selected_project_id = context.get("selected_project_id")
-            context["obligations_status_chart_svg"] = (
-                create_obligations_status_chart_svg(selected_project_id)
+        # Charts are referenced by URL and fetched lazily by the browser
+        context["compliance_chart_url"] = chart_url("compliance")
+        selected_project_id = context.get("selected_project_id")
+        if str(selected_project_id or "").isdigit():
+            context["obligations_status_chart_url"] = chart_url(
+                "obligation-status", int(selected_project_id), fmt="svg"
             )
-        except Exception as exc:
-            logger.exception("Error generating obligations status chart: %s", exc)
+            if live_updates_enabled():
+                context["live_dashboard_path"] = live_dashboard_path(
+                    int(selected_project_id)
+                )
 
         return context
 
@@ -185,58 +174,25 @@ def get_projects(self) -> QuerySet[Project]:
             logger.error("Error fetching projects for user %s: %s", user, e)
             return Project.objects.none()
 
-    def get_active_obligations_count(self) -> int:
-        """Get count of active obligations."""
-        project_id = self.selected_project_id
-        query_filter = {}
-        if project_id:
-            query_filter["project_id"] = project_id
-
-        return Obligation.objects.filter(
-            status__in=["pending", "in_progress"], **query_filter
-        ).count()
-
-    def get_overdue_obligations_count(self) -> int:
-        """Get count of overdue obligations for the selected project."""
-        project_id = self.selected_project_id
-        query_filter = {}
-        if project_id:
-            query_filter["project_id"] = project_id
-        today = timezone.now().date()
-        return Obligation.objects.filter(
-            action_due_date__lt=today,
-            status__in=["pending", "in_progress"],
-            **query_filter,
-        ).count()
-
-    def get_obligations_trend(self) -> int:
-        """Calculate the trend in obligations compared to last month."""
-        # This would typically involve more complex time-based calculations
-        # Simplified implementation for demonstration
-        return 5  # Example: 5% increase
-
-    def get_upcoming_deadlines_count(self) -> int:
-        """Get count of upcoming deadlines in the next 7 days."""
-        project_id = self.selected_project_id
-        query_filter = {}
-        if project_id:
-            query_filter["project_id"] = project_id
-
-        today = timezone.now()
-        seven_days_later = today + timedelta(days=7)
+    def get_dashboard_stats(self, projects: list[Project]) -> dict[str, int]:
+        """
+        Return the summary card numbers from the projects' stats snapshots.
 
-        return Obligation.objects.filter(
-            action_due_date__range=(today, seven_days_later),
-            status__in=["pending", "in_progress"],
-            **query_filter,
-        ).count()
+        The selected project's snapshot is used when one is selected; otherwise
+        the snapshots of all the user's projects are added up. Projects the
+        user is not a member of contribute nothing.
 
-    def get_active_mechanisms_count(self) -> int:
-        """Get count of active mechanisms."""
-        # Would normally query the mechanisms model
-        # Simplified placeholder implementation
-        return 10  # Example count
+        Args:
+            projects: The user's projects
 
+        Returns:
+            dict: Counts keyed as in summarize_project_stats()
+        """
+        project_ids = [project.pk for project in projects]
+        selected = str(self.selected_project_id or "")
+        if selected:
+            project_ids = [pk for pk in project_ids if str(pk) == selected]
+        return summarize_project_stats(get_project_stats(project_ids).values())
 
 class ChartView(ChartMixin, ProjectAwareDashboardMixin, TemplateView):
     """View for rendering charts."""
@@ -250,34 +206,12 @@ def selected_project_id(self) -> str | None:
 
     def get_queryset(self):
         """Return the queryset for projects at risk of missing deadlines."""
-        now = timezone.now()
-        queryset = Project.objects.filter(
-            obligations__action_due_date__lt=now,
-            obligations__status__in=["pending", "in_progress"],
-        ).distinct()
-        return queryset
+        return Project.objects.at_risk()
 
     def get_context_data(self, **kwargs):
         """Add projects_with_stats to the context for at-risk projects."""
         context = super().get_context_data(**kwargs)
-        now = timezone.now()
-        projects_with_stats = []
-        for project in context["projects"]:
-            overdue_obligations = project.obligations.filter(
-                action_due_date__lt=now, status__in=["pending", "in_progress"]
-            )
-            overdue_count = overdue_obligations.count()
-            last_due_date = overdue_obligations.order_by("-action_due_date").first()
-            projects_with_stats.append(
-                {
-                    "project": project,
-                    "overdue_count": overdue_count,
-                    "last_due_date": last_due_date.action_due_date
-                    if last_due_date
-                    else None,
-                }
-            )
-        context["projects_with_stats"] = projects_with_stats
+        context["projects_with_stats"] = self.get_queryset()
         return context
 
 
@@ -290,34 +224,13 @@ class ProjectsAtRiskView(ProjectAwareDashboardMixin, ListView):
 
     def get_queryset(self):
         """Return projects with obligations at risk of missing deadlines."""
-        now = timezone.now()
-        queryset = Project.objects.filter(
-            obligations__action_due_date__lt=now,
-            obligations__status__in=["pending", "in_progress"],
-        ).distinct()
-        return queryset[:10]
+        return Project.objects.at_risk()[:10]
 
     def get_context_data(self, **kwargs):
         """Add projects_with_stats to the context."""
         context = super().get_context_data(**kwargs)
-        now = timezone.now()
-        projects_with_stats = []
-        for project in context["projects"]:
-            overdue_obligations = project.obligations.filter(
-                action_due_date__lt=now, status__in=["pending", "in_progress"]
-            )
-            overdue_count = overdue_obligations.count()
-            last_due_date = overdue_obligations.order_by("-action_due_date").first()
-            projects_with_stats.append(
-                {
-                    "project": project,
-                    "overdue_count": overdue_count,
-                    "last_due_date": last_due_date.action_due_date
-                    if last_due_date
-                    else None,
-                }
-            )
-        context["projects_with_stats"] = projects_with_stats
+        # Each project carries overdue_count and last_due_date annotations
+        context["projects_with_stats"] = context["projects"]
         return context
 
 
@@ -348,3 +261,20 @@ def get_context_data(self, **kwargs):
         context = super().get_context_data(**kwargs)
         context["selected_project_id"] = get_selected_project_id(self.request)
         return context
+
+
+class ChartImageView(LoginRequiredMixin, View):
+    """
+    Serve one chart as PNG or SVG bytes.
+
+    Pages reference these URLs from lazily loaded <img> tags instead of
+    inlining base64 data, so chart bytes are cached by the browser and
+    revalidated with If-None-Match against the chart's data fingerprint.
+    """
+
+    def get(
+        self, request: HttpRequest, kind: str, object_id: int, fmt: str
+    ) -> HttpResponse:
+        """Return the chart image or a 304 when the browser copy is current."""
+        spec = get_chart_spec(kind, object_id, request.GET, request.user)
+        return chart_response(request, spec, fmt)
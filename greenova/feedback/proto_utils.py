@@ -9,106 +9,47 @@
 feedback application.
 """
 import logging
-import sys
-from typing import Any, List, Optional
+from typing import IO, Iterable, Iterator, List, Optional
 
+from core.proto_utils import read_delimited, write_delimited
 from django.contrib.auth import get_user_model
-from django.utils.timezone import datetime  # Import datetime explicitly
 
 from .models import BugReport
+from .proto import feedback_pb2
 
 User = get_user_model()
 logger = logging.getLogger(__name__)
 
-# Import generated protobuf modules with improved error handling
-try:
-    from .proto import feedback_pb2
-    logger.info("Successfully imported feedback_pb2 from proto subdirectory")
-except ImportError:
-    logger.error("feedback_pb2 module not found. Ensure to compile the protobuf files.")
-
-    # Create a minimal stub for the module to allow Django to continue loading
-    from types import ModuleType
-    feedback_pb2: ModuleType = ModuleType('feedback_pb2')
-    sys.modules['feedback.proto.feedback_pb2'] = feedback_pb2
-
-    # Define minimal classes needed for type hinting
-    class BugReportProto:
-        # pylint: disable=too-many-instance-attributes
-        def __init__(self):
-            # Core fields that must be instance attributes
-            self.id = 0
-            self.title = ""
-            self.description = ""
-            # Environment fields
-            self.application_version = ""
-            self.operating_system = ""
-            self.browser = ""
-            self.device_type = ""
-            # Problem details
-            self.steps_to_reproduce = ""
-            self.expected_behavior = ""
-            self.actual_behavior = ""
-            # Additional properties
-            self.environment = ""
-            self.error_messages = ""
-            self.trace_report = ""
-            self.frequency = 0
-            self.impact_severity = ""
-            self.user_impact = ""
-            self.workarounds = ""
-            self.additional_comments = ""
-            self.github_issue_url = ""
-            self.severity = ""
-            self.status = ""
-            self.admin_comment = ""
-            self.reports = []
-
-        # Define enum-like classes for consistency
-        class Frequency:
-            FREQUENCY_UNKNOWN_UNSPECIFIED = 0
-            FREQUENCY_ALWAYS = 1
-            FREQUENCY_FREQUENTLY = 2
-            FREQUENCY_OCCASIONALLY = 3
-            FREQUENCY_RARELY = 4
-
-        class Severity:
-            SEVERITY_UNDEFINED_UNSPECIFIED = 0
-            SEVERITY_LOW = 1
-            SEVERITY_MEDIUM = 2
-            SEVERITY_HIGH = 3
-            SEVERITY_CRITICAL = 4
-
-        class Status:
-            STATUS_UNSPECIFIED = 0
-            STATUS_OPEN = 1
-            STATUS_IN_PROGRESS = 2
-            STATUS_RESOLVED = 3
-            STATUS_CLOSED = 4
-            STATUS_REJECTED = 5
-
-        def SerializeToString(self) -> bytes:
-            return b''
-
-        def ParseFromString(self, data: bytes) -> None:
-            pass
-
-    class BugReportCollection:
-        def __init__(self):
-            self.reports = []
-
-        def SerializeToString(self) -> bytes:
-            return b''
-
-        def ParseFromString(self, data: bytes) -> None:
-            pass
-
-        def append(self, item: Any) -> None:
-            self.reports.append(item)
-
-    # Add the classes to the module
-    feedback_pb2.BugReportProto = BugReportProto
-    feedback_pb2.BugReportCollection = BugReportCollection
+# Text fields copied between BugReport and BugReportProto
+BUG_REPORT_PROTO_FIELDS = (
+    'title',
+    'description',
+    'application_version',
+    'operating_system',
+    'browser',
+    'device_type',
+    'steps_to_reproduce',
+    'expected_behavior',
+    'actual_behavior',
+)
+
+# File extension of length-delimited bug report batches
+BUG_REPORT_BATCH_EXTENSION = '.pbd'
+
+
+def bug_report_to_proto(bug_report: BugReport) -> feedback_pb2.BugReportProto:
+    """Build the BugReportProto message for a BugReport."""
+    proto = feedback_pb2.BugReportProto(id=bug_report.id or 0)
+    for field in BUG_REPORT_PROTO_FIELDS:
+        setattr(proto, field, getattr(bug_report, field) or "")
+    return proto
+
+
+def bug_report_from_proto(proto: feedback_pb2.BugReportProto) -> BugReport:
+    """Build an unsaved BugReport from a BugReportProto message."""
+    return BugReport(
+        **{field: getattr(proto, field) for field in BUG_REPORT_PROTO_FIELDS}
+    )
 
 
 def serialize_bug_report(bug_report: BugReport) -> Optional[bytes]:
@@ -122,31 +63,7 @@ def serialize_bug_report(bug_report: BugReport) -> Optional[bytes]:
         Serialized protocol buffer data as bytes, or None if serialization failed
     """
     try:
-        # Create a new BugReportProto message
-        proto = feedback_pb2.BugReportProto()
-
-        # Set basic fields
-        proto.id = bug_report.id or 0
-        proto.title = bug_report.title
-        proto.description = bug_report.description
-
-        # Set environment fields if available
-        if hasattr(bug_report, 'application_version'):
-            proto.application_version = bug_report.application_version
-        if hasattr(bug_report, 'operating_system'):
-            proto.operating_system = bug_report.operating_system
-        if hasattr(bug_report, 'browser'):
-            proto.browser = bug_report.browser or ""
-        if hasattr(bug_report, 'device_type'):
-            proto.device_type = bug_report.device_type
-
-        # Set problem detail fields if available
-        if hasattr(bug_report, 'steps_to_reproduce'):
-            proto.steps_to_reproduce = bug_report.steps_to_reproduce
-        if hasattr(bug_report, 'expected_behavior'):
-            proto.expected_behavior = bug_report.expected_behavior
-        if hasattr(bug_report, 'actual_behavior'):
-            proto.actual_behavior = bug_report.actual_behavior
+        proto = bug_report_to_proto(bug_report)
 
         # Serialize to bytes
         return proto.SerializeToString()
@@ -175,33 +92,7 @@ def deserialize_bug_report(data: bytes) -> Optional[BugReport]:
         # Parse the binary data into a BugReportProto
         proto = feedback_pb2.BugReportProto()
         proto.ParseFromString(data)
-
-        # Create a BugReport instance
-        bug_report = BugReport()
-
-        # Set basic fields
-        bug_report.title = proto.title
-        bug_report.description = proto.description
-
-        # Set environment fields
-        if hasattr(proto, 'application_version'):
-            bug_report.application_version = proto.application_version
-        if hasattr(proto, 'operating_system'):
-            bug_report.operating_system = proto.operating_system
-        if hasattr(proto, 'browser'):
-            bug_report.browser = proto.browser
-        if hasattr(proto, 'device_type'):
-            bug_report.device_type = proto.device_type
-
-        # Set problem detail fields
-        if hasattr(proto, 'steps_to_reproduce'):
-            bug_report.steps_to_reproduce = proto.steps_to_reproduce
-        if hasattr(proto, 'expected_behavior'):
-            bug_report.expected_behavior = proto.expected_behavior
-        if hasattr(proto, 'actual_behavior'):
-            bug_report.actual_behavior = proto.actual_behavior
-
-        return bug_report
+        return bug_report_from_proto(proto)
     except (AttributeError, TypeError) as e:
         logger.error(
             "Failed to deserialize bug report due to attribute or type error: %s",
@@ -230,16 +121,11 @@ def serialize_bug_reports(bug_reports: List[BugReport]) -> Optional[bytes]:
         Serialized protocol buffer collection as bytes, or None if serialization failed
     """
     try:
-        # Create a new BugReportCollection message
+        # Messages are built once and added straight to the collection
         collection = feedback_pb2.BugReportCollection()
-
-        # Add each bug report to the collection
-        for bug_report in bug_reports:
-            report_proto_data = serialize_bug_report(bug_report)
-            if report_proto_data:
-                report_proto = feedback_pb2.BugReportProto()
-                report_proto.ParseFromString(report_proto_data)
-                collection.append(report_proto)
+        collection.reports.extend(
+            bug_report_to_proto(bug_report) for bug_report in bug_reports
+        )
 
         # Serialize the collection to bytes
         return collection.SerializeToString()
@@ -276,16 +162,7 @@ def deserialize_bug_reports(data: bytes) -> List[BugReport]:
         collection = feedback_pb2.BugReportCollection()
         collection.ParseFromString(data)
 
-        # Convert each protocol buffer message to a BugReport
-        bug_reports = []
-        for report_proto in collection.reports:
-            # Serialize and deserialize each report
-            report_data = report_proto.SerializeToString()
-            bug_report = deserialize_bug_report(report_data)
-            if bug_report:
-                bug_reports.append(bug_report)
-
-        return bug_reports
+        return [bug_report_from_proto(proto) for proto in collection.reports]
     except (AttributeError, TypeError) as e:
         logger.error(
             "Failed to deserialize bug report collection due to attribute "
@@ -305,3 +182,27 @@ def deserialize_bug_reports(data: bytes) -> List[BugReport]:
             str(e)
         )
         return []
+
+
+def write_bug_reports(bug_reports: Iterable[BugReport], stream: IO[bytes]) -> int:
+    """
+    Write bug reports to ``stream`` as a length-delimited batch.
+
+    Unlike serialize_bug_reports(), no collection is held in memory: each
+    report is written as soon as it is converted.
+
+    Returns:
+        int: The number of reports written
+    """
+    return write_delimited(map(bug_report_to_proto, bug_reports), stream)
+
+
+def read_bug_reports(stream: IO[bytes]) -> Iterator[BugReport]:
+    """
+    Yield unsaved bug reports from a length-delimited batch one at a time.
+
+    Raises:
+        ValueError: If the batch is truncated or malformed
+    """
+    for proto in read_delimited(stream, feedback_pb2.BugReportProto):
+        yield bug_report_from_proto(proto)
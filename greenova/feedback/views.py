@@ -1,20 +1,37 @@
 import logging
+from typing import Iterator
 
+from core.proto_utils import encode_delimited
+from core.utils.db import iterate_queryset
+from core.utils.streaming import stream_async
 from django.contrib import messages
 from django.contrib.auth.decorators import login_required
 from django.core.mail import send_mail
-from django.http import HttpRequest, HttpResponse
+from django.db import transaction
+from django.http import HttpRequest, HttpResponse, StreamingHttpResponse
 from django.shortcuts import get_object_or_404, redirect, render
 from django.template.loader import render_to_string
 from django.utils.translation import gettext_lazy as _
-from django.views.decorators.http import require_http_methods
+from django.views.decorators.http import require_GET, require_http_methods
+from google.protobuf.message import DecodeError
 
 from .forms import BugReportForm
 from .models import BugReport
-from .proto_utils import deserialize_bug_report, serialize_bug_report
+from .proto_utils import (
+    BUG_REPORT_BATCH_EXTENSION,
+    bug_report_to_proto,
+    deserialize_bug_report,
+    read_bug_reports,
+    serialize_bug_report,
+)
 
 logger = logging.getLogger(__name__)
 
+# Reports saved per bulk_create when importing a batch
+BUG_REPORT_IMPORT_BATCH_SIZE = 500
+# Bytes of encoded reports sent per chunk of an export
+BUG_REPORT_EXPORT_CHUNK_SIZE = 64 * 1024
+
 
 def get_plaintext_template(template_path: str) -> str:
     """
@@ -188,6 +205,62 @@ def export_report(request: HttpRequest, report_id: int) -> HttpResponse:
     return response
 
 
+@login_required
+@require_GET
+def export_reports(request: HttpRequest) -> StreamingHttpResponse:
+    """
+    Stream all visible bug reports as a length-delimited Protocol Buffer batch.
+
+    Reports are read in chunks and sent about 64 KiB of messages at a time,
+    so the export never holds the whole batch in memory; under ASGI each
+    chunk is produced in the sync thread (see core.utils.streaming).
+    """
+    bug_reports = BugReport.objects.order_by('id')
+    if not request.user.is_staff:
+        bug_reports = bug_reports.filter(created_by=request.user)
+
+    response = StreamingHttpResponse(
+        _encode_report_chunks(iterate_queryset(bug_reports)),
+        content_type='application/octet-stream',
+    )
+    response['Content-Disposition'] = (
+        f'attachment; filename="bug_reports{BUG_REPORT_BATCH_EXTENSION}"'
+    )
+    return stream_async(request, response)
+
+
+def _encode_report_chunks(bug_reports) -> Iterator[bytes]:
+    """Encode reports length-delimited, joined into export-sized chunks."""
+    chunk = []
+    size = 0
+    for bug_report in bug_reports:
+        message = encode_delimited(bug_report_to_proto(bug_report))
+        chunk.append(message)
+        size += len(message)
+        if size >= BUG_REPORT_EXPORT_CHUNK_SIZE:
+            yield b''.join(chunk)
+            chunk = []
+            size = 0
+    if chunk:
+        yield b''.join(chunk)
+
+
+@transaction.atomic
+def _import_report_batch(uploaded_file, user) -> int:
+    """Save every report of a length-delimited batch in bulk, or none of them."""
+    imported = 0
+    batch = []
+    for bug_report in read_bug_reports(uploaded_file):
+        bug_report.created_by = user
+        batch.append(bug_report)
+        if len(batch) >= BUG_REPORT_IMPORT_BATCH_SIZE:
+            imported += len(BugReport.objects.bulk_create(batch))
+            batch = []
+    if batch:
+        imported += len(BugReport.objects.bulk_create(batch))
+    return imported
+
+
 @login_required
 @require_http_methods(["GET", "POST"])
 def import_report(request: HttpRequest) -> HttpResponse:
@@ -201,13 +274,20 @@ def import_report(request: HttpRequest) -> HttpResponse:
         HTTP response with success/error message or form
     """
     if request.method == 'POST':
-        if 'file' not in request.FILES:
+        # The feedback index and import page name the field differently
+        uploaded_file = request.FILES.get('file') or request.FILES.get('protobuf_file')
+        if uploaded_file is None:
             messages.error(request, _('No file was provided.'))
             return redirect('feedback:import_report')
 
-        uploaded_file = request.FILES['file']
-
         try:
+            if uploaded_file.name.endswith(BUG_REPORT_BATCH_EXTENSION):
+                imported = _import_report_batch(uploaded_file, request.user)
+                messages.success(
+                    request, _('%(count)d bug reports imported.') % {'count': imported}
+                )
+                return redirect('feedback:index')
+
             # Read and deserialize the file
             data = uploaded_file.read()
             bug_report = deserialize_bug_report(data)
@@ -226,7 +306,7 @@ def import_report(request: HttpRequest) -> HttpResponse:
             messages.success(request, _('Bug report imported successfully.'))
             return redirect('feedback:index')
 
-        except (ValueError, OSError, AttributeError, TypeError) as e:
+        except (ValueError, OSError, AttributeError, TypeError, DecodeError) as e:
             logger.error("Error importing bug report: %s", str(e))
             messages.error(
                 request,
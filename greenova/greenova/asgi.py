@@ -2,6 +2,8 @@
 ASGI config for greenova project.
 
 It exposes the ASGI callable as a module-level variable named ``application``.
+HTTP goes to Django; WebSockets (the live dashboard) are routed by Channels
+with the session user attached, when the channels package is installed.
 
 For more information on this file, see
 https://docs.djangoproject.com/en/5.1/howto/deployment/asgi/
@@ -18,4 +20,24 @@
 
 os.environ.setdefault("DJANGO_SETTINGS_MODULE", "greenova.settings")
 
-application = get_asgi_application()
+# Set up Django before importing anything that touches models
+django_asgi_app = get_asgi_application()
+
+# pylint: disable=wrong-import-position
+try:
+    from channels.auth import AuthMiddlewareStack  # noqa: E402
+    from channels.routing import ProtocolTypeRouter, URLRouter  # noqa: E402
+    from channels.security.websocket import AllowedHostsOriginValidator  # noqa: E402
+except ImportError:  # Without channels, serve HTTP only (no live dashboard)
+    application = django_asgi_app
+else:
+    from dashboard.routing import websocket_urlpatterns  # noqa: E402
+
+    application = ProtocolTypeRouter(
+        {
+            "http": django_asgi_app,
+            "websocket": AllowedHostsOriginValidator(
+                AuthMiddlewareStack(URLRouter(websocket_urlpatterns))
+            ),
+        }
+    )
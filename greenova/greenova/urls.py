@@ -1,5 +1,6 @@
 import logging
 
+from core.views import MetricsView
 from django.conf import settings
 from django.conf.urls.static import static
 from django.contrib import admin
@@ -68,6 +69,8 @@ def trigger_error(request: HttpRequest) -> None:
     path("reports/", include("reports.urls", namespace="reports")),
     # Include settings URLs
     path("settings/", include("settings.urls", namespace="settings")),
+    # Prometheus scrape endpoint (staff or METRICS_TOKEN)
+    path("metrics/", MetricsView.as_view(), name="metrics"),
     # Sentry error page to verify Sentry is working
     path("sentry-debug/", trigger_error),
 ]
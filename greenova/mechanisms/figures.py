@@ -1,24 +1,35 @@
 import base64
 import io
 import logging
-from typing import List, Tuple
+from typing import TYPE_CHECKING, List, Tuple
 
-from matplotlib.figure import Figure
+from core.utils.chart_cache import ChartSpec
+from django.db.models import Sum
 
 from .models import EnvironmentalMechanism
 
+if TYPE_CHECKING:
+    from matplotlib.figure import Figure
+
 logger = logging.getLogger(__name__)
 
+STATUS_LABELS = ['Not Started', 'In Progress', 'Completed', 'Overdue']
+STATUS_COLORS = ['#f9c74f', '#90be6d', '#43aa8b', '#f94144']
+
 def generate_pie_chart(
     data: List[int],
     labels: List[str],
     colors: List[str],
     fig_width: int = 300,
     fig_height: int = 250
-) -> Figure:
+) -> "Figure":
     """
     Generate a pie chart for given data and labels with percentages in the legend.
     """
+    # Loaded on the first render so workers start without matplotlib
+    # pylint: disable=import-outside-toplevel
+    from matplotlib.figure import Figure
+
     fig = Figure(figsize=(fig_width / 100, fig_height / 100), dpi=100)
     ax = fig.add_subplot(111)
 
@@ -56,7 +67,7 @@ def generate_pie_chart(
 
     return fig
 
-def encode_figure_to_base64(fig: Figure) -> str:
+def encode_figure_to_base64(fig: "Figure") -> str:
     """
     Convert a matplotlib figure to a base64 encoded string.
     """
@@ -69,7 +80,7 @@ def get_mechanism_chart(
     mechanism_id: int,
     fig_width: int = 300,
     fig_height: int = 250
-) -> Tuple[Figure, str]:
+) -> Tuple["Figure", str]:
     """
     Get pie chart for a specific mechanism based on its statuses.
     Returns both the figure and base64 encoded image data.
@@ -104,7 +115,7 @@ def get_overall_chart(
     project_id: int,
     fig_width: int = 300,
     fig_height: int = 250
-) -> Tuple[Figure, str]:
+) -> Tuple["Figure", str]:
     """
     Get overall pie chart for all mechanisms in a project.
     Returns both the figure and base64 encoded image data.
@@ -147,3 +158,68 @@ def get_overall_chart(
         )
         encoded_image = encode_figure_to_base64(fig)
         return fig, encoded_image
+
+def get_status_chart_spec(
+    data: List[int],
+    fig_width: int = 300,
+    fig_height: int = 250
+) -> ChartSpec:
+    """
+    Describe a status pie chart; it is drawn only on a chart cache miss.
+    """
+    return ChartSpec(
+        'mechanism_status',
+        data,
+        lambda: generate_pie_chart(
+            data, STATUS_LABELS, STATUS_COLORS, fig_width, fig_height
+        ),
+        width=fig_width,
+        height=fig_height,
+        series={
+            'type': 'pie',
+            'title': 'Status',
+            'labels': STATUS_LABELS,
+            'values': data,
+            'colors': STATUS_COLORS,
+        },
+    )
+
+def get_mechanism_chart_spec(
+    mechanism: EnvironmentalMechanism,
+    fig_width: int = 300,
+    fig_height: int = 250
+) -> ChartSpec:
+    """
+    Get the status pie chart spec for a loaded mechanism.
+    """
+    data = [
+        mechanism.not_started_count,
+        mechanism.in_progress_count,
+        mechanism.completed_count,
+        mechanism.overdue_count
+    ]
+    return get_status_chart_spec(data, fig_width, fig_height)
+
+def get_overall_chart_spec(
+    project_id: int,
+    fig_width: int = 300,
+    fig_height: int = 250
+) -> ChartSpec:
+    """
+    Get the combined status pie chart spec for a project's mechanisms.
+    """
+    totals = EnvironmentalMechanism.objects.filter(
+        project_id=project_id
+    ).aggregate(
+        not_started=Sum('not_started_count'),
+        in_progress=Sum('in_progress_count'),
+        completed=Sum('completed_count'),
+        overdue=Sum('overdue_count'),
+    )
+    data = [
+        totals['not_started'] or 0,
+        totals['in_progress'] or 0,
+        totals['completed'] or 0,
+        totals['overdue'] or 0
+    ]
+    return get_status_chart_spec(data, fig_width, fig_height)
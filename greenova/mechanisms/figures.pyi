@@ -1,8 +1,15 @@
 # Stub file for mechanisms.figures
 from typing import List, Tuple
 
+from core.utils.chart_cache import ChartSpec
 from matplotlib.figure import Figure
 
+from .models import EnvironmentalMechanism
+
+STATUS_LABELS: List[str]
+STATUS_COLORS: List[str]
+
+
 def generate_pie_chart(
     data: List[int],
     labels: List[str],
@@ -17,3 +24,12 @@ def get_mechanism_chart(
 def get_overall_chart(
     project_id: int, fig_width: int = ..., fig_height: int = ...
 ) -> Tuple[Figure, str]: ...
+def get_status_chart_spec(
+    data: List[int], fig_width: int = ..., fig_height: int = ...
+) -> ChartSpec: ...
+def get_mechanism_chart_spec(
+    mechanism: EnvironmentalMechanism, fig_width: int = ..., fig_height: int = ...
+) -> ChartSpec: ...
+def get_overall_chart_spec(
+    project_id: int, fig_width: int = ..., fig_height: int = ...
+) -> ChartSpec: ...
@@ -1,11 +1,16 @@
 import logging
+import threading
 from builtins import property
-from typing import List
+from contextlib import contextmanager
+from typing import Dict, Iterable, Iterator, List, Optional, Set
 
+from core.jobs import enqueue_job, register_job
 from core.types import StatusData
-from django.core.exceptions import FieldError, ObjectDoesNotExist
+from django.core.exceptions import FieldError
 from django.db import models
-from django.db.models.query import QuerySet
+from django.db.models import Count, OuterRef, Q, Subquery
+from django.db.models.functions import Coalesce
+from django.utils import timezone
 from django_matplotlib.fields import MatplotlibFigureField  # type: ignore
 from obligations.constants import (
     STATUS_CHOICES,
@@ -13,10 +18,18 @@
     STATUS_IN_PROGRESS,
     STATUS_NOT_STARTED,
 )
-from obligations.utils import is_obligation_overdue
+from obligations.utils import overdue_q
 
 logger = logging.getLogger(__name__)
 
+# Denormalised counter fields maintained from related obligations
+COUNT_FIELDS = (
+    'not_started_count',
+    'in_progress_count',
+    'completed_count',
+    'overdue_count',
+)
+
 
 class EnvironmentalMechanism(models.Model):
     """Represents an environmental mechanism that governs obligations."""
@@ -90,34 +103,15 @@ def update_obligation_counts(self) -> None:
         """Update obligation counts based on related obligations."""
         from obligations.models import Obligation
 
-        # Get all related obligations
-        obligations: QuerySet = Obligation.objects.filter(
+        # Count every status bucket and the overdue rule in a single query
+        counts = Obligation.objects.filter(
             primary_environmental_mechanism=self
-        )
-
-        # Reset counts
-        self.not_started_count = 0
-        self.in_progress_count = 0
-        self.completed_count = 0
-        self.overdue_count = 0
-
-        # Count obligations by status
-        for obligation in obligations:
-            status = obligation.status
-
-            # Check if overdue using the utility function
-            if is_obligation_overdue(obligation):
-                self.overdue_count += 1
+        ).aggregate(**_count_expressions())
 
-            # Also count by regular status
-            if status == STATUS_NOT_STARTED:
-                self.not_started_count += 1
-            elif status == STATUS_IN_PROGRESS:
-                self.in_progress_count += 1
-            elif status == STATUS_COMPLETED:
-                self.completed_count += 1
+        for field, value in counts.items():
+            setattr(self, field, value)
 
-        self.save()
+        self.save(update_fields=[*COUNT_FIELDS, 'updated_at'])
 
     def get_status_data(self) -> StatusData:
         """Return a dictionary of status counts for charting."""
@@ -129,29 +123,132 @@ def get_status_data(self) -> StatusData:
         })
 
 
+def _count_expressions() -> Dict[str, Count]:
+    """Return the Count aggregates backing each mechanism counter field."""
+    return {
+        'not_started_count': Count('pk', filter=Q(status=STATUS_NOT_STARTED)),
+        'in_progress_count': Count('pk', filter=Q(status=STATUS_IN_PROGRESS)),
+        'completed_count': Count('pk', filter=Q(status=STATUS_COMPLETED)),
+        'overdue_count': Count('pk', filter=overdue_q()),
+    }
+
+
+def _count_subqueries() -> Dict[str, Coalesce]:
+    """
+    Return correlated subqueries computing each counter for OuterRef('pk').
+
+    Used with QuerySet.update() so that any number of mechanisms can be
+    recounted with a single UPDATE statement.
+    """
+    from obligations.models import Obligation
+
+    grouped = (Obligation.objects
+               .filter(primary_environmental_mechanism=OuterRef('pk'))
+               .order_by()
+               .values('primary_environmental_mechanism'))
+
+    return {
+        field: Coalesce(
+            Subquery(grouped.annotate(total=expression).values('total')),
+            0,
+        )
+        for field, expression in _count_expressions().items()
+    }
+
+
+def update_mechanism_counts(mechanism_ids: Iterable[int]) -> int:
+    """
+    Recount obligations for the given mechanisms in one set-based UPDATE.
+
+    Args:
+        mechanism_ids: Primary keys of the mechanisms to recount
+
+    Returns:
+        int: Number of mechanisms updated
+    """
+    ids = {mechanism_id for mechanism_id in mechanism_ids if mechanism_id}
+    if not ids:
+        return 0
+
+    return EnvironmentalMechanism.objects.filter(pk__in=ids).update(
+        updated_at=timezone.now(), **_count_subqueries()
+    )
+
+
+@register_job('mechanisms.recount')
+def run_mechanism_recounts(keys: List[str]) -> None:
+    """Background job: recount the mechanisms whose ids are ``keys``."""
+    update_mechanism_counts(int(key) for key in keys if key.isdigit())
+
+
 def update_all_mechanism_counts() -> int:
     """
     Update obligation counts for all mechanisms.
     Called after importing obligations to ensure counts are accurate.
     """
-    mechanisms: QuerySet = (EnvironmentalMechanism.objects
-                            .all()
-                            .select_related('project'))
-    updated_count: int = 0
-
-    for mechanism in mechanisms:
-        try:
-            mechanism.update_obligation_counts()
-            updated_count += 1
-        except (
-                ObjectDoesNotExist,  # Using imported exceptions
-                FieldError,
-                AttributeError,
-                ValueError
-        ) as e:
-            logger.error(
-                'Error updating counts for mechanism %s: %s',
-                mechanism.name, str(e)
-            )
-
-    return updated_count
+    try:
+        return EnvironmentalMechanism.objects.update(
+            updated_at=timezone.now(), **_count_subqueries()
+        )
+    except (FieldError, ValueError) as e:
+        logger.error('Error updating mechanism counts: %s', str(e))
+        return 0
+
+
+class _PendingRecounts(threading.local):
+    """Per-thread stack of mechanism id sets collected by defer blocks."""
+
+    def __init__(self) -> None:
+        self.stack: List[Set[int]] = []
+
+
+_pending_recounts = _PendingRecounts()
+
+
+@contextmanager
+def defer_mechanism_counts() -> Iterator[Set[int]]:
+    """
+    Collect mechanism recounts and queue them once when the block exits.
+
+    Obligation save/delete signals call schedule_mechanism_counts(); inside
+    this block those calls are deduplicated so a bulk edit of N obligations
+    in the same mechanism costs one recount instead of N. Nested blocks are
+    folded into the outermost one. Recounts are skipped if the block raises,
+    since the surrounding transaction is expected to roll back.
+
+    Usage:
+        with transaction.atomic(), defer_mechanism_counts():
+            ...
+    """
+    pending: Set[int] = set()
+    _pending_recounts.stack.append(pending)
+    try:
+        yield pending
+    finally:
+        _pending_recounts.stack.pop()
+
+    if _pending_recounts.stack:
+        _pending_recounts.stack[-1].update(pending)
+    elif pending:
+        enqueue_job('mechanisms.recount', *pending)
+
+
+def schedule_mechanism_counts(*mechanism_ids: Optional[int]) -> None:
+    """
+    Queue a recount of the given mechanisms.
+
+    Inside a defer block the ids are collected until the block exits;
+    otherwise a deduplicated 'mechanisms.recount' job is enqueued, which
+    runs immediately when background jobs are eager.
+
+    Args:
+        *mechanism_ids: Mechanism primary keys; falsy values are ignored
+    """
+    ids = {mechanism_id for mechanism_id in mechanism_ids if mechanism_id}
+    if not ids:
+        return
+
+    if _pending_recounts.stack:
+        _pending_recounts.stack[-1].update(ids)
+    else:
+        enqueue_job('mechanisms.recount', *ids)
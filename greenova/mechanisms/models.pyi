@@ -1,6 +1,15 @@
 # Stub file for mechanisms.models
+from contextlib import AbstractContextManager
+from typing import Iterable, List, Optional, Set
+
 from django.db import models
 
+COUNT_FIELDS: tuple[str, ...]
+
 class EnvironmentalMechanism(models.Model): ...
 
+def update_mechanism_counts(mechanism_ids: Iterable[int]) -> int: ...
+def run_mechanism_recounts(keys: List[str]) -> None: ...
 def update_all_mechanism_counts() -> int: ...
+def defer_mechanism_counts() -> AbstractContextManager[Set[int]]: ...
+def schedule_mechanism_counts(*mechanism_ids: Optional[int]) -> None: ...
@@ -1,6 +1,6 @@
 import logging
 
-import matplotlib
+from core.utils.chart_cache import chart_url
 from django.contrib.auth.mixins import LoginRequiredMixin
 from django.utils.decorators import method_decorator
 from django.views.decorators.cache import cache_control
@@ -8,11 +8,8 @@
 from django.views.generic import ListView, TemplateView
 from projects.models import Project
 
-from .figures import get_mechanism_chart, get_overall_chart
 from .models import EnvironmentalMechanism
 
-matplotlib.use("Agg")  # Use Agg backend for non-interactive plotting
-
 logger = logging.getLogger(__name__)
 
 
@@ -49,21 +46,20 @@ def get_context_data(self, **kwargs):
             mechanism_charts = []
 
             # Add overall chart first
-            _, overall_chart_data = get_overall_chart(project_id)
-
             mechanism_charts.append(
-                {"name": "Overall Status", "image_data": overall_chart_data}
+                {
+                    "name": "Overall Status",
+                    "image_url": chart_url("mechanism-overall", project_id),
+                }
             )
 
             # Generate charts for individual mechanisms
             for mechanism in mechanisms:
-                _, chart_data = get_mechanism_chart(mechanism.id)
-
                 mechanism_charts.append(
                     {
                         "id": mechanism.id,
                         "name": mechanism.name,
-                        "image_data": chart_data,
+                        "image_url": chart_url("mechanism", mechanism.id),
                     }
                 )
 
@@ -3,10 +3,12 @@
 from core.utils.roles import get_responsibility_choices
 from django import forms
 from django.contrib import admin
+from django.db import transaction
 from django.db.models import QuerySet
 from django.forms import ModelForm
 from django.http import HttpRequest
 from django.utils import timezone
+from mechanisms.models import defer_mechanism_counts
 
 from .models import Obligation, ObligationEvidence
 from .utils import is_obligation_overdue
@@ -268,11 +270,8 @@ def save_model(
                 '%s obligation %s for project %s',
                 action, obj.obligation_number, obj.project.name
             )
+            # Mechanism counts are updated by the obligation post_save signal
             super().save_model(request, obj, form, change)
-
-            # Update mechanism counts
-            if obj.primary_environmental_mechanism:
-                obj.primary_environmental_mechanism.update_obligation_counts()
         except Exception as e:
             logger.error('Error saving obligation: %s', str(e))
             raise
@@ -283,10 +282,11 @@ def save_model(
     def update_recurring_dates(self, request, queryset):
         """Update recurring forecasted dates for selected obligations."""
         count = 0
-        for obligation in queryset:
-            if obligation.update_recurring_forecasted_date():
-                obligation.save()
-                count += 1
+        with transaction.atomic(), defer_mechanism_counts():
+            for obligation in queryset:
+                if obligation.update_recurring_forecasted_date():
+                    obligation.save()
+                    count += 1
 
         self.message_user(
             request, f'Successfully updated {count} recurring forecasted dates'
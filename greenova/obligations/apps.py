@@ -1,6 +1,17 @@
 from django.apps import AppConfig
+from django.db.models.signals import post_migrate
 
 
 class ObligationsConfig(AppConfig):
     default_auto_field = "django.db.models.BigAutoField"
     name = "obligations"
+
+    def ready(self):
+        """Create the full-text search table once migrations have run."""
+        # pylint: disable=import-outside-toplevel
+        from .search import ensure_search_index
+
+        post_migrate.connect(ensure_search_index, sender=self)
+
+        # Register the recurring rollover background job
+        from . import recurring  # noqa: F401
@@ -0,0 +1,230 @@
+"""Set-based bulk writer for obligation imports.
+
+Used by the ``import_obligations`` management command's ``--bulk`` mode.
+Rows are diffed against existing obligation numbers one batch at a time and
+written with ``bulk_create``/``bulk_update``, which bypass the per-row
+save signals. The obligation number sequence is advanced and the search
+index refreshed once per batch, and mechanism counters are recounted once
+when the import finishes.
+"""
+
+import logging
+import time
+from dataclasses import dataclass, field
+from typing import Any, Dict, Iterable, List, Optional, Set
+
+from core.utils.chart_cache import bump_chart_cache_version
+from dashboard.signals import dashboard_data_updated
+from django.db import transaction
+from django.utils import timezone
+from mechanisms.models import EnvironmentalMechanism, update_mechanism_counts
+from projects.models import Project
+
+from .models import (
+    OBLIGATION_NUMBER_PATTERN,
+    Obligation,
+    ObligationNumberSequence,
+    coerce_obligation_number,
+    format_obligation_number,
+)
+from .search import index_obligations
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_BATCH_SIZE = 500
+
+
+@dataclass
+class BulkImportStats:
+    """Counters reported at the end of a bulk import."""
+
+    rows: int = 0
+    created: int = 0
+    updated: int = 0
+    skipped: int = 0
+    failed: int = 0
+    started_at: float = field(default_factory=time.perf_counter)
+    write_seconds: float = 0.0
+
+    @property
+    def elapsed(self) -> float:
+        """Seconds since the import started."""
+        return time.perf_counter() - self.started_at
+
+    @property
+    def rows_per_second(self) -> float:
+        """Overall import throughput."""
+        elapsed = self.elapsed
+        return self.rows / elapsed if elapsed > 0 else 0.0
+
+
+class MechanismResolver:
+    """In-memory map of a project's mechanisms keyed by name.
+
+    Loaded with one query; mechanisms missing from the map are created on
+    first use so each name costs at most one INSERT for the whole import.
+    """
+
+    def __init__(self, project: Project, create_missing: bool = True) -> None:
+        self.project = project
+        self.create_missing = create_missing
+        self._by_name: Dict[str, EnvironmentalMechanism] = {
+            mechanism.name: mechanism
+            for mechanism in EnvironmentalMechanism.objects.filter(project=project)
+        }
+
+    def resolve(
+        self, mechanism_name: Optional[str]
+    ) -> Optional[EnvironmentalMechanism]:
+        """Return the mechanism for ``mechanism_name``, creating it if needed."""
+        if not mechanism_name or not mechanism_name.strip():
+            return None
+
+        mechanism_name = mechanism_name.strip()
+        mechanism = self._by_name.get(mechanism_name)
+        if mechanism is None and self.create_missing:
+            mechanism = EnvironmentalMechanism.objects.create(
+                name=mechanism_name,
+                project=self.project,
+                primary_environmental_mechanism=mechanism_name,
+            )
+            logger.info(
+                "Created new mechanism: %s for project %s",
+                mechanism.name,
+                self.project.name,
+            )
+            self._by_name[mechanism_name] = mechanism
+        return mechanism
+
+
+class BulkObligationImporter:
+    """Write batches of processed obligation rows with set-based queries."""
+
+    def __init__(
+        self,
+        batch_size: int = DEFAULT_BATCH_SIZE,
+        update_existing: bool = False,
+        dry_run: bool = False,
+    ) -> None:
+        self.batch_size = batch_size
+        self.update_existing = update_existing
+        self.dry_run = dry_run
+        self.stats = BulkImportStats()
+        self._touched_mechanisms: Set[int] = set()
+        self._touched_projects: Set[int] = set()
+
+    def import_rows(self, rows: Iterable[Dict[str, Any]]) -> BulkImportStats:
+        """Import an iterable of processed rows in ``batch_size`` chunks."""
+        batch: List[Dict[str, Any]] = []
+        for row in rows:
+            batch.append(row)
+            if len(batch) >= self.batch_size:
+                self.import_batch(batch)
+                batch = []
+        if batch:
+            self.import_batch(batch)
+        return self.finish()
+
+    def import_batch(self, rows: List[Dict[str, Any]]) -> None:
+        """Diff one batch against the database and write it in a transaction."""
+        # Later rows win when a batch repeats an obligation number
+        incoming: Dict[str, Dict[str, Any]] = {}
+        for row in rows:
+            number = coerce_obligation_number(row["obligation_number"])
+            incoming[number] = {**row, "obligation_number": number}
+        self.stats.rows += len(rows)
+        self.stats.skipped += len(rows) - len(incoming)
+
+        started = time.perf_counter()
+        if self.update_existing:
+            existing = Obligation.objects.in_bulk(list(incoming))
+        else:
+            existing = dict.fromkeys(
+                Obligation.objects.filter(
+                    obligation_number__in=list(incoming)
+                ).values_list("obligation_number", flat=True)
+            )
+
+        to_create: List[Obligation] = []
+        to_update: List[Obligation] = []
+        for number, data in incoming.items():
+            if number not in existing:
+                to_create.append(self._build(data))
+            elif self.update_existing:
+                to_update.append(self._apply(existing[number], data))
+            else:
+                self.stats.skipped += 1
+
+        if not self.dry_run:
+            with transaction.atomic():
+                Obligation.objects.bulk_create(to_create, batch_size=self.batch_size)
+                if to_update:
+                    Obligation.objects.bulk_update(
+                        to_update, self._update_fields(), batch_size=self.batch_size
+                    )
+                self._observe_numbers(incoming)
+                # bulk writes skip the save signal that keeps search in sync
+                index_obligations(list(incoming))
+
+        self.stats.created += len(to_create)
+        self.stats.updated += len(to_update)
+        self.stats.write_seconds += time.perf_counter() - started
+
+    def finish(self) -> BulkImportStats:
+        """Recount touched mechanisms and retire cached data once per import."""
+        if not self.dry_run:
+            update_mechanism_counts(self._touched_mechanisms)
+            # bulk writes skip the save signals that normally retire charts
+            # and cached dashboard data
+            bump_chart_cache_version()
+            for project_id in self._touched_projects:
+                dashboard_data_updated.send(
+                    sender=Obligation, obligation_id=None, project_id=project_id
+                )
+        self._touched_mechanisms = set()
+        self._touched_projects = set()
+        return self.stats
+
+    def _build(self, data: Dict[str, Any]) -> Obligation:
+        """Create an unsaved obligation, applying the rules pre_save would."""
+        obligation = Obligation(**data)
+        obligation.update_recurring_forecasted_date()
+        self._track(obligation)
+        return obligation
+
+    def _apply(self, obligation: Obligation, data: Dict[str, Any]) -> Obligation:
+        """Copy incoming values onto an existing obligation."""
+        # Recount the mechanism an obligation is moved away from as well
+        self._track(obligation)
+        for key, value in data.items():
+            if key != "obligation_number":
+                setattr(obligation, key, value)
+        obligation.updated_at = timezone.now()
+        self._track(obligation)
+        return obligation
+
+    def _track(self, obligation: Obligation) -> None:
+        mechanism_id = obligation.primary_environmental_mechanism_id
+        if mechanism_id:
+            self._touched_mechanisms.add(mechanism_id)
+        if obligation.project_id:
+            self._touched_projects.add(obligation.project_id)
+
+    @staticmethod
+    def _update_fields() -> List[str]:
+        return [
+            f.name
+            for f in Obligation._meta.concrete_fields
+            if not f.primary_key and f.name != "created_at"
+        ]
+
+    @staticmethod
+    def _observe_numbers(incoming: Dict[str, Dict[str, Any]]) -> None:
+        """Advance the number sequence past the highest imported number."""
+        numbers = [
+            int(match.group(1))
+            for match in map(OBLIGATION_NUMBER_PATTERN.match, incoming)
+            if match
+        ]
+        if numbers:
+            ObligationNumberSequence.observe(format_obligation_number(max(numbers)))
@@ -0,0 +1,288 @@
+"""Streaming obligation exports in CSV, XLSX and Parquet.
+
+Rows are read through a server-side cursor (``iterate_queryset``) and
+written as they arrive. CSV is streamed straight to the client; XLSX
+(openpyxl write-only mode) and Parquet (pyarrow, one row group per chunk)
+are spooled to a temporary file first, since both formats are finished
+only when the writer closes. Memory stays flat however many rows a
+project has. Under ASGI the view hands both to ``stream_async``, which
+pulls each chunk through ``sync_to_async``: one thread hop per 2000-row
+chunk (or 64 KiB of spooled file) instead of Django reading the whole
+export into a list before sending it. The spool keeps XLSX and Parquet
+on disk rather than in memory, at the cost of a temporary file as large
+as the export.
+
+The columns use the headers ``import_obligations`` reads, so a CSV export
+can be fed back with ``import_obligations --bulk``; ``read_export_rows``
+also reads the XLSX and Parquet files back. Mechanism names and evidence
+metadata (count, file names and SHA-256 digests) are included; the
+importer ignores the columns it does not know.
+"""
+
+import csv
+import importlib.util
+import io
+import tempfile
+from typing import IO, Any, Dict, Iterable, Iterator, List, Optional, Tuple
+
+from core.utils.db import iterate_queryset
+from django.db.models import QuerySet
+
+from .models import Obligation, ObligationEvidence
+
+EXPORT_FORMATS = ("csv", "xlsx", "parquet")
+EXPORT_CONTENT_TYPES = {
+    "csv": "text/csv",
+    "xlsx": "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
+    "parquet": "application/vnd.apache.parquet",
+}
+EXPORT_CHUNK_SIZE = 2000
+
+# (import header, value path, kind); kinds pick the Parquet column type
+EXPORT_COLUMNS: Tuple[Tuple[str, str, str], ...] = (
+    ("obligation__number", "obligation_number", "text"),
+    ("project", "project__name", "text"),
+    (
+        "primary__environmental__mechanism",
+        "primary_environmental_mechanism__name",
+        "text",
+    ),
+    ("procedure", "procedure", "text"),
+    ("environmental__aspect", "environmental_aspect", "text"),
+    ("obligation", "obligation", "text"),
+    ("accountability", "accountability", "text"),
+    ("responsibility", "responsibility", "text"),
+    ("project_phase", "project_phase", "text"),
+    ("action__due_date", "action_due_date", "date"),
+    ("close__out__date", "close_out_date", "date"),
+    ("status", "status", "text"),
+    ("supporting__information", "supporting_information", "text"),
+    ("general__comments", "general_comments", "text"),
+    ("compliance__comments", "compliance_comments", "text"),
+    ("non_conformance__comments", "non_conformance_comments", "text"),
+    ("evidence", "evidence_notes", "text"),
+    ("recurring__obligation", "recurring_obligation", "bool"),
+    ("recurring__frequency", "recurring_frequency", "text"),
+    ("recurring__status", "recurring_status", "text"),
+    ("recurring__forcasted__date", "recurring_forcasted_date", "date"),
+    ("inspection", "inspection", "bool"),
+    ("inspection__frequency", "inspection_frequency", "text"),
+    ("site_or__desktop", "site_or_desktop", "text"),
+    ("gap__analysis", "gap_analysis", "bool"),
+    ("notes_for__gap__analysis", "notes_for_gap_analysis", "text"),
+)
+# Evidence metadata, filled in per chunk
+EVIDENCE_COLUMNS: Tuple[Tuple[str, str], ...] = (
+    ("evidence__count", "int"),
+    ("evidence__files", "text"),
+    ("evidence__sha256", "text"),
+)
+EXPORT_HEADERS: List[str] = [column[0] for column in EXPORT_COLUMNS] + [
+    column[0] for column in EVIDENCE_COLUMNS
+]
+EVIDENCE_SEPARATOR = ";"
+
+
+class ExportDependencyError(RuntimeError):
+    """Raised when the library an export format needs is not installed."""
+
+
+def export_queryset(project_ids: Optional[Iterable[int]] = None) -> QuerySet:
+    """Obligations to export, as value rows in obligation number order."""
+    queryset = Obligation.objects.all()
+    if project_ids is not None:
+        queryset = queryset.filter(project_id__in=list(project_ids))
+    return queryset.order_by("obligation_number").values(
+        *(column[1] for column in EXPORT_COLUMNS)
+    )
+
+
+def _evidence_by_obligation(numbers: List[str]) -> Dict[str, List[Tuple[str, str]]]:
+    evidence: Dict[str, List[Tuple[str, str]]] = {}
+    rows = (
+        ObligationEvidence.objects.filter(obligation_id__in=numbers)
+        .order_by("uploaded_at", "id")
+        .values_list("obligation_id", "original_name", "file", "sha256")
+    )
+    for obligation_id, original_name, file_name, sha256 in rows:
+        name = original_name or file_name.rsplit("/", 1)[-1]
+        evidence.setdefault(obligation_id, []).append((name, sha256))
+    return evidence
+
+
+def _export_row(
+    values: Dict[str, Any], evidence: List[Tuple[str, str]]
+) -> Dict[str, Any]:
+    row: Dict[str, Any] = {}
+    for header, path, kind in EXPORT_COLUMNS:
+        value = values[path]
+        # The importer reads text columns as strings; keep blanks, not NULLs
+        row[header] = "" if value is None and kind == "text" else value
+    row["evidence__count"] = len(evidence)
+    row["evidence__files"] = EVIDENCE_SEPARATOR.join(name for name, _ in evidence)
+    row["evidence__sha256"] = EVIDENCE_SEPARATOR.join(sha for _, sha in evidence)
+    return row
+
+
+def iter_export_chunks(
+    queryset: QuerySet, chunk_size: int = EXPORT_CHUNK_SIZE
+) -> Iterator[List[Dict[str, Any]]]:
+    """Yield export rows in chunks, loading evidence once per chunk."""
+    chunk: List[Dict[str, Any]] = []
+
+    def finish(values_chunk: List[Dict[str, Any]]) -> List[Dict[str, Any]]:
+        evidence = _evidence_by_obligation(
+            [values["obligation_number"] for values in values_chunk]
+        )
+        return [
+            _export_row(values, evidence.get(values["obligation_number"], []))
+            for values in values_chunk
+        ]
+
+    for values in iterate_queryset(queryset, chunk_size=chunk_size):
+        chunk.append(values)
+        if len(chunk) >= chunk_size:
+            yield finish(chunk)
+            chunk = []
+    if chunk:
+        yield finish(chunk)
+
+
+class _LineBuffer:
+    """File-like object handing back what csv.writer writes."""
+
+    def write(self, value: str) -> str:
+        return value
+
+
+def stream_csv(chunks: Iterable[List[Dict[str, Any]]]) -> Iterator[bytes]:
+    """Yield the CSV export one chunk of rows at a time."""
+    writer = csv.DictWriter(_LineBuffer(), fieldnames=EXPORT_HEADERS)
+    yield writer.writeheader().encode("utf-8")
+    for chunk in chunks:
+        yield "".join(writer.writerow(row) for row in chunk).encode("utf-8")
+
+
+def write_csv(chunks: Iterable[List[Dict[str, Any]]], stream: IO[bytes]) -> None:
+    """Write the CSV export to a binary stream."""
+    for data in stream_csv(chunks):
+        stream.write(data)
+
+
+def write_xlsx(chunks: Iterable[List[Dict[str, Any]]], stream: IO[bytes]) -> None:
+    """Write the export with openpyxl's write-only (streaming) workbook."""
+    try:
+        from openpyxl import Workbook
+    except ImportError as e:
+        raise ExportDependencyError("XLSX export needs the openpyxl package") from e
+
+    workbook = Workbook(write_only=True)
+    sheet = workbook.create_sheet("Obligations")
+    sheet.append(EXPORT_HEADERS)
+    for chunk in chunks:
+        for row in chunk:
+            sheet.append([row[header] for header in EXPORT_HEADERS])
+    workbook.save(stream)
+
+
+def _parquet_schema():
+    import pyarrow as pa
+
+    types = {
+        "text": pa.string(),
+        "date": pa.date32(),
+        "bool": pa.bool_(),
+        "int": pa.int32(),
+    }
+    return pa.schema(
+        [(header, types[kind]) for header, _, kind in EXPORT_COLUMNS]
+        + [(header, types[kind]) for header, kind in EVIDENCE_COLUMNS]
+    )
+
+
+def write_parquet(chunks: Iterable[List[Dict[str, Any]]], stream: IO[bytes]) -> None:
+    """Write the export with pyarrow, one row group per chunk."""
+    try:
+        import pyarrow as pa
+        import pyarrow.parquet as pq
+    except ImportError as e:
+        raise ExportDependencyError("Parquet export needs the pyarrow package") from e
+
+    schema = _parquet_schema()
+    with pq.ParquetWriter(stream, schema) as writer:
+        for chunk in chunks:
+            writer.write_table(pa.Table.from_pylist(chunk, schema=schema))
+
+
+EXPORT_WRITERS = {"csv": write_csv, "xlsx": write_xlsx, "parquet": write_parquet}
+EXPORT_DEPENDENCIES = {"xlsx": "openpyxl", "parquet": "pyarrow"}
+
+
+def require_export_format(fmt: str) -> None:
+    """
+    Check an export format is known and its library is installed.
+
+    Raises:
+        ValueError: If the format is unknown
+        ExportDependencyError: If its library is missing
+    """
+    if fmt not in EXPORT_WRITERS:
+        raise ValueError(f"Unknown export format: {fmt}")
+    module = EXPORT_DEPENDENCIES.get(fmt)
+    if module and importlib.util.find_spec(module) is None:
+        raise ExportDependencyError(f"{fmt.upper()} export needs the {module} package")
+
+
+def export_to_file(
+    fmt: str, chunks: Iterable[List[Dict[str, Any]]], stream: Optional[IO[bytes]] = None
+) -> IO[bytes]:
+    """
+    Write an export to ``stream`` (default: a new temporary file).
+
+    Returns:
+        The stream, rewound to its start
+    """
+    require_export_format(fmt)
+    if stream is None:
+        stream = tempfile.TemporaryFile()
+    EXPORT_WRITERS[fmt](chunks, stream)
+    stream.seek(0)
+    return stream
+
+
+def read_export_rows(path: str) -> Iterator[Dict[str, Any]]:
+    """
+    Read rows back from a CSV, XLSX or Parquet export, one at a time.
+
+    Raises:
+        ExportDependencyError: If the format's library is not installed
+    """
+    lower = path.lower()
+    if lower.endswith(".xlsx"):
+        try:
+            from openpyxl import load_workbook
+        except ImportError as e:
+            raise ExportDependencyError("XLSX import needs the openpyxl package") from e
+        workbook = load_workbook(path, read_only=True)
+        try:
+            rows = workbook.active.iter_rows(values_only=True)
+            headers = [str(header) for header in next(rows, ())]
+            for values in rows:
+                yield {
+                    header: "" if value is None else value
+                    for header, value in zip(headers, values)
+                }
+        finally:
+            workbook.close()
+    elif lower.endswith(".parquet"):
+        try:
+            import pyarrow.parquet as pq
+        except ImportError as e:
+            raise ExportDependencyError(
+                "Parquet import needs the pyarrow package"
+            ) from e
+        for batch in pq.ParquetFile(path).iter_batches(batch_size=EXPORT_CHUNK_SIZE):
+            yield from batch.to_pylist()
+    else:
+        with io.open(path, "r", encoding="utf-8", newline="") as csv_file:
+            yield from csv.DictReader(csv_file)
@@ -691,10 +691,10 @@ def clean_file(self):
                 )
 
             # Check if this obligation already has 5 files
-            if self.instance and self.instance.obligation:
+            if self.instance and self.instance.obligation_id:
                 if (
                     ObligationEvidence.objects.filter(
-                        obligation=self.instance.obligation
+                        obligation_id=self.instance.obligation_id
                     ).count()
                     >= 5
                 ):
@@ -1,23 +1,39 @@
+import codecs
 import logging
 import os
 import re
+import time
+from typing import Any, Dict, Iterator
 
 from django.core.management.base import BaseCommand
 
 # Set up logger at module level
 logger = logging.getLogger(__name__)
 
-# Check for pandas and numpy before importing
-try:
-    import numpy as np
-    import pandas as pd
-    PANDAS_AVAILABLE = True
-except ImportError:
-    PANDAS_AVAILABLE = False
-    logger.error(
-        "pandas and/or numpy modules not found. Please install them with: "
-        "pip install pandas numpy"
-    )
+# pandas and numpy are bound by _import_pandas() when the command runs, so
+# merely loading the module (command discovery, test collection) stays cheap
+np: Any = None
+pd: Any = None
+
+
+def _import_pandas() -> bool:
+    """Import pandas and numpy into this module; False if either is missing."""
+    global np, pd  # pylint: disable=global-statement
+    try:
+        # pylint: disable=import-outside-toplevel
+        import numpy
+        import pandas
+    except ImportError:
+        logger.error(
+            "pandas and/or numpy modules not found. Please install them with: "
+            "pip install pandas numpy"
+        )
+        return False
+    np, pd = numpy, pandas
+    return True
+
+# Rows read and cleaned per pandas chunk; bounds peak memory
+DEFAULT_CHUNKSIZE = 5000
 
 
 class Command(BaseCommand):
@@ -40,6 +56,47 @@ def add_arguments(self, parser):
             help='Path where the cleaned CSV will be saved',
             default='clean_output_with_nulls.csv'
         )
+        parser.add_argument(
+            '--chunksize',
+            type=int,
+            default=DEFAULT_CHUNKSIZE,
+            help=f'Rows to read and clean per chunk (default: {DEFAULT_CHUNKSIZE})'
+        )
+        parser.add_argument(
+            '--import',
+            dest='import_into_db',
+            action='store_true',
+            help=(
+                'Stream cleaned chunks straight into the bulk obligation '
+                'importer instead of writing a cleaned CSV'
+            )
+        )
+        parser.add_argument(
+            '--project',
+            type=str,
+            help='Project name to import into (required with --import)'
+        )
+        parser.add_argument(
+            '--update',
+            action='store_true',
+            help='Update existing obligations when importing'
+        )
+        parser.add_argument(
+            '--batch-size',
+            type=int,
+            default=500,
+            help='Rows per database batch when importing (default: 500)'
+        )
+        parser.add_argument(
+            '--dry-run',
+            action='store_true',
+            help='Clean and diff rows without writing to the database'
+        )
+        parser.add_argument(
+            '--continue-on-error',
+            action='store_true',
+            help='Skip rows that fail to process when importing'
+        )
 
     def handle(self, *args, **options):
         """
@@ -49,7 +106,7 @@ def handle(self, *args, **options):
             input_file: Path to the dirty CSV file
             output_file: Path where the cleaned CSV will be saved
         """
-        if not PANDAS_AVAILABLE:
+        if not _import_pandas():
             self.stderr.write(
                 self.style.ERROR(
                     "This command requires pandas and numpy. "
@@ -68,7 +125,16 @@ def handle(self, *args, **options):
             return
 
         try:
-            self.clean_csv(file_path, out_path)
+            if options['import_into_db']:
+                if not options.get('project'):
+                    self.stderr.write(
+                        self.style.ERROR("--project is required with --import")
+                    )
+                    return
+                self.clean_and_import(file_path, options)
+                return
+
+            self.clean_csv(file_path, out_path, chunksize=options['chunksize'])
             self.stdout.write(
                 self.style.SUCCESS(
                     f"Successfully cleaned CSV data and saved to {out_path}"
@@ -92,31 +158,137 @@ def handle(self, *args, **options):
                 self.style.ERROR(f"Unexpected error cleaning CSV: {str(e)}")
             )
 
-    def clean_csv(self, filepath: str, outpath: str) -> None:
+    def clean_csv(
+        self, filepath: str, outpath: str, chunksize: int = DEFAULT_CHUNKSIZE
+    ) -> None:
         """
         Clean and format CSV data to match Django models schema.
 
+        The file is processed in fixed-size chunks, each appended to the
+        output as soon as it is cleaned, so memory stays bounded.
+
         Args:
             filepath: Path to the dirty CSV file
             outpath: Path where the cleaned CSV will be saved
+            chunksize: Rows to read and clean per chunk
         """
-        logger.info("Reading CSV file from %s", filepath)
+        timings = self._new_timings()
+        rows = 0
+        columns = 0
+
+        chunks = self.iter_clean_chunks(filepath, chunksize, timings)
+        for index, df in enumerate(chunks):
+            started = time.perf_counter()
+            # Export with proper date formatting; header only on the first chunk
+            df.to_csv(
+                outpath,
+                mode='w' if index == 0 else 'a',
+                header=index == 0,
+                index=False,
+                date_format='%Y-%m-%d',
+            )
+            timings['write'] += time.perf_counter() - started
+            rows += len(df)
+            columns = len(df.columns)
 
-        # Read the dirty CSV file, handling potential encoding issues
-        try:
-            df = pd.read_csv(filepath, encoding='utf-8')
-        except UnicodeDecodeError:
-            # Try with another common encoding if utf-8 fails
-            df = pd.read_csv(filepath, encoding='ISO-8859-1')
+        logger.info("Cleaned data exported to %s", outpath)
+        self.stdout.write(f"CSV exported {rows} rows and {columns} columns")
+        self._report_timings(timings)
 
-        # Skip header row if it contains instructions instead of data
-        if (df.shape[0] > 0 and
-                ('project name' in str(df.iloc[0].values).lower() or
-                 'this is now the project name' in str(df.iloc[0].values).lower())):
-            self.stdout.write("Skipping instruction row")
-            df = df.iloc[1:].reset_index(drop=True)
+    def clean_and_import(self, filepath: str, options: Dict[str, Any]) -> None:
+        """
+        Clean the CSV chunk by chunk and feed rows to the bulk importer.
+
+        No intermediate file is written; each cleaned chunk is converted to
+        import rows and written with import_obligations' --bulk path.
+        """
+        # pylint: disable=import-outside-toplevel
+        from obligations.management.commands.import_obligations import (
+            Command as ImportCommand,
+        )
+
+        importer = ImportCommand(stdout=self.stdout, stderr=self.stderr)
+        project = importer._get_or_create_project(options['project'])
+        if not project:
+            self.stderr.write(
+                self.style.ERROR(
+                    f"Failed to get/create project: {options['project']}"
+                )
+            )
+            return
+
+        if options.get('dry_run'):
+            self.stdout.write("DRY RUN - No changes will be made")
+
+        timings = self._new_timings()
+        started = time.perf_counter()
+        stats = importer.bulk_import_rows(
+            self._iter_import_rows(filepath, options['chunksize'], timings),
+            project,
+            options,
+        )
+        timings['import'] = (
+            time.perf_counter() - started - timings['read'] - timings['clean']
+        )
+        timings['write'] = stats.write_seconds
 
-        df = self._map_columns(df)
+        importer.report_bulk_stats(stats)
+        self._report_timings(timings)
+
+    def iter_clean_chunks(
+        self,
+        filepath: str,
+        chunksize: int = DEFAULT_CHUNKSIZE,
+        timings: Dict[str, float] | None = None,
+    ) -> Iterator["pd.DataFrame"]:
+        """
+        Yield cleaned DataFrames of at most ``chunksize`` rows.
+
+        Args:
+            filepath: Path to the dirty CSV file
+            chunksize: Rows to read per chunk
+            timings: Optional dict accumulating 'read' and 'clean' seconds
+        """
+        if timings is None:
+            timings = self._new_timings()
+
+        logger.info("Reading CSV file from %s", filepath)
+        encoding = self._detect_encoding(filepath)
+
+        with pd.read_csv(filepath, encoding=encoding, chunksize=chunksize) as reader:
+            first_chunk = True
+            while True:
+                started = time.perf_counter()
+                try:
+                    df = next(reader)
+                except StopIteration:
+                    break
+                timings['read'] += time.perf_counter() - started
+
+                started = time.perf_counter()
+                if first_chunk:
+                    df = self._skip_instruction_row(df)
+                df = self._clean_frame(df, report_columns=first_chunk)
+                first_chunk = False
+                timings['clean'] += time.perf_counter() - started
+
+                yield df
+
+    def _iter_import_rows(
+        self, filepath: str, chunksize: int, timings: Dict[str, float]
+    ) -> Iterator[Dict[str, str]]:
+        """Yield cleaned rows shaped like csv.DictReader output."""
+        for df in self.iter_clean_chunks(filepath, chunksize, timings):
+            for record in df.to_dict('records'):
+                # Match what a round trip through the cleaned CSV would produce
+                yield {
+                    key: '' if value is None else str(value)
+                    for key, value in record.items()
+                }
+
+    def _clean_frame(self, df, report_columns: bool = True):
+        """Apply every cleaning transform to one chunk."""
+        df = self._map_columns(df, report_columns=report_columns)
         df = self._clean_text_fields(df)
         df = self._process_boolean_fields(df)
         df = self._clean_date_fields(df)
@@ -127,13 +299,51 @@ def clean_csv(self, filepath: str, outpath: str) -> None:
         df = self._clean_email_addresses(df)
         df = self._format_obligation_numbers(df)
         df = self._apply_defaults_and_nulls(df)
+        return df
 
-        # Export the cleaned data to a new CSV file with proper date formatting
-        df.to_csv(outpath, index=False, date_format='%Y-%m-%d')
-        logger.info("Cleaned data exported to %s", outpath)
-        self.stdout.write(f"CSV exported {len(df)} rows and {len(df.columns)} columns")
+    def _skip_instruction_row(self, df):
+        """Drop the first row if it holds instructions instead of data."""
+        if (df.shape[0] > 0 and
+                ('project name' in str(df.iloc[0].values).lower() or
+                 'this is now the project name' in str(df.iloc[0].values).lower())):
+            self.stdout.write("Skipping instruction row")
+            df = df.iloc[1:].reset_index(drop=True)
+        return df
+
+    @staticmethod
+    def _detect_encoding(filepath: str, block_size: int = 1 << 20) -> str:
+        """
+        Return 'utf-8' if the whole file decodes as UTF-8, else 'ISO-8859-1'.
 
-    def _map_columns(self, df):
+        Decodes incrementally in fixed-size blocks so the check never holds
+        more than one block in memory.
+        """
+        decoder = codecs.getincrementaldecoder('utf-8')()
+        try:
+            with open(filepath, 'rb') as raw:
+                while block := raw.read(block_size):
+                    decoder.decode(block)
+                decoder.decode(b'', final=True)
+        except UnicodeDecodeError:
+            # Fall back to another common encoding if utf-8 fails
+            return 'ISO-8859-1'
+        return 'utf-8'
+
+    @staticmethod
+    def _new_timings() -> Dict[str, float]:
+        return {'read': 0.0, 'clean': 0.0, 'import': 0.0, 'write': 0.0}
+
+    def _report_timings(self, timings: Dict[str, float]) -> None:
+        """Write the per-stage timings so slow stages are easy to spot."""
+        self.stdout.write(
+            "Stage timings: " + ", ".join(
+                f"{stage} {seconds:.2f}s"
+                for stage, seconds in timings.items()
+                if seconds
+            )
+        )
+
+    def _map_columns(self, df, report_columns: bool = True):
         """Map original column names to our expected format."""
         # Define the column mapping based on clean_output_with_nulls.csv
         column_mapping = {
@@ -167,15 +377,18 @@ def _map_columns(self, df):
             'Notes for Gap Analysis': 'notes_for__gap__analysis'
         }
 
-        # Print available columns in the CSV for debugging
-        self.stdout.write(f"Available columns in CSV: {df.columns.tolist()}")
+        # Print available columns in the CSV for debugging (first chunk only)
+        if report_columns:
+            self.stdout.write(f"Available columns in CSV: {df.columns.tolist()}")
 
-        # Check if all expected columns exist
-        for original_col in column_mapping:
-            if original_col not in df.columns:
-                self.stdout.write(
-                    self.style.WARNING(f"Column not found in CSV: '{original_col}'")
-                )
+            # Check if all expected columns exist
+            for original_col in column_mapping:
+                if original_col not in df.columns:
+                    self.stdout.write(
+                        self.style.WARNING(
+                            f"Column not found in CSV: '{original_col}'"
+                        )
+                    )
 
         # Rename the columns
         df.rename(columns=column_mapping, inplace=True)
@@ -186,7 +399,8 @@ def _map_columns(self, df):
 
         for col in missing_columns:
             df[col] = None
-            logger.warning("Added missing column: %s", col)
+            if report_columns:
+                logger.warning("Added missing column: %s", col)
 
         return df
 
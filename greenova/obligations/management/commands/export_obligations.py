@@ -0,0 +1,96 @@
+import logging
+import os
+import sys
+from typing import Any
+
+from django.core.management.base import BaseCommand, CommandError, CommandParser
+from obligations.exports import (
+    EXPORT_CHUNK_SIZE,
+    EXPORT_FORMATS,
+    ExportDependencyError,
+    export_queryset,
+    export_to_file,
+    iter_export_chunks,
+    require_export_format,
+)
+from projects.models import Project
+
+logger = logging.getLogger(__name__)
+
+
+class Command(BaseCommand):
+    help = (
+        'Export obligations to CSV, XLSX or Parquet with flat memory use; '
+        'CSV output can be re-imported with import_obligations --bulk'
+    )
+
+    def add_arguments(self, parser: CommandParser) -> None:
+        parser.add_argument(
+            'output',
+            type=str,
+            help="File to write, or '-' for CSV on standard output",
+        )
+        parser.add_argument(
+            '--format',
+            choices=EXPORT_FORMATS,
+            help='Output format (default: from the file extension, else csv)',
+        )
+        parser.add_argument(
+            '--project',
+            action='append',
+            dest='projects',
+            help='Only export this project, by name (repeatable)',
+        )
+        parser.add_argument(
+            '--chunk-size',
+            type=int,
+            default=EXPORT_CHUNK_SIZE,
+            help=f'Rows fetched per batch (default: {EXPORT_CHUNK_SIZE})',
+        )
+
+    def handle(self, *args: Any, **options: Any) -> None:
+        output = options['output']
+        fmt = options.get('format')
+        if not fmt:
+            extension = os.path.splitext(output)[1].lstrip('.').lower()
+            fmt = extension if extension in EXPORT_FORMATS else 'csv'
+        if output == '-' and fmt != 'csv':
+            raise CommandError('Only CSV can be written to standard output')
+        try:
+            require_export_format(fmt)
+        except ExportDependencyError as e:
+            raise CommandError(str(e)) from e
+
+        project_ids = None
+        if options.get('projects'):
+            projects = dict(
+                Project.objects.filter(name__in=options['projects'])
+                .values_list('name', 'id')
+            )
+            missing = set(options['projects']) - set(projects)
+            if missing:
+                raise CommandError(f"Unknown project(s): {', '.join(sorted(missing))}")
+            project_ids = projects.values()
+
+        rows = 0
+
+        def counted(chunks):
+            nonlocal rows
+            for chunk in chunks:
+                rows += len(chunk)
+                yield chunk
+
+        chunks = counted(
+            iter_export_chunks(
+                export_queryset(project_ids), chunk_size=options['chunk_size']
+            )
+        )
+        if output == '-':
+            export_to_file(fmt, chunks, sys.stdout.buffer)
+            return
+        with open(output, 'wb') as stream:
+            export_to_file(fmt, chunks, stream)
+
+        self.stdout.write(self.style.SUCCESS(
+            f'Exported {rows} obligations to {output} ({fmt})'
+        ))
@@ -2,7 +2,18 @@
 import logging
 import os
 from pathlib import Path
-from typing import TYPE_CHECKING, Any, Dict, Optional, Tuple, TypedDict, Union, cast
+from typing import (
+    TYPE_CHECKING,
+    Any,
+    Dict,
+    Iterable,
+    Iterator,
+    Optional,
+    Tuple,
+    TypedDict,
+    Union,
+    cast,
+)
 
 import django
 from django.core.management.base import BaseCommand, CommandParser
@@ -12,10 +23,17 @@
 from django.utils import timezone
 from django.utils.dateparse import parse_date
 
-from ....mechanisms.models import EnvironmentalMechanism
-from ....obligations.models import Obligation
-from ....obligations.utils import normalize_frequency
-from ....projects.models import Project  # Ensure this is the correct import path
+from mechanisms.models import EnvironmentalMechanism
+from obligations.bulk_import import (
+    DEFAULT_BATCH_SIZE,
+    BulkImportStats,
+    BulkObligationImporter,
+    MechanismResolver,
+)
+from obligations.exports import ExportDependencyError, read_export_rows
+from obligations.models import Obligation
+from obligations.utils import normalize_frequency
+from projects.models import Project  # Ensure this is the correct import path
 
 if not hasattr(Project, 'objects') or not isinstance(Project.objects, Manager):
     raise ImportError("The Project model is missing a valid 'objects' manager. "
@@ -76,6 +94,9 @@ class ObligationData(TypedDict, total=False):
     notes_for_gap_analysis: str
 
 class Command(BaseCommand):
+    # Set while a --bulk import runs so mechanisms resolve from memory
+    mechanism_resolver: Optional[MechanismResolver] = None
+
     OBLIGATION_PREFIX_MAPPING: Dict[str, str] = {
         'PREFIX1': 'NormalizedPrefix1',
         'PREFIX2': 'NormalizedPrefix2',
@@ -101,30 +122,90 @@ def handle(self, *args: Any, **options: Any) -> None:
                 self.stderr.write(f"Failed to get/create project: {project_name}")
                 return
 
-            # Process CSV file
-            with csv_path.open('r', encoding='utf-8') as csv_file:
-                reader = csv.DictReader(csv_file)
-
-                if options['dry_run']:
-                    self.stdout.write("DRY RUN - No changes will be made")
-
-                for row in reader:
-                    try:
-                        with transaction.atomic():
-                            self._process_obligation_row(row, project, options)
-                    except (ValueError, DatabaseError, KeyError) as e:
-                        error_msg = f"Error processing row: {e}"
-                        if options['continue_on_error']:
-                            self.stderr.write(error_msg)
-                            continue
-                        raise
-
-        except (OSError, csv.Error, DatabaseError) as e:
+            # Rows stream from CSV, or from an export_obligations XLSX/Parquet file
+            reader = read_export_rows(str(csv_path))
+
+            if options['dry_run']:
+                self.stdout.write("DRY RUN - No changes will be made")
+
+            if options['bulk']:
+                self.report_bulk_stats(
+                    self.bulk_import_rows(reader, project, options)
+                )
+                return
+
+            for row in reader:
+                try:
+                    with transaction.atomic():
+                        self._process_obligation_row(row, project, options)
+                except (ValueError, DatabaseError, KeyError) as e:
+                    error_msg = f"Error processing row: {e}"
+                    if options['continue_on_error']:
+                        self.stderr.write(error_msg)
+                        continue
+                    raise
+
+        except (OSError, csv.Error, DatabaseError, ExportDependencyError) as e:
             self.stderr.write(f"Failed to import obligations: {e}")
             return
 
         self.stdout.write(self.style.SUCCESS("Successfully imported obligations"))
 
+    def bulk_import_rows(
+        self,
+        rows: Iterable[Dict[str, Any]],
+        project: Project,
+        options: Dict[str, Any]
+    ) -> BulkImportStats:
+        """
+        Import raw CSV rows with set-based writes.
+
+        Rows are cleaned with process_row(), diffed against existing
+        obligation numbers and written with bulk_create/bulk_update in
+        batches. Per-row save signals are not fired; mechanism counts are
+        recomputed once at the end.
+        """
+        importer = BulkObligationImporter(
+            batch_size=options.get('batch_size') or DEFAULT_BATCH_SIZE,
+            update_existing=options.get('update', False),
+            dry_run=options.get('dry_run', False),
+        )
+        self.mechanism_resolver = MechanismResolver(
+            project, create_missing=not importer.dry_run
+        )
+        try:
+            return importer.import_rows(
+                self._iter_processed_rows(rows, project, importer, options)
+            )
+        finally:
+            self.mechanism_resolver = None
+
+    def _iter_processed_rows(
+        self,
+        rows: Iterable[Dict[str, Any]],
+        project: Project,
+        importer: BulkObligationImporter,
+        options: Dict[str, Any]
+    ) -> Iterator[Dict[str, Any]]:
+        for row in rows:
+            try:
+                yield dict(self.process_row(row, project))
+            except (ValueError, KeyError) as e:
+                importer.stats.failed += 1
+                if not options.get('continue_on_error'):
+                    raise
+                self.stderr.write(f"Error processing row: {e}")
+
+    def report_bulk_stats(self, stats: BulkImportStats) -> None:
+        """Write a summary line with throughput for a bulk import."""
+        self.stdout.write(self.style.SUCCESS(
+            f"Bulk import finished: {stats.rows} rows in {stats.elapsed:.2f}s "
+            f"({stats.rows_per_second:.0f} rows/s) - "
+            f"{stats.created} created, {stats.updated} updated, "
+            f"{stats.skipped} skipped, {stats.failed} failed "
+            f"(DB writes {stats.write_seconds:.2f}s)"
+        ))
+
     def _get_or_create_project(self, project_name: str) -> Optional[Project]:
         """Get existing project or create new one."""
         if not hasattr(Project, 'objects') or not isinstance(Project.objects, Manager):
@@ -182,7 +263,10 @@ def add_arguments(self, parser: CommandParser) -> None:
         parser.add_argument(
             'csv_file',
             type=str,
-            help='Path to the CSV file containing obligations data',
+            help=(
+                'Path to the CSV file containing obligations data '
+                '(or an XLSX/Parquet file from export_obligations)'
+            ),
         )
         parser.add_argument(
             '--project',
@@ -204,6 +288,20 @@ def add_arguments(self, parser: CommandParser) -> None:
             action='store_true',
             help='Continue processing rows even if some fail',
         )
+        parser.add_argument(
+            '--bulk',
+            action='store_true',
+            help=(
+                'Import with batched bulk_create/bulk_update instead of '
+                'saving row by row (skips per-row signals)'
+            )
+        )
+        parser.add_argument(
+            '--batch-size',
+            type=int,
+            default=DEFAULT_BATCH_SIZE,
+            help=f'Rows per batch in --bulk mode (default: {DEFAULT_BATCH_SIZE})',
+        )
         parser.add_argument(
             '--no-transaction',
             action='store_true',
@@ -250,6 +348,9 @@ def get_or_create_mechanism(
         if not mechanism_name:
             return None, False
 
+        if self.mechanism_resolver is not None:
+            return self.mechanism_resolver.resolve(mechanism_name), False
+
         mechanism_name = mechanism_name.strip()
 
         mechanism = self._retrieve_mechanism(mechanism_name, project)
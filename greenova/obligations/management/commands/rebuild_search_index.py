@@ -0,0 +1,26 @@
+import logging
+
+from django.core.management.base import BaseCommand
+from django.db import transaction
+from obligations.search import ensure_search_index, rebuild_search_index, search_vendor
+
+logger = logging.getLogger(__name__)
+
+class Command(BaseCommand):
+    help = 'Create (if needed) and rebuild the obligation full-text search index'
+
+    def handle(self, *args, **options):
+        if ensure_search_index():
+            self.stdout.write(self.style.SUCCESS('Created and filled the search index'))
+            return
+
+        vendor = search_vendor()
+        if vendor is None:
+            self.stdout.write(self.style.WARNING(
+                'No full-text index for this database; search uses icontains'
+            ))
+            return
+
+        with transaction.atomic():
+            rebuild_search_index()
+        self.stdout.write(self.style.SUCCESS(f'Rebuilt the {vendor} search index'))
@@ -4,7 +4,7 @@
 from django.core.management.base import BaseCommand
 from django.db import transaction
 from django.db.models import Count, Q
-from mechanisms.models import EnvironmentalMechanism
+from mechanisms.models import EnvironmentalMechanism, update_all_mechanism_counts
 from obligations.models import Obligation
 
 logger = logging.getLogger(__name__)
@@ -57,23 +57,12 @@ def validate_obligations(self):
 
     def update_mechanism_counts(self):
         """Update all mechanism counts including overdue status."""
-        mechanisms = EnvironmentalMechanism.objects.all().select_related('project')
-        count = mechanisms.count()
+        count = EnvironmentalMechanism.objects.count()
 
         self.stdout.write(f"Updating counts for {count} mechanisms...")
 
-        mechanisms_updated = 0
-        for i, mechanism in enumerate(mechanisms, 1):
-            if i % 10 == 0 or i == count:
-                self.stdout.write(f"Processed {i}/{count} mechanisms")
-
-            try:
-                mechanism.update_obligation_counts()
-                mechanisms_updated += 1
-            except (ValueError, TypeError, AttributeError) as e:
-                logger.error("Error updating counts for %s: %s", mechanism.name, str(e))
-
-        return mechanisms_updated
+        # Recount every mechanism with a single set-based UPDATE
+        return update_all_mechanism_counts()
 
     def handle(self, *args: tuple[Any, ...], **options: dict[str, Any]) -> None:
         try:
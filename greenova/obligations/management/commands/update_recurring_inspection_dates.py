@@ -1,25 +1,40 @@
 import logging
 
+from core.jobs import enqueue_job
 from django.core.management.base import BaseCommand
-from obligations.models import Obligation
+from obligations.recurring import RECURRING_ROLLOVER_JOB, roll_recurring_dates
 
 logger = logging.getLogger(__name__)
 
 class Command(BaseCommand):
     help = 'Update all recurring forecasted dates'
 
+    def add_arguments(self, parser):
+        parser.add_argument(
+            '--project',
+            action='append',
+            type=int,
+            dest='projects',
+            help='Only roll dates for this project id (repeatable)'
+        )
+        parser.add_argument(
+            '--queue',
+            action='store_true',
+            help='Enqueue the rollover for the job worker instead of running it'
+        )
+
     def handle(self, *args, **options):
         """Update forecasted dates for all recurring obligations."""
-        self.stdout.write("Updating recurring forecasted dates...")
+        projects = options.get('projects')
+        if options.get('queue'):
+            enqueue_job(RECURRING_ROLLOVER_JOB, *(projects or []))
+            self.stdout.write(self.style.SUCCESS(
+                "Queued recurring forecasted date rollover"
+            ))
+            return
 
-        # Get all recurring obligations
-        obligations = Obligation.objects.filter(recurring_obligation=True)
-        count = 0
-
-        for obligation in obligations:
-            if obligation.update_recurring_forecasted_date():
-                obligation.save()
-                count += 1
+        self.stdout.write("Updating recurring forecasted dates...")
+        count = roll_recurring_dates(projects)
 
         self.stdout.write(self.style.SUCCESS(
             f"Successfully updated {count} recurring forecasted dates"
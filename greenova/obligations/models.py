@@ -3,36 +3,155 @@
 from datetime import date
 from typing import Any
 
+from core.utils.db import iterate_queryset
+from core.utils.files import delete_unreferenced_file, store_content_addressed
 from core.utils.roles import get_responsibility_choices
-from dateutil.relativedelta import relativedelta
 from django.core.exceptions import ValidationError
 from django.core.validators import FileExtensionValidator
-from django.db import models
+from django.db import DatabaseError, models, transaction
 from django.db.models.signals import post_delete, post_save, pre_save
 from django.dispatch import receiver
 from django.utils import timezone
+from mechanisms.models import schedule_mechanism_counts
 from projects.models import Project
 
 from .constants import (
-    FREQUENCY_ANNUAL,
-    FREQUENCY_BIANNUAL,
-    FREQUENCY_DAILY,
-    FREQUENCY_FORTNIGHTLY,
-    FREQUENCY_MONTHLY,
-    FREQUENCY_QUARTERLY,
-    FREQUENCY_WEEKLY,
     STATUS_CHOICES,
     STATUS_COMPLETED,
     STATUS_NOT_STARTED,
 )
-from .utils import normalize_frequency
+from .search import SEARCH_FIELDS, index_obligations, remove_from_index
+from .utils import (
+    DEFAULT_FREQUENCY_DELTA,
+    frequency_delta,
+    is_obligation_overdue,
+    overdue_q,
+)
 
 logger = logging.getLogger(__name__)
 
+OBLIGATION_NUMBER_PREFIX = "PCEMP-"
+OBLIGATION_NUMBER_PATTERN = re.compile(rf"^{OBLIGATION_NUMBER_PREFIX}(\d+)$")
+
+# Fields that feed EnvironmentalMechanism status counters
+MECHANISM_COUNT_FIELDS = (
+    "primary_environmental_mechanism_id",
+    "status",
+    "action_due_date",
+)
+
+
+def format_obligation_number(number: int) -> str:
+    """Format a sequence value as an obligation number (e.g., PCEMP-001)."""
+    return f"{OBLIGATION_NUMBER_PREFIX}{number:03d}"
+
+
+def coerce_obligation_number(obligation_number: str) -> str:
+    """Force an obligation number onto the PCEMP- prefix, keeping its suffix."""
+    if obligation_number.startswith(OBLIGATION_NUMBER_PREFIX):
+        return obligation_number
+    suffix = (
+        obligation_number.split("-")[-1]
+        if "-" in obligation_number
+        else obligation_number
+    )
+    return f"{OBLIGATION_NUMBER_PREFIX}{suffix}"
+
+
+class ObligationNumberSequence(models.Model):
+    """Counter row handing out obligation numbers for a given prefix.
+
+    Replaces scanning every obligation for the highest number. The counter
+    row is locked while it is advanced, so concurrent workers never receive
+    the same number.
+    """
+
+    prefix: Any = models.CharField(max_length=20, primary_key=True)
+    last_value: Any = models.PositiveBigIntegerField(default=0)
+
+    class Meta:
+        verbose_name = "Obligation Number Sequence"
+        verbose_name_plural = "Obligation Number Sequences"
+        app_label = "obligations"
+
+    def __str__(self) -> str:
+        return f"{self.prefix}{self.last_value}"
+
+    @classmethod
+    def reserve(cls, prefix: str, count: int = 1) -> int:
+        """Advance the counter for ``prefix`` by ``count`` in constant time.
+
+        The counter is seeded from existing obligation numbers the first time
+        a prefix is used.
+
+        Args:
+            prefix: Obligation number prefix (e.g., PCEMP-)
+            count: How many consecutive numbers to reserve
+
+        Returns:
+            int: The first reserved number
+        """
+        if count < 1:
+            raise ValueError("count must be at least 1")
+
+        with transaction.atomic():
+            sequence = cls.objects.select_for_update().filter(prefix=prefix).first()
+            if sequence is None:
+                sequence, _ = cls.objects.select_for_update().get_or_create(
+                    prefix=prefix,
+                    defaults={"last_value": cls._highest_existing_number(prefix)},
+                )
+            first = sequence.last_value + 1
+            sequence.last_value += count
+            sequence.save(update_fields=["last_value"])
+        return first
+
+    @classmethod
+    def observe(cls, obligation_number: str) -> None:
+        """Move the counter past an explicitly assigned obligation number.
+
+        Keeps imported or hand-entered numbers from colliding with numbers the
+        sequence hands out later.
+        """
+        match = OBLIGATION_NUMBER_PATTERN.match(obligation_number or "")
+        if not match:
+            return
+        # An unseeded prefix is seeded from existing rows on the next reserve()
+        cls.objects.filter(
+            prefix=OBLIGATION_NUMBER_PREFIX, last_value__lt=int(match.group(1))
+        ).update(last_value=int(match.group(1)))
+
+    @staticmethod
+    def _highest_existing_number(prefix: str) -> int:
+        """Return the highest numeric suffix already used with ``prefix``."""
+        highest_number = 0
+        numbers = Obligation.objects.filter(
+            obligation_number__startswith=prefix
+        ).values_list("obligation_number", flat=True)
+        for obligation_number in iterate_queryset(numbers):
+            suffix = obligation_number[len(prefix) :]
+            if suffix.isdigit():
+                highest_number = max(highest_number, int(suffix))
+        return highest_number
+
+
+class ObligationQuerySet(models.QuerySet):
+    """QuerySet with database-side helpers for obligation status rules."""
+
+    def overdue(self, reference_date: date | None = None) -> "ObligationQuerySet":
+        """Return obligations that are overdue as of the reference date.
+
+        Uses the same rules as ``obligations.utils.is_obligation_overdue`` but
+        evaluates them in SQL so callers never need to load every row.
+        """
+        return self.filter(overdue_q(reference_date))
+
 
 class Obligation(models.Model):
     """Represents an environmental obligation."""
 
+    objects = ObligationQuerySet.as_manager()
+
     obligation_number: Any = models.CharField(
         max_length=20,
         primary_key=True,
@@ -218,13 +337,64 @@ class Meta:
         indexes = [
             models.Index(fields=["status"]),
             models.Index(fields=["action_due_date"]),
-            models.Index(fields=["project"]),
+            # Dashboard, overdue and upcoming lookups within a project; also
+            # serves plain project filters, so no separate project index
+            models.Index(
+                fields=["project", "status", "action_due_date"],
+                name="obligation_proj_status_due",
+            ),
+            # Mechanism counters and procedure charts group by status
+            models.Index(
+                fields=["primary_environmental_mechanism", "status"],
+                name="obligation_mech_status",
+            ),
+            # Responsibility charts and "my obligations" per project
+            models.Index(
+                fields=["responsibility", "project"],
+                name="obligation_resp_project",
+            ),
         ]
         app_label = "obligations"
 
     def __str__(self) -> str:
         return f"{self.obligation_number} - {self.project.name}"
 
+    @classmethod
+    def from_db(cls, db, field_names, values):
+        """Remember the loaded field values so saves can detect changes."""
+        instance = super().from_db(db, field_names, values)
+        instance._loaded_values = dict(zip(field_names, values))
+        return instance
+
+    def get_original_value(self, attname: str) -> Any:
+        """Return the value of a field as loaded from the database.
+
+        Falls back to the current value for unsaved instances or fields that
+        were not loaded.
+        """
+        loaded_values = getattr(self, "_loaded_values", None) or {}
+        return loaded_values.get(attname, getattr(self, attname))
+
+    def has_changed(self, *attnames: str) -> bool:
+        """Check whether any of the given fields differ from their loaded value.
+
+        Instances that were not loaded from the database are always treated as
+        changed.
+        """
+        if getattr(self, "_loaded_values", None) is None:
+            return True
+        return any(
+            self.get_original_value(attname) != getattr(self, attname)
+            for attname in attnames
+        )
+
+    def reset_tracked_values(self) -> None:
+        """Mark the current field values as persisted."""
+        self._loaded_values = {
+            field.attname: getattr(self, field.attname)
+            for field in self._meta.concrete_fields
+        }
+
     def calculate_next_recurring_date(self) -> date | None:
         """
         Calculate the next recurring date based on frequency and current/last date.
@@ -247,30 +417,14 @@ def calculate_next_recurring_date(self) -> date | None:
         today = timezone.now().date()
         base_date = max(base_date, today)
 
-        # Normalize frequency
-        normalized_frequency = normalize_frequency(self.recurring_frequency)
-
-        # Calculate next date based on frequency
-        if normalized_frequency == FREQUENCY_DAILY:
-            return base_date + relativedelta(days=1)
-        elif normalized_frequency == FREQUENCY_WEEKLY:
-            return base_date + relativedelta(weeks=1)
-        elif normalized_frequency == FREQUENCY_FORTNIGHTLY:
-            return base_date + relativedelta(weeks=2)
-        elif normalized_frequency == FREQUENCY_MONTHLY:
-            return base_date + relativedelta(months=1)
-        elif normalized_frequency == FREQUENCY_QUARTERLY:
-            return base_date + relativedelta(months=3)
-        elif normalized_frequency == FREQUENCY_BIANNUAL:
-            return base_date + relativedelta(months=6)
-        elif normalized_frequency == FREQUENCY_ANNUAL:
-            return base_date + relativedelta(years=1)
-        # Default to monthly if we don't recognize the frequency
-        logger.warning(
-            "Unrecognized frequency '%s' - defaulting to monthly",
-            self.recurring_frequency,
-        )
-        return base_date + relativedelta(months=1)
+        delta = frequency_delta(self.recurring_frequency)
+        if delta is None:
+            logger.warning(
+                "Unrecognized frequency '%s' - defaulting to monthly",
+                self.recurring_frequency,
+            )
+            delta = DEFAULT_FREQUENCY_DELTA
+        return base_date + delta
 
     def update_recurring_forecasted_date(self) -> bool:
         """
@@ -300,34 +454,23 @@ def get_next_obligation_number(cls) -> str:
         Returns:
             str: The next obligation number (e.g., PCEMP-101)
         """
-        prefix = "PCEMP-"
-
-        # Extract the highest numeric value from all obligation numbers
-        highest_number = 0
+        return cls.reserve_obligation_numbers(1)[0]
 
-        # Query all obligation numbers
-        all_obligations = cls.objects.all()
-
-        for obligation in all_obligations:
-            if obligation.obligation_number and obligation.obligation_number.startswith(
-                prefix
-            ):
-                try:
-                    # Extract numeric part after the prefix
-                    number_part = obligation.obligation_number[len(prefix) :]
-                    current_number = int(number_part)
-
-                    # Update highest if we found a larger number
-                    highest_number = max(highest_number, current_number)
-                except (ValueError, IndexError):
-                    # Skip if we can't parse the number
-                    continue
+    @classmethod
+    def reserve_obligation_numbers(cls, count: int) -> list[str]:
+        """
+        Reserve a contiguous block of obligation numbers for bulk creation.
 
-        # Increment by 1 for the next number
-        next_number = highest_number + 1
+        Args:
+            count: How many numbers to reserve
 
-        # Format with leading zeros (e.g., PCEMP-001)
-        return f"{prefix}{next_number:03d}"
+        Returns:
+            list[str]: The reserved numbers in ascending order
+        """
+        first = ObligationNumberSequence.reserve(OBLIGATION_NUMBER_PREFIX, count)
+        return [
+            format_obligation_number(number) for number in range(first, first + count)
+        ]
 
     def clean(self) -> None:
         """Validate the obligation number format."""
@@ -336,7 +479,7 @@ def clean(self) -> None:
         # Only validate if obligation_number is already set
         # This allows new records to pass validation before the number is generated
         if self.obligation_number and self.obligation_number.strip():
-            if not re.match(r"^PCEMP-\d+$", self.obligation_number):
+            if not OBLIGATION_NUMBER_PATTERN.match(self.obligation_number):
                 raise ValidationError(
                     {
                         "obligation_number": "Obligation number must be in the format PCEMP-XXX where XXX is a number"
@@ -344,42 +487,59 @@ def clean(self) -> None:
                 )
 
     def save(self, *args: Any, **kwargs: Any) -> None:
-        """Override save to update mechanism counts and ensure proper obligation number format."""
+        """Override save to ensure proper obligation number format."""
         # Generate a new obligation number if one isn't provided
         if not self.obligation_number or self.obligation_number.strip() == "":
             self.obligation_number = self.get_next_obligation_number()
+            self._number_from_sequence = True
 
         # Ensure the format is correct (prefix + number)
-        if not self.obligation_number.startswith("PCEMP-"):
-            self.obligation_number = f"PCEMP-{self.obligation_number.split('-')[-1] if '-' in self.obligation_number else self.obligation_number}"
+        self.obligation_number = coerce_obligation_number(self.obligation_number)
 
         try:
             super().save(*args, **kwargs)
         except Exception as exc:
             logger.error("Error saving obligation: %s", str(exc))
-
-        # Update mechanism counts
-        if self.primary_environmental_mechanism:
-            self.primary_environmental_mechanism.update_obligation_counts()
+        else:
+            # Only now, so every post_save receiver can see what changed
+            self.reset_tracked_values()
 
     @property
     def is_overdue(self) -> bool:
         """Check if obligation is overdue."""
-        if self.status != "completed" and self.action_due_date:
-            return self.action_due_date < timezone.now().date()
-        return False
+        return is_obligation_overdue(self)
+
+
+@receiver(post_save, sender=Obligation)
+def update_search_index_on_save(sender, instance, created, **kwargs):
+    """Re-index an obligation when any of its searchable text changes."""
+    try:
+        if created or instance.has_changed(*SEARCH_FIELDS):
+            index_obligations([instance.pk])
+    except DatabaseError as e:
+        logger.error("Error updating obligation search index: %s", str(e))
+
+
+@receiver(post_delete, sender=Obligation)
+def remove_from_search_index_on_delete(sender, instance, **kwargs):
+    """Drop a deleted obligation from the search index."""
+    remove_from_index([instance.pk])
 
 
 # Signal handlers to update mechanism counts
 @receiver(post_save, sender=Obligation)
-def update_mechanism_counts_on_save(sender, instance, **kwargs):
-    """Update mechanism counts when an obligation is saved."""
+def update_mechanism_counts_on_save(sender, instance, created, **kwargs):
+    """Recount affected mechanisms when an obligation's counted fields change.
+
+    Both the previous and the current mechanism are recounted when an
+    obligation moves between mechanisms. Inside a defer_mechanism_counts()
+    block the recounts are deduplicated and run once at the end.
+    """
     try:
-        if instance.primary_environmental_mechanism:
-            instance.primary_environmental_mechanism.update_obligation_counts()
-            logger.info(
-                "Updated counts for mechanism %s",
-                instance.primary_environmental_mechanism.name,
+        if created or instance.has_changed(*MECHANISM_COUNT_FIELDS):
+            schedule_mechanism_counts(
+                instance.get_original_value("primary_environmental_mechanism_id"),
+                instance.primary_environmental_mechanism_id,
             )
     except Exception as e:
         logger.error("Error updating mechanism counts on save: %s", str(e))
@@ -388,8 +548,13 @@ def update_mechanism_counts_on_save(sender, instance, **kwargs):
 @receiver(post_delete, sender=Obligation)
 def update_mechanism_counts_on_delete(sender, instance, **kwargs):
     """Update mechanism counts when an obligation is deleted."""
-    if instance.primary_environmental_mechanism:
-        instance.primary_environmental_mechanism.update_obligation_counts()
+    schedule_mechanism_counts(
+        instance.get_original_value("primary_environmental_mechanism_id"),
+        instance.primary_environmental_mechanism_id,
+    )
+
+
+EVIDENCE_STORAGE_PREFIX = "evidence_files/sha256"
 
 
 class ObligationEvidence(models.Model):
@@ -422,6 +587,10 @@ class ObligationEvidence(models.Model):
     )
     uploaded_at: Any = models.DateTimeField(auto_now_add=True)
     description: Any = models.CharField(max_length=255, blank=True)
+    # Name the file was uploaded as; the stored name is its SHA-256 digest
+    original_name: Any = models.CharField(max_length=255, blank=True)
+    sha256: Any = models.CharField(max_length=64, blank=True, db_index=True)
+    size: Any = models.PositiveBigIntegerField(null=True, blank=True)
 
     class Meta:
         ordering = ["-uploaded_at"]
@@ -429,11 +598,27 @@ class Meta:
         verbose_name_plural = "Evidence Files"
 
     def __str__(self) -> str:
-        return f"Evidence for {self.obligation} - {self.file.name}"
+        return f"Evidence for {self.obligation} - {self.display_name}"
+
+    @property
+    def display_name(self) -> str:
+        """The uploaded file name, for links and downloads."""
+        return self.original_name or self.file.name.rsplit("/", 1)[-1]
+
+    def store_upload(self, upload) -> None:
+        """Store an uploaded file content-addressed and record its hash and size.
+
+        Evidence with identical content shares one stored file.
+        """
+        self.original_name = (upload.name or "")[:255]
+        self.sha256, self.size = store_content_addressed(
+            self, "file", upload, EVIDENCE_STORAGE_PREFIX
+        )
 
     def file_size(self) -> str:
         """Return the file size in a human-readable format."""
-        size = self.file.size
+        # Rows from before sizes were recorded still ask the storage
+        size = self.size if self.size is not None else self.file.size
         if size < 1024:
             return f"{size} bytes"
         elif size < 1024 * 1024:
@@ -442,41 +627,48 @@ def file_size(self) -> str:
             return f"{size / (1024 * 1024):.1f} MB"
 
 
+@receiver(post_delete, sender=ObligationEvidence)
+def delete_evidence_file(sender, instance, **kwargs):
+    """Remove a stored evidence file once no evidence row shares it."""
+    transaction.on_commit(
+        lambda: delete_unreferenced_file(instance.file, ObligationEvidence, "file")
+    )
+
+
+# Fields whose change moves an obligation's recurring forecast
+RECURRING_FORECAST_FIELDS = (
+    "recurring_obligation",
+    "recurring_frequency",
+    "status",
+    "action_due_date",
+)
+
+
 @receiver(pre_save, sender="obligations.Obligation")
 def update_forecasted_date_on_change(sender, instance, **kwargs):
-    """Signal handler to update forecasted date when relevant fields change."""
-    # If this is a new instance, skip this check
-    if not instance.pk:
+    """Signal handler to update forecasted date when relevant fields change.
+
+    Changes are detected against the values tracked since the instance was
+    loaded, so no extra SELECT is made. Forecasts that lapse without an
+    edit are moved on by the recurring rollover job (obligations.recurring).
+    """
+    if instance._state.adding:
         # For new instances, just make sure the date is calculated
         instance.update_recurring_forecasted_date()
         return
 
-    try:
-        # Get the existing record to compare changes
-        old_instance = sender.objects.get(pk=instance.pk)
-
-        # Check if relevant fields changed
-        if (
-            instance.recurring_obligation != old_instance.recurring_obligation
-            or instance.recurring_frequency != old_instance.recurring_frequency
-            or instance.status != old_instance.status
-            or instance.action_due_date != old_instance.action_due_date
-        ):
-            instance.update_recurring_forecasted_date()
-
-        # If status changed to completed, handle recurring logic
-        if (
-            instance.status == STATUS_COMPLETED
-            and old_instance.status != STATUS_COMPLETED
-            and instance.recurring_obligation
-        ):
-            # When a recurring obligation is completed, reset status and calculate next date
-            instance.status = STATUS_NOT_STARTED
-            instance.update_recurring_forecasted_date()
-
-    except sender.DoesNotExist:
-        # This shouldn't happen but just in case
-        pass
+    # If status changed to completed, handle recurring logic
+    if (
+        instance.status == STATUS_COMPLETED
+        and instance.get_original_value("status") != STATUS_COMPLETED
+        and instance.recurring_obligation
+    ):
+        # When a recurring obligation is completed, reset status and calculate
+        # next date (once: the forecast must advance by a single period)
+        instance.status = STATUS_NOT_STARTED
+        instance.update_recurring_forecasted_date()
+    elif instance.has_changed(*RECURRING_FORECAST_FIELDS):
+        instance.update_recurring_forecasted_date()
 
 
 @receiver(pre_save, sender="obligations.Obligation")
@@ -489,3 +681,11 @@ def ensure_obligation_number(sender, instance, **kwargs):
         not instance.obligation_number or instance.obligation_number.strip() == ""
     ):
         instance.obligation_number = Obligation.get_next_obligation_number()
+        instance._number_from_sequence = True
+
+
+@receiver(post_save, sender="obligations.Obligation")
+def advance_obligation_number_sequence(sender, instance, created, **kwargs):
+    """Keep the number sequence ahead of explicitly numbered new obligations."""
+    if created and not getattr(instance, "_number_from_sequence", False):
+        ObligationNumberSequence.observe(instance.obligation_number)
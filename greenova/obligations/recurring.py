@@ -0,0 +1,115 @@
+"""Batch rollover of recurring obligation forecasts.
+
+A recurring obligation's ``recurring_forcasted_date`` used to move only
+when someone saved the row. ``roll_recurring_dates`` advances every lapsed
+forecast (missing, or before today) with set-based UPDATEs instead: the
+distinct stored frequency spellings are normalized once, and each
+canonical frequency costs one UPDATE for rows rolling on from today, plus
+one per distinct future due date for rows without a forecast yet. The rule
+matches ``Obligation.calculate_next_recurring_date``.
+
+The rollover runs as the ``obligations.roll_recurring_dates`` background
+job, keyed by project; the job worker schedules it daily, and the
+``update_recurring_inspection_dates`` command runs it on demand.
+"""
+
+import logging
+from datetime import timedelta
+from typing import Dict, Iterable, List, Optional
+
+from core.jobs import register_job
+from dashboard.signals import dashboard_data_updated
+from django.db.models import Q
+from django.utils import timezone
+
+from .models import Obligation
+from .utils import DEFAULT_FREQUENCY_DELTA, FREQUENCY_DELTAS, normalize_frequency
+
+logger = logging.getLogger(__name__)
+
+RECURRING_ROLLOVER_JOB = "obligations.roll_recurring_dates"
+RECURRING_ROLLOVER_INTERVAL = timedelta(days=1)
+
+
+def _frequency_groups(queryset) -> Dict[str, List[str]]:
+    """Group the stored frequency spellings by canonical frequency."""
+    groups: Dict[str, List[str]] = {}
+    spellings = queryset.values_list("recurring_frequency", flat=True).distinct()
+    for spelling in spellings.order_by():
+        canonical = normalize_frequency(spelling)
+        if canonical not in FREQUENCY_DELTAS:
+            logger.warning(
+                "Unrecognized frequency '%s' - defaulting to monthly", spelling
+            )
+        groups.setdefault(canonical, []).append(spelling)
+    return groups
+
+
+def roll_recurring_dates(project_ids: Optional[Iterable[int]] = None) -> int:
+    """
+    Move lapsed recurring forecast dates on to their next occurrence.
+
+    Writes are queryset updates, so the save signals do not run; cached
+    dashboard data of the touched projects is retired afterwards.
+
+    Args:
+        project_ids: Restrict the rollover to these projects (default: all)
+
+    Returns:
+        int: Number of obligations whose forecast date changed
+    """
+    today = timezone.now().date()
+    recurring = (
+        Obligation.objects.filter(recurring_obligation=True)
+        .exclude(recurring_frequency__isnull=True)
+        .exclude(recurring_frequency="")
+    )
+    if project_ids is not None:
+        recurring = recurring.filter(project_id__in=list(project_ids))
+
+    # Lapsed forecasts, and new ones whose due date has passed, roll on from
+    # today; new ones due in the future roll on from their due date
+    from_today = recurring.filter(
+        Q(recurring_forcasted_date__lt=today)
+        | (
+            Q(recurring_forcasted_date__isnull=True)
+            & (Q(action_due_date__isnull=True) | Q(action_due_date__lte=today))
+        )
+    )
+    from_due = recurring.filter(
+        recurring_forcasted_date__isnull=True, action_due_date__gt=today
+    )
+    to_roll = from_today | from_due
+    project_ids_touched = set(
+        to_roll.values_list("project_id", flat=True).distinct().order_by()
+    )
+    if not project_ids_touched:
+        return 0
+
+    updated = 0
+    for canonical, spellings in _frequency_groups(to_roll).items():
+        delta = FREQUENCY_DELTAS.get(canonical, DEFAULT_FREQUENCY_DELTA)
+        updated += from_today.filter(recurring_frequency__in=spellings).update(
+            recurring_forcasted_date=today + delta
+        )
+        group_from_due = from_due.filter(recurring_frequency__in=spellings)
+        due_dates = group_from_due.values_list("action_due_date", flat=True)
+        for due_date in due_dates.distinct().order_by():
+            updated += group_from_due.filter(action_due_date=due_date).update(
+                recurring_forcasted_date=due_date + delta
+            )
+
+    for project_id in project_ids_touched:
+        dashboard_data_updated.send(
+            sender=Obligation, obligation_id=None, project_id=project_id
+        )
+    logger.info("Rolled %d recurring forecast dates", updated)
+    return updated
+
+
+@register_job(RECURRING_ROLLOVER_JOB, every=RECURRING_ROLLOVER_INTERVAL)
+def run_recurring_date_rollover(keys: List[str]) -> None:
+    """Background job: roll recurring dates for the projects in ``keys``."""
+    project_ids = [int(key) for key in keys if key.isdigit()]
+    # An empty key asks for every project
+    roll_recurring_dates(None if "" in keys else project_ids)
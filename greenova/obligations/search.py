@@ -0,0 +1,249 @@
+"""Full-text search index over obligation text.
+
+Searching with ``icontains`` needs a leading-wildcard scan of every
+obligation. Instead, the searchable text of each obligation is kept in a
+side table that the database can index:
+
+* PostgreSQL: ``obligations_search`` holds a weighted ``tsvector`` per
+  obligation, served by a GIN index and ranked with ``ts_rank``.
+* SQLite: ``obligations_search`` is an FTS5 virtual table ranked with
+  ``bm25``.
+
+The table is created after ``migrate`` and kept in sync from the obligation
+save/delete signals and by the bulk importer. Other database vendors, or a
+SQLite build without FTS5, fall back to ``icontains`` filtering.
+"""
+
+import logging
+import re
+from typing import Iterable, List, Optional
+
+from django.db import DEFAULT_DB_ALIAS, DatabaseError, connection
+from django.db.models import Q, QuerySet
+
+logger = logging.getLogger(__name__)
+
+SEARCH_TABLE = "obligations_search"
+SEARCH_CONFIG = "english"
+OBLIGATION_TABLE = "obligations_obligation"
+
+# Indexed columns; earlier groups rank higher
+TITLE_FIELDS = ("obligation_number", "obligation")
+NOTE_FIELDS = ("supporting_information", "evidence_notes")
+COMMENT_FIELDS = (
+    "general_comments",
+    "compliance_comments",
+    "non_conformance_comments",
+)
+SEARCH_FIELD_GROUPS = (TITLE_FIELDS, NOTE_FIELDS, COMMENT_FIELDS)
+SEARCH_FIELDS = tuple(field for group in SEARCH_FIELD_GROUPS for field in group)
+POSTGRES_WEIGHTS = ("A", "B", "C")
+# bm25() column weights: obligation_number is unindexed, then one per group
+SQLITE_WEIGHTS = (0.0, 10.0, 4.0, 1.0)
+
+# Limits the number of terms a single query can expand into
+MAX_SEARCH_TERMS = 8
+
+_available: dict = {}
+
+
+def search_terms(text: str) -> List[str]:
+    """Split user input into plain word tokens safe for both query syntaxes."""
+    return re.findall(r"\w+", text or "")[:MAX_SEARCH_TERMS]
+
+
+def search_vendor() -> Optional[str]:
+    """Return the active index backend, or None to fall back to icontains."""
+    vendor = connection.vendor
+    if vendor not in ("postgresql", "sqlite"):
+        return None
+    if _available.get(connection.alias) is None:
+        _available[connection.alias] = (
+            SEARCH_TABLE in connection.introspection.table_names()
+        )
+    return vendor if _available[connection.alias] else None
+
+
+def _concat_sql(fields: Iterable[str]) -> str:
+    return " || ' ' || ".join(f"COALESCE({field}, '')" for field in fields)
+
+
+def ensure_search_index(using: str = DEFAULT_DB_ALIAS, **kwargs) -> bool:
+    """
+    Create the search table for the default database if it is missing.
+
+    Connected to ``post_migrate``. A newly created table is filled from the
+    existing obligations.
+
+    Returns:
+        bool: True if the table was created by this call
+    """
+    if using != DEFAULT_DB_ALIAS or connection.vendor not in ("postgresql", "sqlite"):
+        return False
+    tables = connection.introspection.table_names()
+    if SEARCH_TABLE in tables:
+        _available[connection.alias] = True
+        return False
+    if OBLIGATION_TABLE not in tables:
+        return False
+
+    try:
+        with connection.cursor() as cursor:
+            if connection.vendor == "postgresql":
+                cursor.execute(
+                    f"CREATE TABLE {SEARCH_TABLE} ("
+                    " obligation_number varchar(20) PRIMARY KEY"
+                    f" REFERENCES {OBLIGATION_TABLE} (obligation_number)"
+                    " ON DELETE CASCADE DEFERRABLE INITIALLY DEFERRED,"
+                    " document tsvector NOT NULL)"
+                )
+                cursor.execute(
+                    f"CREATE INDEX {SEARCH_TABLE}_document_gin"
+                    f" ON {SEARCH_TABLE} USING gin (document)"
+                )
+            else:
+                cursor.execute(
+                    f"CREATE VIRTUAL TABLE {SEARCH_TABLE} USING fts5("
+                    " obligation_number UNINDEXED, title, notes, comments,"
+                    " tokenize = 'porter unicode61')"
+                )
+    except DatabaseError as exc:
+        logger.warning("Full-text search index unavailable: %s", exc)
+        _available[connection.alias] = False
+        return False
+
+    _available[connection.alias] = True
+    rebuild_search_index()
+    logger.info("Created obligation search index %s", SEARCH_TABLE)
+    return True
+
+
+def _write_documents(where: str, params: list) -> None:
+    """Replace index rows for the obligations matching ``where``."""
+    vendor = search_vendor()
+    if vendor is None:
+        return
+
+    with connection.cursor() as cursor:
+        if vendor == "postgresql":
+            document = " || ".join(
+                f"setweight(to_tsvector('{SEARCH_CONFIG}', {_concat_sql(group)}),"
+                f" '{weight}')"
+                for group, weight in zip(SEARCH_FIELD_GROUPS, POSTGRES_WEIGHTS)
+            )
+            cursor.execute(
+                f"INSERT INTO {SEARCH_TABLE} (obligation_number, document)"
+                f" SELECT obligation_number, {document} FROM {OBLIGATION_TABLE}"
+                f" WHERE {where}"
+                " ON CONFLICT (obligation_number)"
+                " DO UPDATE SET document = EXCLUDED.document",
+                params,
+            )
+        else:
+            cursor.execute(f"DELETE FROM {SEARCH_TABLE} WHERE {where}", params)
+            columns = ", ".join(_concat_sql(group) for group in SEARCH_FIELD_GROUPS)
+            cursor.execute(
+                f"INSERT INTO {SEARCH_TABLE}"
+                " (obligation_number, title, notes, comments)"
+                f" SELECT obligation_number, {columns} FROM {OBLIGATION_TABLE}"
+                f" WHERE {where}",
+                params,
+            )
+
+
+def index_obligations(obligation_numbers: Iterable[str]) -> None:
+    """Refresh the index rows of the given obligations in two statements."""
+    numbers = [number for number in set(obligation_numbers) if number]
+    if not numbers:
+        return
+    placeholders = ", ".join(["%s"] * len(numbers))
+    _write_documents(f"obligation_number IN ({placeholders})", numbers)
+
+
+def remove_from_index(obligation_numbers: Iterable[str]) -> None:
+    """Drop index rows; PostgreSQL also cascades them with the obligation."""
+    numbers = [number for number in set(obligation_numbers) if number]
+    if not numbers or search_vendor() is None:
+        return
+    placeholders = ", ".join(["%s"] * len(numbers))
+    with connection.cursor() as cursor:
+        cursor.execute(
+            f"DELETE FROM {SEARCH_TABLE} WHERE obligation_number IN ({placeholders})",
+            numbers,
+        )
+
+
+def rebuild_search_index() -> None:
+    """Re-index every obligation."""
+    if search_vendor() is None:
+        return
+    with connection.cursor() as cursor:
+        cursor.execute(f"DELETE FROM {SEARCH_TABLE}")
+    _write_documents("1 = 1", [])
+
+
+def _postgres_query(terms: List[str]) -> str:
+    # Prefix matching keeps partial words working as they did with icontains
+    return " & ".join(f"{term}:*" for term in terms)
+
+
+def _sqlite_query(terms: List[str]) -> str:
+    return " ".join(f'"{term}"*' for term in terms)
+
+
+def search_obligations(
+    queryset: QuerySet, text: str, ranked: bool = True
+) -> QuerySet:
+    """
+    Filter ``queryset`` to obligations matching ``text``.
+
+    Every word must match, as a prefix, somewhere in the obligation number,
+    text, supporting information, evidence notes or comments.
+
+    Args:
+        queryset: Obligations to search within
+        text: Raw user input
+        ranked: Annotate ``search_rank`` and order by it, best first
+
+    Returns:
+        QuerySet: The filtered (and optionally ranked) queryset
+    """
+    terms = search_terms(text)
+    if not terms:
+        return queryset
+
+    vendor = search_vendor()
+    if vendor is None:
+        # No index available: every word must appear in the number or text
+        for term in terms:
+            queryset = queryset.filter(
+                Q(obligation_number__icontains=term) | Q(obligation__icontains=term)
+            )
+        return queryset
+
+    # Join the index so the database drives the query from the index match
+    join = f"{SEARCH_TABLE}.obligation_number = {OBLIGATION_TABLE}.obligation_number"
+    if vendor == "postgresql":
+        query = _postgres_query(terms)
+        match = f"{SEARCH_TABLE}.document @@ to_tsquery('{SEARCH_CONFIG}', %s)"
+        rank = f"ts_rank({SEARCH_TABLE}.document, to_tsquery('{SEARCH_CONFIG}', %s))"
+    else:
+        query = _sqlite_query(terms)
+        weights = ", ".join(str(weight) for weight in SQLITE_WEIGHTS)
+        match = f"{SEARCH_TABLE} MATCH %s"
+        # bm25() is lower for better matches
+        rank = f"-bm25({SEARCH_TABLE}, {weights})"
+
+    extra: dict = {
+        "tables": [SEARCH_TABLE],
+        "where": [join, match],
+        "params": [query],
+    }
+    if ranked:
+        extra["select"] = {"search_rank": rank}
+        if vendor == "postgresql":
+            extra["select_params"] = [query]
+    queryset = queryset.extra(**extra)
+    if ranked:
+        queryset = queryset.order_by("-search_rank", "obligation_number")
+    return queryset
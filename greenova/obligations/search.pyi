@@ -0,0 +1,26 @@
+# Stub file for obligations.search
+from typing import Iterable, List, Optional, Tuple
+
+from django.db.models import QuerySet
+
+SEARCH_TABLE: str
+SEARCH_CONFIG: str
+OBLIGATION_TABLE: str
+TITLE_FIELDS: Tuple[str, ...]
+NOTE_FIELDS: Tuple[str, ...]
+COMMENT_FIELDS: Tuple[str, ...]
+SEARCH_FIELD_GROUPS: Tuple[Tuple[str, ...], ...]
+SEARCH_FIELDS: Tuple[str, ...]
+POSTGRES_WEIGHTS: Tuple[str, ...]
+SQLITE_WEIGHTS: Tuple[float, ...]
+MAX_SEARCH_TERMS: int
+
+def search_terms(text: str) -> List[str]: ...
+def search_vendor() -> Optional[str]: ...
+def ensure_search_index(using: str = ..., **kwargs: object) -> bool: ...
+def index_obligations(obligation_numbers: Iterable[str]) -> None: ...
+def remove_from_index(obligation_numbers: Iterable[str]) -> None: ...
+def rebuild_search_index() -> None: ...
+def search_obligations(
+    queryset: QuerySet, text: str, ranked: bool = ...
+) -> QuerySet: ...
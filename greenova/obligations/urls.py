@@ -44,4 +44,15 @@ def root_redirect(request):
         name="toggle_custom_aspect",
     ),
     path("list/", views.ObligationListView.as_view(), name="obligation_list"),
+    path("export/", views.export_obligations, name="export"),
+    path(
+        "evidence/upload/<str:obligation_number>/",
+        views.upload_evidence,
+        name="upload_evidence",
+    ),
+    path(
+        "evidence/<int:evidence_id>/download/",
+        views.download_evidence,
+        name="download_evidence",
+    ),
 ]
@@ -1,8 +1,11 @@
 import logging
 from datetime import date, timedelta
+from functools import lru_cache
 from typing import TYPE_CHECKING, Any, Dict, Optional, Union
 
 from core.utils.roles import get_role_display
+from dateutil.relativedelta import relativedelta
+from django.db.models import Q
 from django.utils import timezone
 
 # Import Obligation only for type checking to avoid circular imports
@@ -66,6 +69,34 @@ def is_obligation_overdue(
     return due_date < reference_date
 
 
+def overdue_q(
+    reference_date: Optional[date] = None,
+    prefix: str = ''
+) -> Q:
+    """
+    Build a Q expression matching overdue obligations in the database.
+
+    Mirrors the rules of is_obligation_overdue so that filtering and counting
+    can be pushed into a single SQL query instead of a Python loop.
+
+    Args:
+        reference_date: Optional date to compare against (defaults to today)
+        prefix: Optional lookup prefix when filtering through a relation
+            (e.g. 'obligations__')
+
+    Returns:
+        Q: Expression usable in filter(), exclude() or Count(filter=...)
+    """
+    if reference_date is None:
+        reference_date = timezone.now().date()
+
+    # Rules 2 and 3: a due date in the past (NULL never compares less than),
+    # Rule 1: excluding completed obligations
+    return Q(**{f'{prefix}action_due_date__lt': reference_date}) & ~Q(
+        **{f'{prefix}status': STATUS_COMPLETED}
+    )
+
+
 def get_obligation_status(obligation):
     """
     Determine the real status of an obligation based on its due date and current status.
@@ -114,10 +145,13 @@ def _match_frequency_pattern(frequency_lower: str) -> Optional[str]:
     return None
 
 
+@lru_cache(maxsize=1024)
 def normalize_frequency(frequency: str) -> str:
     """
     Normalize a frequency string to its canonical form.
 
+    Results are cached: there are only a handful of distinct spellings.
+
     Args:
         frequency: A string representing the frequency
 
@@ -151,6 +185,25 @@ def normalize_frequency(frequency: str) -> str:
     return frequency_lower
 
 
+# Step between occurrences of a recurring obligation, by canonical frequency
+FREQUENCY_DELTAS = {
+    FREQUENCY_DAILY: relativedelta(days=1),
+    FREQUENCY_WEEKLY: relativedelta(weeks=1),
+    FREQUENCY_FORTNIGHTLY: relativedelta(weeks=2),
+    FREQUENCY_MONTHLY: relativedelta(months=1),
+    FREQUENCY_QUARTERLY: relativedelta(months=3),
+    FREQUENCY_BIANNUAL: relativedelta(months=6),
+    FREQUENCY_ANNUAL: relativedelta(years=1),
+}
+# Used for frequencies that cannot be normalized
+DEFAULT_FREQUENCY_DELTA = FREQUENCY_DELTAS[FREQUENCY_MONTHLY]
+
+
+def frequency_delta(frequency: str) -> Optional[relativedelta]:
+    """Return the step of a frequency string, or None if it is unrecognized."""
+    return FREQUENCY_DELTAS.get(normalize_frequency(frequency or ''))
+
+
 def get_responsibility_display_name(responsibility_value: str) -> str:
     """Get the display name for a responsibility value."""
     if 'Perdaman' in responsibility_value or 'SCJV' in responsibility_value:
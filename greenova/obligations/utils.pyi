@@ -2,6 +2,9 @@
 from datetime import date
 from typing import TYPE_CHECKING, Any, Dict, Optional, Union
 
+from dateutil.relativedelta import relativedelta
+from django.db.models import Q
+
 if TYPE_CHECKING:
     from .models import Obligation
 
@@ -9,6 +12,15 @@ def is_obligation_overdue(
     obligation: Union["Obligation", Dict[str, Any]],
     reference_date: Optional[date] = None,
 ) -> bool: ...
+def overdue_q(
+    reference_date: Optional[date] = None,
+    prefix: str = "",
+) -> Q: ...
 def get_obligation_status(obligation: Any) -> str: ...
 def normalize_frequency(frequency: str) -> str: ...
+
+FREQUENCY_DELTAS: Dict[str, relativedelta]
+DEFAULT_FREQUENCY_DELTA: relativedelta
+
+def frequency_delta(frequency: str) -> Optional[relativedelta]: ...
 def get_responsibility_display_name(responsibility_value: str) -> str: ...
@@ -1,30 +1,87 @@
+import hashlib
 import logging
 import os
 from datetime import date, timedelta
 from typing import Any
 
 from company.models import CompanyMembership
+from core.utils.cache import GLOBAL_SCOPE, cached, project_scope
+from core.utils.files import file_download_response
+from core.utils.fragments import fragment_response
+from core.utils.pagination import CURSOR_PARAM, InvalidCursor, paginate_keyset
+from core.utils.streaming import stream_async
 from django.contrib import messages
+from django.contrib.auth.decorators import login_required
 from django.contrib.auth.mixins import LoginRequiredMixin
 from django.core.exceptions import ValidationError
-from django.core.paginator import Paginator
 from django.db.models import Q, QuerySet
-from django.http import HttpResponse, JsonResponse
+from django.http import (
+    FileResponse,
+    Http404,
+    HttpResponse,
+    JsonResponse,
+    StreamingHttpResponse,
+)
 from django.shortcuts import get_object_or_404, redirect, render
+from django.template.loader import render_to_string
 from django.urls import reverse
 from django.utils.decorators import method_decorator
+from django.utils.http import urlencode
 from django.views import View
-from django.views.decorators.cache import cache_control
 from django.views.decorators.vary import vary_on_headers
 from django.views.generic import CreateView, DetailView, ListView, UpdateView
 from django.views.generic.edit import DeleteView
 from django_htmx.http import trigger_client_event
 from mechanisms.models import EnvironmentalMechanism
-from projects.models import Project, ProjectMembership
-
+from projects.models import Project, ProjectMembership, get_project_roles
+
+from .exports import (
+    EXPORT_CONTENT_TYPES,
+    ExportDependencyError,
+    export_queryset,
+    export_to_file,
+    iter_export_chunks,
+    require_export_format,
+    stream_csv,
+)
 from .forms import EvidenceUploadForm, ObligationForm
 from .models import Obligation, ObligationEvidence
-from .utils import is_obligation_overdue
+from .search import search_obligations
+from .utils import overdue_q
+
+OBLIGATION_LIST_TEMPLATE = "obligations/partials/obligation_list.html"
+SUMMARY_TEMPLATE = "obligations/components/_obligations_summary.html"
+
+# Columns the summary table can be sorted by
+SORTABLE_FIELDS = frozenset(
+    field.name
+    for field in Obligation._meta.concrete_fields
+    if not field.is_relation
+)
+
+
+def keyset_page(queryset: QuerySet, request, sort_field, descending=False, count=None):
+    """Return the keyset page named by the request's cursor, or the first page."""
+    try:
+        return paginate_keyset(
+            queryset,
+            sort_field,
+            cursor=request.GET.get(CURSOR_PARAM),
+            descending=descending,
+            count=count,
+        )
+    except InvalidCursor:
+        logger.warning("Ignoring invalid pagination cursor")
+        return paginate_keyset(queryset, sort_field, descending=descending, count=count)
+
+
+def pagination_query(request) -> str:
+    """Return the request's query string without its pagination parameters."""
+    params = request.GET.copy()
+    params.pop(CURSOR_PARAM, None)
+    params.pop("page", None)
+    return params.urlencode()
+
 
 # Ensure the Django settings module is correctly configured.
 os.environ.setdefault("DJANGO_SETTINGS_MODULE", "greenova.settings")
@@ -50,13 +107,14 @@
 )
 
 
-@method_decorator(cache_control(max_age=300), name="dispatch")
 @method_decorator(vary_on_headers("HX-Request"), name="dispatch")
 class ObligationSummaryView(LoginRequiredMixin, View):
     """View for displaying obligation summary with filtering capabilities.
 
     This view handles both standard requests and HTMX requests for
-    dynamically loading filtered obligations.
+    dynamically loading filtered obligations. Both partials are served from
+    the fragment cache, versioned by the project's cache scope, with an ETag
+    so a repeated swap costs a 304 (see core.utils.fragments).
     """
 
     def get(self, request, *args, **kwargs):
@@ -77,52 +135,80 @@ def get(self, request, *args, **kwargs):
         project_id = request.GET.get("project_id")
 
         if status and procedure and project_id:
-            try:
-                # Filter obligations based on parameters
-                obligations = Obligation.objects.filter(project_id=project_id)
-
-                # Apply status filter (handle overdue special case)
-                if status == "overdue":
-                    # Find obligations that are overdue
-                    filtered_ids = []
-                    for obligation in obligations:
-                        if is_obligation_overdue(obligation):
-                            filtered_ids.append(obligation.obligation_number)
-                    obligations = obligations.filter(obligation_number__in=filtered_ids)
-                else:
-                    obligations = obligations.filter(status=status)
+            return fragment_response(
+                request,
+                project_scope(project_id),
+                lambda: self._render_filtered_list(status, procedure, project_id),
+                parts=[OBLIGATION_LIST_TEMPLATE],
+            )
 
-                # Apply procedure filter (adjusted for TextField)
-                if procedure:
-                    obligations = obligations.filter(procedure__icontains=procedure)
+        # For regular requests, proceed with full view
+        user_can_edit = request.user.has_perm("obligations.change_obligation")
+        scope, parts = self._summary_cache_scope()
+        return fragment_response(
+            request,
+            scope,
+            self._render_summary,
+            parts=[SUMMARY_TEMPLATE, user_can_edit, *parts],
+        )
 
-                return render(
-                    request,
-                    "obligations/partials/obligation_list.html",
-                    {"obligations": obligations},
-                )
-            except Exception as exc:
-                logger.error("Error filtering obligations: %s", str(exc))
-                return render(
-                    request,
-                    "obligations/partials/obligation_list.html",
-                    {
-                        "error": f"Error loading obligations: {exc!s}",
-                        "obligations": [],
-                    },
-                )
+    def _render_filtered_list(self, status, procedure, project_id):
+        """Render the obligation list for one chart segment."""
+        try:
+            # Filter obligations based on parameters
+            obligations = Obligation.objects.filter(project_id=project_id)
 
-        # For regular requests, proceed with full view
-        context = self.get_context_data(**kwargs)
+            # Apply status filter (handle overdue special case)
+            if status == "overdue":
+                obligations = obligations.overdue()
+            else:
+                obligations = obligations.filter(status=status)
 
-        if self.request.htmx:
-            return render(
-                request, "obligations/components/_obligations_summary.html", context
+            # Procedure names come from the chart, so match them exactly
+            if procedure:
+                obligations = obligations.filter(procedure=procedure)
+
+            html = render_to_string(
+                OBLIGATION_LIST_TEMPLATE, {"obligations": obligations}, self.request
             )
+            return html, True
+        except Exception as exc:
+            logger.error("Error filtering obligations: %s", str(exc))
+            html = render_to_string(
+                OBLIGATION_LIST_TEMPLATE,
+                {
+                    "error": f"Error loading obligations: {exc!s}",
+                    "obligations": [],
+                },
+                self.request,
+            )
+            return html, False
 
-        return render(
-            request, "obligations/components/_obligations_summary.html", context
+    def _summary_cache_scope(self):
+        """Return the cache scope of the summary and extra key parts.
+
+        A mechanism's summary follows its project's data version. Without a
+        mechanism the user's own overdue obligations are listed, which follow
+        the global scope (bumped by every data or membership change) and are
+        keyed per user.
+        """
+        mechanism_id = self.request.GET.get("mechanism_id")
+        if not mechanism_id:
+            return GLOBAL_SCOPE, [self.request.user.pk]
+        project_id = (
+            EnvironmentalMechanism.objects.filter(pk=mechanism_id)
+            .values_list("project_id", flat=True)
+            .first()
+            if str(mechanism_id).isdigit()
+            else None
         )
+        return project_scope(project_id), []
+
+    def _render_summary(self):
+        """Render the summary partial; error notices are not cached."""
+        context = self.get_context_data()
+        html = render_to_string(SUMMARY_TEMPLATE, context, self.request)
+        return html, "error" not in context
 
     def _filter_by_status(self, queryset: QuerySet, status_values: list) -> QuerySet:
         """Filter obligations by status, handling 'overdue' as a special case.
@@ -139,23 +225,11 @@ def _filter_by_status(self, queryset: QuerySet, status_values: list) -> QuerySet
             # Remove overdue to handle separately
             standard_statuses = [s for s in status_values if s != "overdue"]
 
-            # Get obligations that match standard statuses
+            # Match either a standard status or the overdue rule in one query
+            status_q = overdue_q()
             if standard_statuses:
-                filtered_by_status = queryset.filter(status__in=standard_statuses)
-            else:
-                filtered_by_status = queryset.none()
-
-            # Find overdue obligations
-            overdue_ids = []
-            for obligation in queryset:
-                if is_obligation_overdue(obligation):
-                    overdue_ids.append(obligation.obligation_number)
-
-            if overdue_ids:
-                # Combine with standard status filter
-                overdue_queryset = queryset.filter(obligation_number__in=overdue_ids)
-                return filtered_by_status.union(overdue_queryset)
-            return filtered_by_status
+                status_q |= Q(status__in=standard_statuses)
+            return queryset.filter(status_q)
 
         # Standard status filtering
         if status_values:
@@ -183,13 +257,9 @@ def apply_filters(self, queryset: QuerySet, filters: dict[str, Any]) -> QuerySet
         if filters.get("phase"):
             queryset = queryset.filter(project_phase__in=filters["phase"])
 
-        # Apply search filter
+        # Apply search filter through the full-text index, best matches first
         if filters.get("search"):
-            search_term = filters["search"]
-            queryset = queryset.filter(
-                Q(obligation_number__icontains=search_term)
-                | Q(obligation__icontains=search_term)
-            )
+            queryset = search_obligations(queryset, filters["search"])
 
         # Apply date filter
         if filters.get("date_filter"):
@@ -198,9 +268,7 @@ def apply_filters(self, queryset: QuerySet, filters: dict[str, Any]) -> QuerySet
 
             if date_filter == "past_due":
                 # Past due - action_due_date is in the past and status isn't completed
-                queryset = queryset.filter(
-                    action_due_date__lt=today, status__ne="completed"
-                )
+                queryset = queryset.overdue(today)
             elif date_filter == "14days":
                 # Due in next 14 days
                 future_date = today + timedelta(days=14)
@@ -291,20 +359,19 @@ def get_context_data(self, **kwargs):
                     )
 
                     # Find overdue obligations
-                    overdue_obligations = []
-                    for obligation in queryset:
-                        if is_obligation_overdue(obligation):
-                            overdue_obligations.append(obligation.obligation_number)
-
-                    if overdue_obligations:
-                        queryset = queryset.filter(
-                            obligation_number__in=overdue_obligations
-                        )
+                    queryset = queryset.overdue()
+
+                    page = keyset_page(
+                        queryset, self.request, "action_due_date", count=queryset.count
+                    )
+                    if page:
                         # Create simple context for displaying just overdue obligations
                         context.update(
                             {
-                                "obligations": queryset,
-                                "total_count": len(queryset),
+                                "obligations": page,
+                                "page_obj": page,
+                                "pagination_query": pagination_query(self.request),
+                                "total_count": page.total_count,
                                 "filters": {"status": ["overdue"]},
                                 "show_overdue_only": True,
                             }
@@ -337,26 +404,47 @@ def get_context_data(self, **kwargs):
             # Apply filters and sorting
             queryset = self.apply_filters(queryset, filters)
 
-            sort_field = filters["sort"]
-            if filters["order"] == "desc":
-                sort_field = f"-{sort_field}"
-
-            queryset = queryset.order_by(sort_field)
-
-            # Paginate results
-            paginator = Paginator(queryset, 15)
-            page_number = self.request.GET.get("page", 1)
-            page_obj = paginator.get_page(page_number)
+            # Searches stay in rank order (offset cursors) unless a sort was
+            # asked for; any other order is paged by keyset on the sort column
+            sort_field = None
+            if not filters.get("search") or "sort" in self.request.GET:
+                sort_field = filters["sort"]
+                if sort_field not in SORTABLE_FIELDS:
+                    sort_field = "obligation_number"
+
+            # The total only changes with the filters, so it is cached with the
+            # project's other data instead of counted for every page
+            filter_key = urlencode(
+                sorted(
+                    (key, value)
+                    for key, value in filters.items()
+                    if key not in ("sort", "order")
+                ),
+                doseq=True,
+            )
+            count_key = "obligations:count:{}:{}".format(
+                mechanism_id, hashlib.md5(filter_key.encode()).hexdigest()
+            )
+            page_obj = keyset_page(
+                queryset,
+                self.request,
+                sort_field,
+                descending=filters["order"] == "desc",
+                count=lambda: cached(
+                    project_scope(mechanism.project_id), count_key, queryset.count
+                ),
+            )
 
             # Update context
             context.update(
                 {
                     "obligations": page_obj,
                     "page_obj": page_obj,
+                    "pagination_query": pagination_query(self.request),
                     "project": mechanism,
                     "mechanism_id": mechanism_id,
                     "filters": filters,
-                    "total_count": paginator.count,
+                    "total_count": page_obj.total_count,
                 }
             )
 
@@ -399,9 +487,8 @@ def get(self, request, *args, **kwargs):
         if not project_id:
             return JsonResponse({"error": "Project ID is required"}, status=400)
 
-        obligations = Obligation.objects.filter(project_id=project_id)
-        overdue_count = sum(
-            1 for obligation in obligations if is_obligation_overdue(obligation)
+        overdue_count = (
+            Obligation.objects.filter(project_id=project_id).overdue().count()
         )
 
         return JsonResponse(overdue_count, safe=False)
@@ -511,26 +598,6 @@ def get_context_data(self, **kwargs):
         context["project_id"] = self.object.project_id
         return context
 
-    def _update_mechanism_counts(
-        self, old_mechanism: EnvironmentalMechanism, updated_obligation: Obligation
-    ):
-        """Update obligation counts for mechanisms.
-
-        Args:
-            old_mechanism: Previous mechanism (if any)
-            updated_obligation: The updated obligation
-        """
-        if (
-            old_mechanism
-            and old_mechanism != updated_obligation.primary_environmental_mechanism
-        ):
-            old_mechanism.update_obligation_counts()
-            if updated_obligation.primary_environmental_mechanism:
-                mech = updated_obligation.primary_environmental_mechanism
-                mech.update_obligation_counts()
-        elif updated_obligation.primary_environmental_mechanism:
-            updated_obligation.primary_environmental_mechanism.update_obligation_counts()
-
     def form_valid(self, form):
         """Process the form submission with HTMX support.
 
@@ -541,13 +608,9 @@ def form_valid(self, form):
             Appropriate response based on request type
         """
         try:
-            old_mechanism = None
-            if self.object.primary_environmental_mechanism:
-                old_mechanism = self.object.primary_environmental_mechanism
-
-            # Save the updated obligation
+            # Save the updated obligation; the post_save signal recounts both
+            # the previous and the current mechanism
             obligation = form.save()
-            self._update_mechanism_counts(old_mechanism, obligation)
 
             messages.success(
                 self.request,
@@ -603,17 +666,12 @@ def post(self, request, *args, **kwargs):
         try:
             self.object = self.get_object()
             project_id = self.object.project_id
-            mechanism = self.object.primary_environmental_mechanism
             obl_number = kwargs.get("obligation_number")
 
-            # Delete the obligation
+            # Delete the obligation; the post_delete signal updates mechanism counts
             self.object.delete()
             logger.info("Obligation %s deleted successfully", obl_number)
 
-            # Update mechanism counts
-            if mechanism:
-                mechanism.update_obligation_counts()
-
             base_url = reverse("dashboard:home")
             return JsonResponse(
                 {
@@ -666,18 +724,42 @@ class ObligationListView(LoginRequiredMixin, ListView):
     def get_queryset(self):
         return Obligation.objects.all()
 
+    def get_context_data(self, **kwargs):
+        # Page by obligation number instead of counting and offsetting
+        page = keyset_page(self.object_list, self.request, "obligation_number")
+        kwargs.update(
+            {
+                "obligations": page,
+                "page_obj": page,
+                "pagination_query": pagination_query(self.request),
+            }
+        )
+        return super().get_context_data(**kwargs)
+
+
+def _can_access_obligation(user, obligation) -> bool:
+    """Check the user may see an obligation's evidence."""
+    return user.is_superuser or obligation.project_id in get_project_roles(user)
+
 
-def upload_evidence(request, obligation_id):
+@login_required
+def upload_evidence(request, obligation_number):
     """Handle evidence file uploads for an obligation.
 
+    The upload is hashed and stored content-addressed in chunks; Django
+    spools anything over FILE_UPLOAD_MAX_MEMORY_SIZE to a temporary file.
+
     Args:
         request: HTTP request
-        obligation_id: ID of the obligation to attach evidence to
+        obligation_number: Number of the obligation to attach evidence to
 
     Returns:
         Redirect to appropriate page
     """
-    obligation = get_object_or_404(Obligation, pk=obligation_id)
+    obligation = get_object_or_404(Obligation, pk=obligation_number)
+    if not _can_access_obligation(request.user, obligation):
+        raise Http404("Obligation not found")
+    detail_url = reverse("obligations:detail", args=[obligation.pk])
     evidence_count = ObligationEvidence.objects.filter(obligation=obligation).count()
 
     # Check if obligation already has 5 files
@@ -685,23 +767,82 @@ def upload_evidence(request, obligation_id):
         messages.error(
             request, "This obligation already has the maximum of 5 evidence files"
         )
-        return redirect("obligation_detail", obligation_id=obligation_id)
+        return redirect(detail_url)
 
     if request.method == "POST":
         form = EvidenceUploadForm(request.POST, request.FILES)
         if form.is_valid():
             evidence = form.save(commit=False)
             evidence.obligation = obligation
+            evidence.store_upload(form.cleaned_data["file"])
             evidence.save()
             messages.success(request, "Evidence file uploaded successfully")
-            return redirect("obligation_detail", obligation_id=obligation_id)
+            return redirect(detail_url)
+    else:
+        form = EvidenceUploadForm()
 
-    form = EvidenceUploadForm()
     return render(
         request,
-        "upload_evidence.html",
+        "obligations/form/upload_evidence.html",
         {
             "obligation": obligation,
             "form": form,
+            "project_id": obligation.project_id,
         },
     )
+
+
+@login_required
+def download_evidence(request, evidence_id):
+    """Serve an evidence file, with Range support or via X-Accel-Redirect."""
+    evidence = get_object_or_404(
+        ObligationEvidence.objects.select_related("obligation"), pk=evidence_id
+    )
+    if not _can_access_obligation(request.user, evidence.obligation):
+        raise Http404("Evidence not found")
+    return file_download_response(
+        request, evidence.file, filename=evidence.display_name, size=evidence.size
+    )
+
+
+@login_required
+def export_obligations(request):
+    """Stream the obligations of the user's projects as CSV, XLSX or Parquet.
+
+    ``?format=`` picks the output (default csv) and ``?project_id=`` limits it
+    to one project. Rows are read through a server-side cursor; CSV streams
+    as it is written and the other formats are spooled to a temporary file.
+    Under ASGI both are sent one chunk at a time (see core.utils.streaming).
+    """
+    fmt = request.GET.get("format", "csv").lower()
+    try:
+        require_export_format(fmt)
+    except (ValueError, ExportDependencyError) as exc:
+        return HttpResponse(str(exc), status=400, content_type="text/plain")
+
+    project_ids = None if request.user.is_superuser else set(
+        get_project_roles(request.user)
+    )
+    project_id = request.GET.get("project_id")
+    if project_id:
+        if not project_id.isdigit() or (
+            project_ids is not None and int(project_id) not in project_ids
+        ):
+            raise Http404("Project not found")
+        project_ids = {int(project_id)}
+
+    chunks = iter_export_chunks(export_queryset(project_ids))
+    filename = f"obligations.{fmt}"
+    if fmt == "csv":
+        response = StreamingHttpResponse(
+            stream_csv(chunks), content_type=EXPORT_CONTENT_TYPES[fmt]
+        )
+        response["Content-Disposition"] = f'attachment; filename="{filename}"'
+        return stream_async(request, response)
+    response = FileResponse(
+        export_to_file(fmt, chunks),
+        as_attachment=True,
+        filename=filename,
+        content_type=EXPORT_CONTENT_TYPES[fmt],
+    )
+    return stream_async(request, response)
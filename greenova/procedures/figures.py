@@ -1,27 +1,47 @@
 """Module for generating figures and statistics for procedures."""
 import io
 import logging
-from typing import Any, Dict, List, Optional, Tuple, Union, cast
+from typing import TYPE_CHECKING, Any, Dict, List, Optional, Tuple, Union, cast
 
-import matplotlib
-import matplotlib.pyplot as plt
-import numpy as np
+from core.utils.chart_cache import ChartSpec
 from django.db.models import Count, F, Q, QuerySet, Sum
-from matplotlib.axes import Axes
-from matplotlib.backends.backend_agg import FigureCanvasAgg
-from matplotlib.figure import Figure
-from matplotlib.ticker import MaxNLocator
 from obligations.models import Obligation
+from obligations.utils import overdue_q
 from procedures.models import Procedure
 from projects.models import Project
 
-matplotlib.use('Agg')
+if TYPE_CHECKING:
+    import numpy as np
+    from matplotlib.axes import Axes
+    from matplotlib.figure import Figure
 
 logger = logging.getLogger(__name__)
 
+# Obligation status values and the labels the procedure pie charts use
+STATUS_CHART_LABELS = {
+    'not started': 'Not Started',
+    'in progress': 'In Progress',
+    'completed': 'Completed',
+}
+PROCEDURE_STATUS_COLORS = ['#f39c12', '#3498db', '#2ecc71']
+# Obligation status values and the keys of the procedure table stats
+STATUS_STAT_KEYS = {
+    'not started': 'not_started',
+    'in progress': 'in_progress',
+    'completed': 'completed',
+}
+
+def _new_figure(**kwargs: Any) -> "Figure":
+    """Create a bare Figure, importing matplotlib on the first chart drawn."""
+    # pylint: disable=import-outside-toplevel
+    from matplotlib.figure import Figure
+
+    return Figure(**kwargs)
+
+
 def generate_procedure_statistics(
     project_slug: Optional[str] = None
-) -> Tuple[Figure, Dict[str, Any]]:
+) -> Tuple["Figure", Dict[str, Any]]:
     """Generate statistics and matplotlib figure for procedures."""
     proc_query_params: Dict[str, Any] = {}
     if project_slug:
@@ -41,35 +61,32 @@ def generate_procedure_statistics(
         'edgecolor': '#eeeeee',
     }
 
-    fig, axes = plt.subplots(
-        nrows=2,
-        ncols=1,
-        squeeze=True,
+    # A bare Figure is never registered with pyplot, so nothing leaks if the
+    # caller drops it or plotting fails
+    fig = _new_figure(
         figsize=fig_config['figsize'],
         dpi=fig_config['dpi'],
         facecolor=fig_config['facecolor'],
         edgecolor=fig_config['edgecolor']
     )
-    axes_array = cast(np.ndarray, axes)
+    axes = fig.subplots(nrows=2, ncols=1, squeeze=True)
+    axes_array = cast("np.ndarray", axes)
 
     try:
         if len(axes_array) >= 2:
-            _plot_procedure_status_chart(cast(Axes, axes_array[0]), stats)
-            _plot_procedure_timeline_chart(cast(Axes, axes_array[1]), stats)
+            _plot_procedure_status_chart(cast("Axes", axes_array[0]), stats)
+            _plot_procedure_timeline_chart(cast("Axes", axes_array[1]), stats)
         else:
             logger.error("Not enough axes created for plotting charts")
-            plt.close(fig)
             raise ValueError("Failed to create required chart axes")
     except (IndexError, ValueError) as e:
         logger.error("Error plotting procedure charts: %s", str(e))
-        plt.close(fig)
         raise
     except Exception as e:
         logger.error("Unexpected error in chart generation: %s", str(e))
-        plt.close(fig)
         raise
 
-    plt.tight_layout()
+    fig.tight_layout()
     return fig, stats
 
 
@@ -91,7 +108,7 @@ def _calculate_procedure_statistics(procedures: QuerySet) -> Dict[str, Any]:
     }
 
 
-def _plot_procedure_status_chart(ax: Axes, stats: Dict[str, Any]) -> None:
+def _plot_procedure_status_chart(ax: "Axes", stats: Dict[str, Any]) -> None:
     """Plot procedure status distribution chart."""
     status_labels = [item['status'] or 'Unknown' for item in stats['status_counts']]
     status_values = [item['count'] for item in stats['status_counts']]
@@ -107,8 +124,11 @@ def _plot_procedure_status_chart(ax: Axes, stats: Dict[str, Any]) -> None:
         ax.text(i, v + 0.1, str(v), ha='center')
 
 
-def _plot_procedure_timeline_chart(ax: Axes, stats: Dict[str, Any]) -> None:
+def _plot_procedure_timeline_chart(ax: "Axes", stats: Dict[str, Any]) -> None:
     """Plot procedure timeline chart."""
+    # pylint: disable=import-outside-toplevel
+    from matplotlib.ticker import MaxNLocator
+
     month_names = ['Jan', 'Feb', 'Mar', 'Apr', 'May', 'Jun',
                    'Jul', 'Aug', 'Sep', 'Oct', 'Nov', 'Dec']
 
@@ -125,63 +145,102 @@ def _plot_procedure_timeline_chart(ax: Axes, stats: Dict[str, Any]) -> None:
     ax.yaxis.set_major_locator(MaxNLocator(integer=True))
 
 
-def get_procedure_charts(
+def get_procedure_status_counts(
     mechanism_id: Union[str, int],
-    filtered_ids: Optional[List[int]] = None
-) -> Dict[str, Figure]:
-    """Generate charts for procedures related to an environmental mechanism."""
-    procedure_charts: Dict[str, Figure] = {}
-
-    try:
-        query = Obligation.objects.filter(
-            primary_environmental_mechanism_id=mechanism_id
-        )
-
-        if filtered_ids is not None:
-            query = query.filter(id__in=filtered_ids)
-
-        proc_names = query.values_list('procedure', flat=True).distinct().order_by(
-            'procedure'
+    filtered_ids: Optional[List[str]] = None,
+    procedure: Optional[str] = None
+) -> Dict[str, Dict[str, int]]:
+    """Count obligation statuses per procedure of a mechanism in one query."""
+    query = Obligation.objects.filter(
+        primary_environmental_mechanism_id=mechanism_id
+    )
+    if filtered_ids is not None:
+        query = query.filter(pk__in=filtered_ids)
+    if procedure is not None:
+        query = query.filter(procedure=procedure)
+
+    counts_by_procedure: Dict[str, Dict[str, int]] = {}
+    rows = (
+        query.exclude(procedure__isnull=True)
+        .exclude(procedure='')
+        .values('procedure', 'status')
+        .annotate(count=Count('pk'))
+        .order_by('procedure')
+    )
+    for row in rows:
+        status_counts = counts_by_procedure.setdefault(
+            row['procedure'], dict.fromkeys(STATUS_CHART_LABELS.values(), 0)
         )
+        label = STATUS_CHART_LABELS.get(row['status'])
+        if label:
+            status_counts[label] += row['count']
+    return counts_by_procedure
 
-        for proc_name in proc_names:
-            if not proc_name:
-                continue
-
-            proc_obligations = query.filter(procedure=proc_name)
-            status_counts = _get_status_counts(proc_obligations)
-
-            if sum(status_counts.values()) > 0:
-                fig = _create_pie_chart(proc_name, status_counts)
-            else:
-                fig = _create_empty_chart(proc_name)
 
-            procedure_charts[proc_name] = fig
-
-    except (Obligation.DoesNotExist, ValueError, TypeError) as e:
-        logger.error("Error generating procedure charts: %s", str(e))
-        fig = _create_error_chart(str(e))
-        procedure_charts["Error"] = fig
-
-    return procedure_charts
+def get_procedure_stats(obligations: QuerySet) -> Dict[str, Dict[str, int]]:
+    """
+    Count obligations per procedure, status and overdue state in one query.
 
+    Args:
+        obligations: The (possibly filtered) obligations to count
 
-def _get_status_counts(obligations: QuerySet) -> Dict[str, int]:
-    """Get counts of obligations by status."""
-    return {
-        'Not Started': obligations.filter(status='not started').count(),
-        'In Progress': obligations.filter(status='in progress').count(),
-        'Completed': obligations.filter(status='completed').count()
-    }
+    Returns:
+        dict: Procedure name -> ``not_started``, ``in_progress``,
+        ``completed``, ``overdue`` and ``total`` counts, ordered by name
+    """
+    rows = (
+        obligations.exclude(procedure__isnull=True)
+        .exclude(procedure='')
+        .values('procedure', 'status')
+        .annotate(count=Count('pk'), overdue=Count('pk', filter=overdue_q()))
+        .order_by('procedure')
+    )
+    stats_by_procedure: Dict[str, Dict[str, int]] = {}
+    for row in rows:
+        stats = stats_by_procedure.setdefault(
+            row['procedure'],
+            {**dict.fromkeys(STATUS_STAT_KEYS.values(), 0), 'overdue': 0, 'total': 0},
+        )
+        key = STATUS_STAT_KEYS.get(row['status'])
+        if key:
+            stats[key] += row['count']
+            stats['total'] += row['count']
+        stats['overdue'] += row['overdue']
+    return stats_by_procedure
+
+
+def get_procedure_chart_spec(
+    proc_name: str,
+    status_counts: Dict[str, int]
+) -> ChartSpec:
+    """Describe the status pie chart of one procedure."""
+    def render() -> "Figure":
+        if sum(status_counts.values()) > 0:
+            return _create_pie_chart(proc_name, status_counts)
+        return _create_empty_chart(proc_name)
+
+    return ChartSpec(
+        'procedure_status',
+        {'title': proc_name, 'counts': status_counts},
+        render,
+        series={
+            'type': 'pie',
+            'title': f"{proc_name} Status",
+            'labels': list(status_counts),
+            'values': list(status_counts.values()),
+            'colors': PROCEDURE_STATUS_COLORS,
+        },
+    )
 
 
-def _create_pie_chart(title: str, status_counts: Dict[str, int]) -> Figure:
+def _create_pie_chart(title: str, status_counts: Dict[str, int]) -> "Figure":
     """Create a pie chart for procedure status distribution."""
-    fig, ax = plt.subplots(figsize=(6, 5))
+    fig = _new_figure(figsize=(6, 5))
+    ax = fig.add_subplot(111)
 
     labels = list(status_counts.keys())
     sizes = list(status_counts.values())
-    colors = ['#f39c12', '#3498db', '#2ecc71']
+    colors = PROCEDURE_STATUS_COLORS
 
     ax.pie(
         sizes,
@@ -198,9 +257,10 @@ def _create_pie_chart(title: str, status_counts: Dict[str, int]) -> Figure:
     return fig
 
 
-def _create_empty_chart(title: str) -> Figure:
+def _create_empty_chart(title: str) -> "Figure":
     """Create an empty chart with a message."""
-    fig, ax = plt.subplots(figsize=(6, 5))
+    fig = _new_figure(figsize=(6, 5))
+    ax = fig.add_subplot(111)
     ax.text(
         0.5, 0.5,
         "No obligations found",
@@ -213,21 +273,6 @@ def _create_empty_chart(title: str) -> Figure:
     return fig
 
 
-def _create_error_chart(error_message: str) -> Figure:
-    """Create an error chart with the error message."""
-    fig, ax = plt.subplots(figsize=(6, 5))
-    ax.text(
-        0.5, 0.5,
-        f"Error generating charts: {error_message}",
-        ha='center',
-        va='center',
-        fontsize=10,
-        wrap=True
-    )
-    ax.axis('off')
-    return fig
-
-
 def get_all_procedure_charts() -> Dict[str, bytes]:
     """Generate all procedure charts and return them as a dictionary.
 
@@ -249,13 +294,10 @@ def get_all_procedure_charts() -> Dict[str, bytes]:
     completion_chart = get_completion_rate_chart()
     charts['completion_rate'] = chart_to_png(completion_chart)
 
-    # Clean up
-    plt.close('all')
-
     return charts
 
 
-def chart_to_png(fig: Figure) -> bytes:
+def chart_to_png(fig: "Figure") -> bytes:
     """Convert a matplotlib figure to PNG bytes.
 
     Args:
@@ -264,13 +306,16 @@ def chart_to_png(fig: Figure) -> bytes:
     Returns:
         bytes: PNG image data
     """
+    # pylint: disable=import-outside-toplevel
+    from matplotlib.backends.backend_agg import FigureCanvasAgg
+
     buf = io.BytesIO()
     canvas = FigureCanvasAgg(fig)
     canvas.print_png(buf)
     return buf.getvalue()
 
 
-def get_procedure_status_chart() -> Figure:
+def get_procedure_status_chart() -> "Figure":
     """Generate a pie chart showing distribution of procedure statuses.
 
     Returns:
@@ -286,14 +331,15 @@ def get_procedure_status_chart() -> Figure:
     counts = [s['count'] for s in status_counts]
 
     # Create figure
-    fig, ax = plt.subplots(figsize=(8, 6))
+    fig = _new_figure(figsize=(8, 6))
+    ax = fig.add_subplot(111)
     ax.pie(counts, labels=statuses, autopct='%1.1f%%')
     ax.set_title('Procedure Status Distribution')
 
     return fig
 
 
-def get_procedure_timeline() -> Figure:
+def get_procedure_timeline() -> "Figure":
     """Generate a timeline chart showing procedures over time.
 
     Returns:
@@ -310,14 +356,15 @@ def get_procedure_timeline() -> Figure:
     durations = [(p['end_date'] - p['start_date']).days for p in procedures]
 
     # Create figure
-    fig, ax = plt.subplots(figsize=(10, 6))
+    fig = _new_figure(figsize=(10, 6))
+    ax = fig.add_subplot(111)
     ax.barh(titles, durations, left=start_dates)
     ax.set_title('Procedure Timeline')
 
     return fig
 
 
-def get_completion_rate_chart() -> Figure:
+def get_completion_rate_chart() -> "Figure":
     """Generate a bar chart showing procedure completion rates.
 
     Returns:
@@ -336,7 +383,8 @@ def get_completion_rate_chart() -> Figure:
     completion_rates = [c / t * 100 for c, t in zip(completed, totals)]
 
     # Create figure
-    fig, ax = plt.subplots(figsize=(8, 6))
+    fig = _new_figure(figsize=(8, 6))
+    ax = fig.add_subplot(111)
     ax.bar(types, completion_rates)
     ax.set_title('Procedure Completion Rates by Type')
     ax.set_ylabel('Completion Rate (%)')
@@ -0,0 +1,62 @@
+"""Obligation filters shared by the procedure charts page and its chart images."""
+
+from datetime import timedelta
+
+from django.utils import timezone
+
+
+def apply_obligation_filters(obligations, request_params):
+    """Apply filters to obligations based on request parameters.
+
+    Returns the filtered queryset and the parsed filter values, including a
+    ``filters_applied`` flag.
+    """
+    filtered_obligations = obligations
+    phase_filter = request_params.get("phase", "")
+    responsibility_filter = request_params.get("responsibility", "")
+    status_filter = request_params.get("status", "")
+    look_ahead = request_params.get("lookahead", "") == "14days"
+    overdue_only = request_params.get("overdue", "") == "true"
+
+    if phase_filter:
+        filtered_obligations = filtered_obligations.filter(project_phase=phase_filter)
+
+    if responsibility_filter:
+        filtered_obligations = filtered_obligations.filter(
+            responsibility=responsibility_filter
+        )
+
+    if status_filter:
+        filtered_obligations = filtered_obligations.filter(status=status_filter)
+
+    if look_ahead:
+        today = timezone.now().date()
+        future_date = today + timedelta(days=14)
+        filtered_obligations = filtered_obligations.filter(
+            action_due_date__gte=today, action_due_date__lte=future_date
+        )
+
+    if overdue_only:
+        today = timezone.now().date()
+        filtered_obligations = filtered_obligations.overdue(today)
+
+    filters_applied = any(
+        [
+            phase_filter,
+            responsibility_filter,
+            status_filter,
+            look_ahead,
+            overdue_only,
+        ]
+    )
+
+    filter_params = {
+        "phase_filter": phase_filter,
+        "responsibility_filter": responsibility_filter,
+        "status_filter": status_filter,
+        "look_ahead": look_ahead,
+        "overdue_only": overdue_only,
+        "filters_applied": filters_applied,
+    }
+
+    return filtered_obligations, filter_params
@@ -1,27 +1,26 @@
-import base64
-import io
 import logging
-from datetime import timedelta
 from typing import Any
 
-import matplotlib
 from django.contrib.auth.mixins import LoginRequiredMixin
+from django.db.models import Count, Q
 from django.shortcuts import get_object_or_404
-from django.utils import timezone
 from django.utils.decorators import method_decorator
 from django.views.decorators.cache import cache_control
 from django.views.decorators.vary import vary_on_headers
 from django.views.generic import ListView, TemplateView
+from core.utils.chart_cache import chart_url
 from mechanisms.models import EnvironmentalMechanism
 from obligations.models import Obligation
-from responsibility.figures import get_responsibility_chart
 
-from .figures import get_procedure_charts as get_all_procedure_charts
+from .figures import get_procedure_stats
+from .filters import apply_obligation_filters
 from .models import Procedure
 
-matplotlib.use("Agg")  # Use Agg backend for non-interactive plotting
 logger = logging.getLogger(__name__)
 
+# Request parameters forwarded to chart image URLs so they plot the same rows
+CHART_FILTER_PARAMS = ("phase", "responsibility", "status", "lookahead", "overdue")
+
 
 @method_decorator(cache_control(max_age=300), name="dispatch")
 @method_decorator(vary_on_headers("HX-Request"), name="dispatch")
@@ -46,64 +45,15 @@ def _get_mechanism_and_obligations(self, mechanism_id):
 
     def _apply_filters(self, obligations, request_params):
         """Apply filters to obligations based on request parameters."""
-        filtered_obligations = obligations
-        phase_filter = request_params.get("phase", "")
-        responsibility_filter = request_params.get("responsibility", "")
-        status_filter = request_params.get("status", "")
-        look_ahead = request_params.get("lookahead", "") == "14days"
-        overdue_only = request_params.get("overdue", "") == "true"
-
-        if phase_filter:
-            filtered_obligations = filtered_obligations.filter(
-                project_phase=phase_filter
-            )
-
-        if responsibility_filter:
-            filtered_obligations = filtered_obligations.filter(
-                responsibility=responsibility_filter
-            )
-
-        if status_filter:
-            filtered_obligations = filtered_obligations.filter(status=status_filter)
-
-        if look_ahead:
-            today = timezone.now().date()
-            future_date = today + timedelta(days=14)
-            filtered_obligations = filtered_obligations.filter(
-                action_due_date__gte=today, action_due_date__lte=future_date
-            )
-
-        if overdue_only:
-            today = timezone.now().date()
-            filtered_obligations = filtered_obligations.filter(
-                action_due_date__lt=today
-            ).exclude(status="completed")
-
-        filters_applied = any(
-            [
-                phase_filter,
-                responsibility_filter,
-                status_filter,
-                look_ahead,
-                overdue_only,
-            ]
-        )
-
-        filter_params = {
-            "phase_filter": phase_filter,
-            "responsibility_filter": responsibility_filter,
-            "status_filter": status_filter,
-            "look_ahead": look_ahead,
-            "overdue_only": overdue_only,
-            "filters_applied": filters_applied,
-        }
-
-        return filtered_obligations, filter_params
+        return apply_obligation_filters(obligations, request_params)
 
     def _calculate_statistics(self, all_obligations):
         """Calculate statistics based on all obligations."""
-        total = all_obligations.count()
-        completed = all_obligations.filter(status="completed").count()
+        counts = all_obligations.aggregate(
+            total=Count("pk"), completed=Count("pk", filter=Q(status="completed"))
+        )
+        total = counts["total"]
+        completed = counts["completed"]
         remaining = total - completed
 
         if total > 0:
@@ -144,94 +94,37 @@ def _get_available_filters(self, all_obligations):
             "status_options": status_options,
         }
 
-    def _generate_responsibility_chart(
-        self, mechanism_id, filtered_obligations=None, filters_applied=False
-    ):
-        """Generate responsibility chart based on filtered obligations."""
-        if filters_applied and filtered_obligations is not None:
-            filtered_ids = filtered_obligations.values_list("id", flat=True)
-            fig = get_responsibility_chart(mechanism_id, filtered_ids=filtered_ids)
-        else:
-            fig = get_responsibility_chart(mechanism_id)
-
-        buf = io.BytesIO()
-        fig.savefig(buf, format="png", bbox_inches="tight")
-        buf.seek(0)
-
-        base64_data = base64.b64encode(buf.getvalue()).decode()
-        img_tag = (
-            f'<img src="data:image/png;base64,{base64_data}" '
-            f'alt="Responsibility Distribution Chart" '
-            f'width="600" height="300">'
-        )
+    def _chart_params(self, procedure=None):
+        """Query parameters that carry the page filters to chart image URLs."""
+        params = {key: self.request.GET.get(key) for key in CHART_FILTER_PARAMS}
+        params["procedure"] = procedure
+        return params
 
-        return img_tag
+    def _generate_responsibility_chart(self, mechanism_id):
+        """Return the responsibility chart image URL for the current filters."""
+        return chart_url("responsibility", mechanism_id, params=self._chart_params())
 
     def _generate_procedure_charts(
         self, mechanism_id, filtered_obligations, all_obligations, filters_applied
     ):
-        """Generate charts for each procedure."""
-        procedure_charts = []
-
-        # Get filtered IDs if filters are applied
-        filtered_ids = None
-        if filters_applied:
-            filtered_ids = filtered_obligations.values_list("id", flat=True)
-
-        # Generate charts for each procedure
-        charts_dict = get_all_procedure_charts(mechanism_id, filtered_ids=filtered_ids)
-
-        for procedure_name, fig in charts_dict.items():
-            # Create procedure chart data
-            procedure_data = self._create_procedure_chart_data(
-                procedure_name,
-                fig,
-                filtered_obligations if filters_applied else all_obligations,
-            )
-            procedure_charts.append(procedure_data)
-
-        return procedure_charts
-
-    def _create_procedure_chart_data(
-        self,
-        procedure_name,
-        fig,
-        obligations,
-        # Removed unused argument 'filters_applied'
-    ):
-        """Create data for a specific procedure chart."""
-        # Create image for this procedure
-        buf = io.BytesIO()
-        fig.savefig(buf, format="png", bbox_inches="tight")
-        buf.seek(0)
-
-        base64_data = base64.b64encode(buf.getvalue()).decode()
-        chart_img = (
-            f'<img src="data:image/png;base64,{base64_data}" '
-            f'alt="{procedure_name} Chart" '
-            f'width="300" height="250">'
-        )
-
-        # Get obligations for this procedure
-        proc_obligations = obligations.filter(procedure=procedure_name)
-
-        # Count status types
-        status_counts = {
-            "not_started": sum(
-                1 for o in proc_obligations if o.status == "not started"
-            ),
-            "in_progress": sum(
-                1 for o in proc_obligations if o.status == "in progress"
-            ),
-            "completed": sum(1 for o in proc_obligations if o.status == "completed"),
-            "overdue": sum(1 for o in proc_obligations if o.is_overdue),
-        }
-        status_counts["total"] = (
-            status_counts["not_started"]
-            + status_counts["in_progress"]
-            + status_counts["completed"]
-        )
-        return {"name": procedure_name, "chart": chart_img, "stats": status_counts}
+        """Generate charts for each procedure.
+
+        The stats of every procedure come from one grouped query; the chart
+        images load from the cached chart endpoint.
+        """
+        obligations = filtered_obligations if filters_applied else all_obligations
+        return [
+            {
+                "name": procedure_name,
+                "chart_url": chart_url(
+                    "procedure",
+                    mechanism_id,
+                    params=self._chart_params(procedure_name),
+                ),
+                "stats": stats,
+            }
+            for procedure_name, stats in get_procedure_stats(obligations).items()
+        ]
 
     def get_context_data(self, **kwargs) -> dict[str, Any]:
         """Get context data for rendering the template."""
@@ -285,10 +178,9 @@ def get_context_data(self, **kwargs) -> dict[str, Any]:
             )
 
             # Generate responsibility chart
-            responsibility_chart_img = self._generate_responsibility_chart(
-                mechanism_id, filtered_obligations, filter_params["filters_applied"]
+            context["responsibility_chart_url"] = self._generate_responsibility_chart(
+                mechanism_id
             )
-            context["responsibility_chart"] = responsibility_chart_img
 
             # Generate procedure charts
             procedure_charts = self._generate_procedure_charts(
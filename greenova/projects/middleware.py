@@ -0,0 +1,24 @@
+import logging
+
+from django.utils.deprecation import MiddlewareMixin
+from django.utils.functional import SimpleLazyObject
+
+from .models import get_project_roles
+
+logger = logging.getLogger(__name__)
+
+
+class ProjectRoleMiddleware(MiddlewareMixin):
+    """
+    Middleware to attach the user's project roles to the request object.
+
+    ``request.project_roles`` maps project id to the user's role. It is
+    loaded lazily with a single query the first time a view, the
+    Project.get_user_role() method or a role template tag needs it, and
+    then shared by all of them for the rest of the request.
+    """
+
+    def process_request(self, request):
+        request.project_roles = SimpleLazyObject(
+            lambda: get_project_roles(request.user)
+        )
@@ -1,21 +1,56 @@
 import logging
-from typing import TypeVar, cast
+from datetime import date
+from typing import Dict, Optional, TypeVar, cast
 
 from core.utils.roles import ProjectRole, get_role_choices
 from django.contrib.auth import get_user_model
 from django.contrib.auth.models import AbstractUser
 from django.db import models
-from django.db.models import QuerySet
+from django.db.models import Count, Max, QuerySet
+from django.db.models.signals import post_delete, post_save
+from django.dispatch import receiver
 from django.utils import timezone
+from obligations.utils import overdue_q
 
 logger = logging.getLogger(__name__)
 
 User = get_user_model()
 UserType = TypeVar('UserType', bound=models.Model)  # Type variable for User model
 
+# User attribute holding the per-request membership map
+PROJECT_ROLES_ATTR = '_project_roles'
+
+
+class ProjectQuerySet(models.QuerySet):
+    """QuerySet with per-project obligation statistics computed in SQL."""
+
+    def with_overdue_stats(
+            self,
+            reference_date: Optional[date] = None) -> 'ProjectQuerySet':
+        """
+        Annotate each project with ``overdue_count`` and ``last_due_date``.
+
+        ``last_due_date`` is the latest due date among the project's overdue
+        obligations. Both come from the same grouped query, so listings
+        built on this queryset do not query per project.
+        """
+        overdue = overdue_q(reference_date, prefix='obligations__')
+        return self.annotate(
+            overdue_count=Count('obligations', filter=overdue),
+            last_due_date=Max('obligations__action_due_date', filter=overdue),
+        )
+
+    def at_risk(self, reference_date: Optional[date] = None) -> 'ProjectQuerySet':
+        """Return projects with overdue obligations, most overdue first."""
+        return self.with_overdue_stats(reference_date).filter(
+            overdue_count__gt=0
+        ).order_by('-overdue_count', 'name')
+
 
 class Project(models.Model):
     """Project model to group obligations."""
+    objects = ProjectQuerySet.as_manager()
+
     name: models.CharField = models.CharField(max_length=200)
     description: models.TextField = models.TextField(blank=True)
     members: models.ManyToManyField = models.ManyToManyField(
@@ -42,28 +77,24 @@ def get_user_role(self, user: AbstractUser) -> str:
         """
         Get user's role in project.
 
+        Reads the user's membership map, so listing many projects costs one
+        membership query in total (see get_project_roles).
+
         Args:
             user: The user to check role for
 
         Returns:
             str: Role name or 'viewer' if no explicit role found
         """
-        try:
-            membership = ProjectMembership.objects.get(project=self, user=user)
-            logger.debug(
-                f'Found role {membership.role} for user {user} in project {self.name}'
-            )
-            return membership.role
-        except ProjectMembership.DoesNotExist:
+        role = get_project_roles(user).get(self.pk)
+        if role is None:
             logger.debug(f'No membership found for user {user} in project {self.name}')
             return ProjectRole.VIEWER.value
-        except Exception as e:
-            logger.error(f'Error getting user role: {str(e)}')
-            return ProjectRole.VIEWER.value
+        return role
 
     def has_member(self, user: AbstractUser) -> bool:
         """Check if user is a member of the project."""
-        return ProjectMembership.objects.filter(project=self, user=user).exists()
+        return self.pk in get_project_roles(user)
 
     def add_member(
             self,
@@ -84,6 +115,7 @@ def remove_member(self, user: AbstractUser) -> None:
             project=self,
             user=user
         ).delete()
+        clear_project_roles(user)
         logger.info(f'Removed user {user} from project {self.name}')
 
     def get_members_by_role(self, role: str) -> QuerySet[UserType]:
@@ -93,12 +125,41 @@ def get_members_by_role(self, role: str) -> QuerySet[UserType]:
             project_memberships__role=role
         ))
 
-    @property
-    def obligations(self):
-        """Get related obligations."""
-        # Move import inside method to avoid circular import
-        from obligations.models import Obligation
-        return Obligation.objects.filter(project=self)
+
+def get_project_roles(user: AbstractUser) -> Dict[int, str]:
+    """
+    Return the user's role in each of their projects, keyed by project id.
+
+    The map is loaded with one query and kept on the user object. Each
+    request gets a fresh ``request.user``, so the map lives for one request
+    (``projects.middleware.ProjectRoleMiddleware`` also exposes it as
+    ``request.project_roles``). Saving or deleting a membership instance
+    clears the map of the user object it holds; queryset updates and deletes
+    should call clear_project_roles() themselves.
+    """
+    if not getattr(user, 'is_authenticated', False):
+        return {}
+    roles = getattr(user, PROJECT_ROLES_ATTR, None)
+    if roles is None:
+        try:
+            roles = dict(
+                ProjectMembership.objects.filter(user=user).values_list(
+                    'project_id', 'role'
+                )
+            )
+        except Exception as e:
+            logger.error(f'Error loading project roles for user {user}: {str(e)}')
+            return {}
+        setattr(user, PROJECT_ROLES_ATTR, roles)
+    return roles
+
+
+def clear_project_roles(user: AbstractUser) -> None:
+    """Drop the cached membership map so the next lookup reloads it."""
+    try:
+        delattr(user, PROJECT_ROLES_ATTR)
+    except AttributeError:
+        pass
 
 
 class ProjectMembership(models.Model):
@@ -134,6 +195,14 @@ def __str__(self) -> str:
         return f'{username} - {project_name} ({self.role})'
 
 
+@receiver(post_save, sender=ProjectMembership)
+@receiver(post_delete, sender=ProjectMembership)
+def clear_member_project_roles(sender, instance, **kwargs):
+    """Reload the membership map of the user object a membership was saved with."""
+    if sender._meta.get_field('user').is_cached(instance):
+        clear_project_roles(instance.user)
+
+
 class ProjectObligation(models.Model):
     """Through model for project obligations."""
     project: models.ForeignKey = models.ForeignKey(
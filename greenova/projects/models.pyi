@@ -1,7 +1,23 @@
 # Stub file for projects.models
+from datetime import date
+from typing import Dict, Optional
 
+from django.contrib.auth.models import AbstractUser
 from django.db import models
 
-class Project(models.Model): ...
+PROJECT_ROLES_ATTR: str
+
+class ProjectQuerySet(models.QuerySet[Project]):
+    def with_overdue_stats(
+        self, reference_date: Optional[date] = ...
+    ) -> ProjectQuerySet: ...
+    def at_risk(self, reference_date: Optional[date] = ...) -> ProjectQuerySet: ...
+
+class Project(models.Model):
+    objects: ProjectQuerySet
+
+def get_project_roles(user: AbstractUser) -> Dict[int, str]: ...
+def clear_project_roles(user: AbstractUser) -> None: ...
+
 class ProjectMembership(models.Model): ...
 class ProjectObligation(models.Model): ...
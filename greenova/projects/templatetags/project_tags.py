@@ -29,6 +29,9 @@ def get_user_role(project: Project, user: AbstractUser) -> str:
     """
     Get user's role in project.
 
+    Reads the user's per-request role map, so rendering a table of projects
+    costs one membership query rather than one per row.
+
     Args:
         project: The project to check
         user: The user to get role for
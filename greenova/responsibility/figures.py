@@ -1,13 +1,61 @@
 import logging
-from typing import Dict, List, Optional
+from typing import TYPE_CHECKING, Dict, List, Optional
 
+from core.utils.chart_cache import ChartSpec
 from django.db.models import Count
-from matplotlib.figure import Figure
 from obligations.models import Obligation
 
+if TYPE_CHECKING:
+    from matplotlib.figure import Figure
+
 logger = logging.getLogger(__name__)
 
-def generate_responsibility_chart(responsibility_counts: Dict[str, int], fig_width: int = 600, fig_height: int = 300) -> Figure:
+def get_responsibility_counts(mechanism_id: int, filtered_ids: Optional[List[str]] = None) -> Dict[str, int]:
+    """
+    Count a mechanism's obligations by responsibility, largest first.
+
+    Args:
+        mechanism_id: ID of the environmental mechanism to filter by
+        filtered_ids: Optional obligation numbers (or a values_list queryset)
+            to restrict the count to
+
+    Returns:
+        Dictionary mapping responsibility names to counts
+    """
+    obligations = Obligation.objects.filter(primary_environmental_mechanism_id=mechanism_id)
+    if filtered_ids is not None:
+        obligations = obligations.filter(pk__in=filtered_ids)
+
+    responsibility_data = obligations.values('responsibility').annotate(
+        count=Count('obligation_number')
+    ).order_by('-count', 'responsibility')
+    return {item['responsibility']: item['count'] for item in responsibility_data}
+
+
+def get_responsibility_chart_spec(mechanism_id: int, fig_width: int = 600, fig_height: int = 300, filtered_ids: Optional[List[str]] = None) -> ChartSpec:
+    """
+    Describe the responsibility bar chart for a mechanism.
+
+    Only the counting query runs here; the chart is drawn on a cache miss.
+    """
+    counts = get_responsibility_counts(mechanism_id, filtered_ids)
+    return ChartSpec(
+        'responsibility',
+        counts,
+        lambda: generate_responsibility_chart(counts, fig_width, fig_height),
+        width=fig_width,
+        height=fig_height,
+        series={
+            'type': 'bar',
+            'title': 'Obligations by Responsibility',
+            'labels': list(counts),
+            'values': list(counts.values()),
+            'colors': ['#65a879'],
+        },
+    )
+
+
+def generate_responsibility_chart(responsibility_counts: Dict[str, int], fig_width: int = 600, fig_height: int = 300) -> "Figure":
     """
     Generate a horizontal bar chart showing obligation counts by responsibility.
 
@@ -19,6 +67,10 @@ def generate_responsibility_chart(responsibility_counts: Dict[str, int], fig_wid
     Returns:
         A matplotlib Figure with the horizontal bar chart
     """
+    # Loaded on the first render so workers start without matplotlib
+    # pylint: disable=import-outside-toplevel
+    from matplotlib.figure import Figure
+
     try:
         # Extract responsibility labels and counts
         labels = list(responsibility_counts.keys())
@@ -63,7 +115,7 @@ def generate_responsibility_chart(responsibility_counts: Dict[str, int], fig_wid
 
 
 # Keep the original function with correct implementation
-def get_responsibility_chart(mechanism_id: int, fig_width: int = 600, fig_height: int = 300, filtered_ids: Optional[List[int]] = None) -> Figure:
+def get_responsibility_chart(mechanism_id: int, fig_width: int = 600, fig_height: int = 300, filtered_ids: Optional[List[int]] = None) -> "Figure":
     """
     Generate a horizontal bar chart showing obligation counts by responsibility.
 
@@ -76,13 +128,16 @@ def get_responsibility_chart(mechanism_id: int, fig_width: int = 600, fig_height
     Returns:
         A matplotlib Figure with the horizontal bar chart
     """
+    # pylint: disable=import-outside-toplevel
+    from matplotlib.figure import Figure
+
     try:
         # Get obligations for this mechanism
         obligations = Obligation.objects.filter(primary_environmental_mechanism_id=mechanism_id)
 
         # Apply additional filtering if provided
         if filtered_ids is not None:
-            obligations = obligations.filter(id__in=filtered_ids)
+            obligations = obligations.filter(pk__in=filtered_ids)
 
         # Count obligations by responsibility using the ORM
         responsibility_data = obligations.values('responsibility').annotate(
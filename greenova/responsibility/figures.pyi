@@ -1,8 +1,18 @@
 # Stub file for responsibility.figures
 from typing import Dict, List, Optional
 
+from core.utils.chart_cache import ChartSpec
 from matplotlib.figure import Figure
 
+def get_responsibility_counts(
+    mechanism_id: int, filtered_ids: Optional[List[str]] = None
+) -> Dict[str, int]: ...
+def get_responsibility_chart_spec(
+    mechanism_id: int,
+    fig_width: int = ...,
+    fig_height: int = ...,
+    filtered_ids: Optional[List[str]] = None,
+) -> ChartSpec: ...
 def generate_responsibility_chart(
     responsibility_counts: Dict[str, int], fig_width: int = ..., fig_height: int = ...
 ) -> Figure: ...
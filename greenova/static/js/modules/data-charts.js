@@ -0,0 +1,223 @@
+/**
+ * Data Charts
+ *
+ * Draws charts in the browser from the JSON series served by the dashboard
+ * chart endpoint (settings.CHART_RENDER_MODE = "data"):
+ * 1. The server embeds <div data-chart-src="..."> with an <img> fallback
+ * 2. This module fetches the series and renders a small inline SVG
+ * 3. Only pie and horizontal bar charts are needed, so no chart library
+ */
+
+(function () {
+  'use strict';
+
+  const SELECTORS = {
+    chart: '[data-chart-src]:not([data-chart-ready])',
+  };
+
+  const ATTRS = {
+    src: 'data-chart-src',
+    ready: 'data-chart-ready',
+  };
+
+  const SVG_NS = 'http://www.w3.org/2000/svg';
+  const DEFAULT_COLORS = [
+    '#f9c74f',
+    '#90be6d',
+    '#43aa8b',
+    '#f94144',
+    '#577590',
+    '#f8961e',
+  ];
+
+  /**
+   * Create an SVG element with attributes
+   */
+  function svgElement(name, attrs) {
+    const el = document.createElementNS(SVG_NS, name);
+    Object.keys(attrs || {}).forEach((key) => el.setAttribute(key, attrs[key]));
+    return el;
+  }
+
+  function colorAt(series, index) {
+    const colors =
+      series.colors && series.colors.length ? series.colors : DEFAULT_COLORS;
+    return colors[index % colors.length];
+  }
+
+  function emptyMessage(svg, width, height) {
+    const text = svgElement('text', {
+      x: width / 2,
+      y: height / 2,
+      'text-anchor': 'middle',
+      'font-size': 12,
+    });
+    text.textContent = 'No data available';
+    svg.appendChild(text);
+  }
+
+  /**
+   * Pie chart with a legend showing value and percentage
+   */
+  function drawPie(series) {
+    const width = 320;
+    const height = 220;
+    const svg = svgElement('svg', { viewBox: `0 0 ${width} ${height}` });
+    const values = series.values || [];
+    const total = values.reduce((sum, value) => sum + value, 0);
+
+    if (total <= 0) {
+      emptyMessage(svg, width, height);
+      return svg;
+    }
+
+    const cx = 100;
+    const cy = height / 2;
+    const r = 90;
+    let angle = -Math.PI / 2;
+
+    values.forEach((value, index) => {
+      if (value <= 0) {
+        return;
+      }
+      const slice = (value / total) * Math.PI * 2;
+      const color = colorAt(series, index);
+      let shape;
+      if (value === total) {
+        shape = svgElement('circle', { cx, cy, r, fill: color });
+      } else {
+        const x1 = cx + r * Math.cos(angle);
+        const y1 = cy + r * Math.sin(angle);
+        const x2 = cx + r * Math.cos(angle + slice);
+        const y2 = cy + r * Math.sin(angle + slice);
+        const largeArc = slice > Math.PI ? 1 : 0;
+        shape = svgElement('path', {
+          d: `M${cx},${cy} L${x1},${y1} A${r},${r} 0 ${largeArc} 1 ${x2},${y2} Z`,
+          fill: color,
+          stroke: '#fff',
+          'stroke-width': 1,
+        });
+      }
+      svg.appendChild(shape);
+      angle += slice;
+    });
+
+    (series.labels || []).forEach((label, index) => {
+      const y = 20 + index * 18;
+      const value = values[index] || 0;
+      const pct = ((value / total) * 100).toFixed(1);
+      svg.appendChild(
+        svgElement('rect', {
+          x: 205,
+          y: y - 9,
+          width: 10,
+          height: 10,
+          fill: colorAt(series, index),
+        }),
+      );
+      const text = svgElement('text', { x: 220, y, 'font-size': 10 });
+      text.textContent = `${label} (${value} - ${pct}%)`;
+      svg.appendChild(text);
+    });
+
+    return svg;
+  }
+
+  /**
+   * Horizontal bar chart, largest value first as sent by the server
+   */
+  function drawBar(series) {
+    const labels = series.labels || [];
+    const values = series.values || [];
+    const rowHeight = 22;
+    const labelWidth = 160;
+    const width = 600;
+    const height = Math.max(rowHeight * labels.length + 20, 80);
+    const svg = svgElement('svg', { viewBox: `0 0 ${width} ${height}` });
+    const max = Math.max(0, ...values);
+
+    if (max <= 0) {
+      emptyMessage(svg, width, height);
+      return svg;
+    }
+
+    const scale = (width - labelWidth - 40) / max;
+    labels.forEach((label, index) => {
+      const y = 10 + index * rowHeight;
+      const value = values[index] || 0;
+      const name = svgElement('text', {
+        x: labelWidth - 6,
+        y: y + 14,
+        'text-anchor': 'end',
+        'font-size': 11,
+      });
+      name.textContent = label;
+      svg.appendChild(name);
+      svg.appendChild(
+        svgElement('rect', {
+          x: labelWidth,
+          y: y + 3,
+          width: value * scale,
+          height: rowHeight - 6,
+          fill: colorAt(series, 0),
+        }),
+      );
+      const count = svgElement('text', {
+        x: labelWidth + value * scale + 4,
+        y: y + 14,
+        'font-size': 11,
+      });
+      count.textContent = String(value);
+      svg.appendChild(count);
+    });
+
+    return svg;
+  }
+
+  const RENDERERS = {
+    pie: drawPie,
+    bar: drawBar,
+  };
+
+  /**
+   * Fetch and draw one chart container
+   */
+  function renderChart(container) {
+    container.setAttribute(ATTRS.ready, 'loading');
+    fetch(container.getAttribute(ATTRS.src), {
+      credentials: 'same-origin',
+      headers: { Accept: 'application/json' },
+    })
+      .then((response) => {
+        if (!response.ok) {
+          throw new Error(`Chart request failed: ${response.status}`);
+        }
+        return response.json();
+      })
+      .then((series) => {
+        const draw = RENDERERS[series.type] || drawPie;
+        const svg = draw(series);
+        if (series.title) {
+          const title = svgElement('title', {});
+          title.textContent = series.title;
+          svg.insertBefore(title, svg.firstChild);
+        }
+        container.replaceChildren(svg);
+        container.setAttribute(ATTRS.ready, 'true');
+      })
+      .catch((err) => {
+        console.error('Error rendering chart:', err);
+        container.setAttribute(ATTRS.ready, 'error');
+      });
+  }
+
+  function initCharts(root) {
+    (root || document).querySelectorAll(SELECTORS.chart).forEach(renderChart);
+  }
+
+  document.addEventListener('DOMContentLoaded', () => initCharts(document));
+  // Chart fragments are frequently swapped in by htmx
+  document.addEventListener('htmx:afterSwap', (event) =>
+    initCharts(event.target),
+  );
+})();
@@ -0,0 +1,134 @@
+/**
+ * Live Dashboard
+ *
+ * Keeps an open dashboard current without re-fetching its partials:
+ * 1. The dashboard embeds <div data-live-src="/ws/dashboard/<project>/">
+ * 2. This module holds one WebSocket to that path, reopened when htmx swaps
+ *    in another project and dropped when the element goes away
+ * 3. Each message (see dashboard/live.py) patches the summary cards
+ *    ([data-live-stat]) and the changed obligation rows in place
+ */
+
+(function () {
+  'use strict';
+
+  const SELECTORS = {
+    source: '[data-live-src]',
+  };
+
+  const ATTRS = {
+    src: 'data-live-src',
+    stat: 'data-live-stat',
+    row: 'data-obligation-row',
+    field: 'data-live-field',
+  };
+
+  // Sent by DashboardConsumer to users who are not project members
+  const CLOSE_FORBIDDEN = 4403;
+  const RECONNECT_DELAY_MS = 5000;
+
+  let socket = null;
+  let socketPath = null;
+  let reconnectTimer = null;
+
+  function socketUrl(path) {
+    const scheme = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
+    return `${scheme}//${window.location.host}${path}`;
+  }
+
+  function patchStats(stats) {
+    Object.keys(stats || {}).forEach((name) => {
+      document
+        .querySelectorAll(`[${ATTRS.stat}="${name}"]`)
+        .forEach((el) => {
+          el.textContent = String(stats[name]);
+        });
+    });
+  }
+
+  /**
+   * Update or remove the rows showing the changed obligation
+   */
+  function patchRow(row) {
+    if (!row) {
+      return;
+    }
+    const selector = `[${ATTRS.row}="${CSS.escape(row.obligation_number)}"]`;
+    document.querySelectorAll(selector).forEach((tr) => {
+      if (row.deleted) {
+        tr.remove();
+        return;
+      }
+      const cells = {
+        status: row.status_html,
+        due_date: row.due_date_html,
+      };
+      Object.keys(cells).forEach((field) => {
+        const cell = tr.querySelector(`[${ATTRS.field}="${field}"]`);
+        // Rendered and escaped by obligation_tags on the server
+        if (cell) {
+          cell.innerHTML = cells[field];
+        }
+      });
+    });
+  }
+
+  function handleMessage(event) {
+    let delta;
+    try {
+      delta = JSON.parse(event.data);
+    } catch (err) {
+      console.error('Invalid dashboard update:', err);
+      return;
+    }
+    patchStats(delta.stats);
+    (delta.obligations || []).forEach(patchRow);
+  }
+
+  function connect(path) {
+    const ws = new WebSocket(socketUrl(path));
+    socket = ws;
+    ws.addEventListener('message', handleMessage);
+    ws.addEventListener('close', (event) => {
+      if (socket === ws) {
+        socket = null;
+      }
+      // Reconnect after dropped connections, not refusals or our own close
+      if (socketPath === path && event.code !== CLOSE_FORBIDDEN) {
+        reconnectTimer = window.setTimeout(
+          () => connect(path),
+          RECONNECT_DELAY_MS,
+        );
+      }
+    });
+  }
+
+  function disconnect() {
+    socketPath = null;
+    window.clearTimeout(reconnectTimer);
+    if (socket) {
+      socket.close();
+      socket = null;
+    }
+  }
+
+  /**
+   * Match the open socket to the data-live-src element on the page
+   */
+  function syncSocket() {
+    const source = document.querySelector(SELECTORS.source);
+    const path = source ? source.getAttribute(ATTRS.src) : null;
+    if (path === socketPath) {
+      return;
+    }
+    disconnect();
+    if (path && 'WebSocket' in window) {
+      socketPath = path;
+      connect(path);
+    }
+  }
+
+  document.addEventListener('DOMContentLoaded', syncSocket);
+  // Selecting another project swaps the dashboard content in with htmx
+  document.addEventListener('htmx:afterSwap', syncSocket);
+})();
@@ -0,0 +1,348 @@
+"""
+Performance regression benchmarks for the Greenova project.
+
+A dataset seeded from ``dummy_data.csv`` is scaled to ``BENCHMARK_SCALE``
+obligations (default 500, so the suite runs with the unit tests; use 10000
+or 100000 on the benchmark runner) across many mechanisms. Each case then
+checks a query budget: the query count must stay under its ceiling and must
+not grow when more projects, mechanisms and obligations are added, which is
+how an N+1 shows up. The p95 time of ``BENCHMARK_ROUNDS`` runs (at least
+20, so the p95 is not just the slowest run) is measured with
+pytest-benchmark when it is installed and fails the case when it is over
+budget; without the plugin a plain timer is used and budgets are only
+enforced with ``--timing-budgets``. The timing budgets are for 10000
+obligations on the reference runner.
+"""
+
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+import csv
+import math
+import os
+import time
+from dataclasses import dataclass
+from datetime import timedelta
+from pathlib import Path
+from typing import Any, Callable, Dict, List
+
+import pytest
+from chatbot.models import TrainingData
+from chatbot.services import ChatbotService
+from core.utils import chart_cache
+from django.core.cache import cache
+from django.core.management import call_command
+from django.db import connection
+from django.test.utils import CaptureQueriesContext
+from django.urls import reverse
+from django.utils import timezone
+from mechanisms.models import EnvironmentalMechanism, update_mechanism_counts
+from obligations.bulk_import import DEFAULT_BATCH_SIZE
+from obligations.models import Obligation, format_obligation_number
+from projects.models import Project, ProjectMembership
+
+HTTP_OK = 200
+
+BENCHMARK_SCALE = int(os.environ.get("BENCHMARK_SCALE", "500"))
+# Fewer rounds would make the p95 the slowest run; 0 skips the timings
+P95_MIN_ROUNDS = 20
+BENCHMARK_ROUNDS = int(os.environ.get("BENCHMARK_ROUNDS", "40"))
+
+DUMMY_DATA = Path(__file__).resolve().parent.parent / "dummy_data.csv"
+# Seeded obligation numbers start here, clear of the other tests' numbers
+SEED_NUMBER_OFFSET = 100000
+OBLIGATIONS_PER_MECHANISM = 200
+SEED_PROJECTS = 3
+
+
+def _dummy_rows() -> List[Dict[str, str]]:
+    with DUMMY_DATA.open(encoding="utf-8", newline="") as csv_file:
+        return list(csv.DictReader(csv_file))
+
+
+def _obligation_from_row(
+    row: Dict[str, str], number: int, mechanism: EnvironmentalMechanism
+) -> Obligation:
+    """Build an unsaved obligation from a dummy row, due around today."""
+    today = timezone.now().date()
+    return Obligation(
+        obligation_number=format_obligation_number(number),
+        obligation=row["obligation"],
+        project_id=mechanism.project_id,
+        primary_environmental_mechanism=mechanism,
+        procedure=row["procedure"],
+        environmental_aspect=row["environmental__aspect"][:255],
+        accountability=row["accountability"][:255],
+        responsibility=row["responsibility"][:255],
+        project_phase=row["project_phase"][:255],
+        status=row["status"].strip().lower() or "not started",
+        # Spread due dates from two months overdue to four months out
+        action_due_date=today + timedelta(days=number % 180 - 60),
+        recurring_obligation=row["recurring__obligation"] == "True",
+        recurring_frequency=row["recurring__frequency"],
+    )
+
+
+def seed_obligations(
+    projects: List[Project], count: int, first_number: int, mechanisms_per_project: int
+) -> List[EnvironmentalMechanism]:
+    """Create mechanisms and ``count`` obligations spread over them."""
+    rows = _dummy_rows()
+    mechanisms = EnvironmentalMechanism.objects.bulk_create(
+        EnvironmentalMechanism(
+            name=f"{project.name} Mechanism {index}", project=project
+        )
+        for project in projects
+        for index in range(mechanisms_per_project)
+    )
+    Obligation.objects.bulk_create(
+        (
+            _obligation_from_row(
+                rows[index % len(rows)],
+                first_number + index,
+                mechanisms[index % len(mechanisms)],
+            )
+            for index in range(count)
+        ),
+        batch_size=DEFAULT_BATCH_SIZE,
+    )
+    update_mechanism_counts([mechanism.id for mechanism in mechanisms])
+    TrainingData.objects.bulk_create(
+        TrainingData(question=row["obligation"][:500], answer=row["procedure"])
+        for row in rows[: max(count // 50, 1)]
+    )
+    return mechanisms
+
+
+@dataclass
+class BenchmarkData:
+    project: Project
+    mechanism: EnvironmentalMechanism
+    procedure: str
+    next_number: int
+
+
+@pytest.fixture(name="benchmark_data", scope="module")
+def benchmark_data_fixture(django_db_setup, django_db_blocker):
+    """Seed the scaled dataset once for the module and remove it afterwards."""
+    with django_db_blocker.unblock():
+        projects = [
+            Project.objects.create(name=f"Benchmark Project {index}")
+            for index in range(SEED_PROJECTS)
+        ]
+        mechanisms_per_project = max(
+            BENCHMARK_SCALE // OBLIGATIONS_PER_MECHANISM // SEED_PROJECTS, 2
+        )
+        mechanisms = seed_obligations(
+            projects, BENCHMARK_SCALE, SEED_NUMBER_OFFSET, mechanisms_per_project
+        )
+        procedure = (
+            Obligation.objects.filter(primary_environmental_mechanism=mechanisms[0])
+            .values_list("procedure", flat=True)
+            .first()
+        )
+    yield BenchmarkData(
+        projects[0], mechanisms[0], procedure, SEED_NUMBER_OFFSET + BENCHMARK_SCALE
+    )
+    with django_db_blocker.unblock():
+        Project.objects.filter(id__in=[project.id for project in projects]).delete()
+        TrainingData.objects.all().delete()
+        cache.clear()
+
+
+def grow_dataset(data: BenchmarkData) -> None:
+    """Add projects, mechanisms and obligations (rolled back with the test)."""
+    extra_projects = [
+        Project.objects.create(name=f"Benchmark Growth {index}") for index in range(2)
+    ]
+    count = max(BENCHMARK_SCALE // 2, 50)
+    seed_obligations([data.project, *extra_projects], count, data.next_number, 2)
+    # The original mechanism gets more rows of its own too
+    rows = _dummy_rows()
+    Obligation.objects.bulk_create(
+        _obligation_from_row(rows[index % len(rows)], number, data.mechanism)
+        for index, number in enumerate(
+            range(data.next_number + count, data.next_number + 2 * count)
+        )
+    )
+    update_mechanism_counts([data.mechanism.id])
+    TrainingData.objects.create(question="Where is the register?", answer="Here.")
+
+
+def count_queries(run: Callable[[], Any]) -> int:
+    """Run once on a cold cache and return the number of queries made."""
+    cache.clear()
+    with CaptureQueriesContext(connection) as queries:
+        run()
+    return len(queries)
+
+
+def check_timing(
+    request: pytest.FixtureRequest,
+    case_name: str,
+    run: Callable[[], Any],
+    budget: float,
+    rounds: int = BENCHMARK_ROUNDS,
+) -> None:
+    """
+    Time ``run`` and fail the case if its p95 is over ``budget`` milliseconds.
+
+    Budgets are enforced whenever pytest-benchmark measures the runs, and
+    for the plain timer only with ``--timing-budgets``.
+    """
+    if rounds <= 0:
+        return
+    rounds = max(rounds, P95_MIN_ROUNDS)
+    try:
+        benchmark = request.getfixturevalue("benchmark")
+    except pytest.FixtureLookupError:
+        benchmark = None
+    if benchmark is not None:
+        if benchmark.disabled:
+            return
+        benchmark.pedantic(run, rounds=rounds, warmup_rounds=1)
+        samples = sorted(benchmark.stats.stats.data)
+        enforced = True
+    else:
+        run()
+        samples = []
+        for _ in range(rounds):
+            started = time.perf_counter()
+            run()
+            samples.append(time.perf_counter() - started)
+        samples.sort()
+        enforced = request.config.getoption("timing_budgets")
+    ms = samples[math.ceil(0.95 * len(samples)) - 1] * 1000
+    if enforced and ms > budget:
+        pytest.fail(f"{case_name}: p95 {ms:.0f}ms is over its {budget:.0f}ms budget")
+
+
+@dataclass(frozen=True)
+class Case:
+    """One benchmarked request: how to build it and what it may cost."""
+
+    name: str
+    url: Callable[[BenchmarkData], str]
+    max_queries: int
+    p95_budget_ms: float
+
+
+VIEW_CASES = [
+    Case(
+        "dashboard_home",
+        lambda data: reverse("dashboard:home") + f"?project_id={data.project.id}",
+        max_queries=40,
+        p95_budget_ms=400,
+    ),
+    Case(
+        "projects_at_risk",
+        lambda data: reverse("dashboard:projects_at_risk"),
+        max_queries=15,
+        p95_budget_ms=200,
+    ),
+    Case(
+        "obligation_summary",
+        lambda data: reverse("obligations:summary")
+        + f"?mechanism_id={data.mechanism.id}&project_id={data.project.id}",
+        max_queries=30,
+        p95_budget_ms=400,
+    ),
+    Case(
+        "procedure_charts",
+        lambda data: reverse(
+            "procedures:procedure_charts", kwargs={"mechanism_id": data.mechanism.id}
+        ),
+        max_queries=30,
+        p95_budget_ms=400,
+    ),
+    Case(
+        "procedure_chart_image",
+        lambda data: chart_cache.chart_url(
+            "procedure", data.mechanism.id, params={"procedure": data.procedure}
+        ),
+        max_queries=20,
+        p95_budget_ms=300,
+    ),
+]
+
+
+@pytest.mark.django_db
+@pytest.mark.parametrize("case", VIEW_CASES, ids=lambda case: case.name)
+def test_view_stays_within_query_budget(
+    case, benchmark_data, admin_client, admin_user, request
+):
+    """Query counts stay under budget and do not grow with the data."""
+    ProjectMembership.objects.create(user=admin_user, project=benchmark_data.project)
+    url = case.url(benchmark_data)
+
+    def run():
+        response = admin_client.get(url)
+        assert response.status_code == HTTP_OK
+        return response
+
+    # The first request stores the project selection in the session
+    run()
+    queries = count_queries(run)
+    assert queries <= case.max_queries, f"{case.name}: {queries} queries"
+
+    check_timing(request, case.name, run, case.p95_budget_ms)
+
+    grow_dataset(benchmark_data)
+    assert count_queries(run) == queries, f"{case.name}: queries grow with data"
+
+
+@pytest.mark.django_db
+def test_chatbot_replies_are_answered_from_the_index(benchmark_data, request):
+    """Warm chatbot replies make no queries, however much training data exists."""
+    question = "When is the induction required?"
+
+    def run():
+        return ChatbotService._generate_response(question)
+
+    run()
+    with CaptureQueriesContext(connection) as queries:
+        run()
+    assert len(queries) == 0
+
+    check_timing(request, "chatbot_reply", run, 50)
+
+    grow_dataset(benchmark_data)
+    run()
+    with CaptureQueriesContext(connection) as queries:
+        run()
+    assert len(queries) == 0
+
+
+@pytest.mark.django_db
+def test_bulk_import_queries_scale_with_batches_not_rows(tmp_path, request):
+    """A bulk import costs a bounded number of queries per batch."""
+    rows = _dummy_rows()
+    count = max(BENCHMARK_SCALE, len(rows))
+    import_file = tmp_path / "obligations.csv"
+    with import_file.open("w", encoding="utf-8", newline="") as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames=list(rows[0]))
+        writer.writeheader()
+        for index in range(count):
+            row = dict(rows[index % len(rows)])
+            row["obligation__number"] = f"PCEMP-{2 * SEED_NUMBER_OFFSET + index}"
+            writer.writerow(row)
+
+    def run():
+        call_command(
+            "import_obligations",
+            str(import_file),
+            project="Benchmark Import",
+            bulk=True,
+            update=True,
+        )
+
+    with CaptureQueriesContext(connection) as queries:
+        run()
+    assert Obligation.objects.filter(project__name="Benchmark Import").count() == count
+
+    batches = math.ceil(count / DEFAULT_BATCH_SIZE)
+    budget = 20 + 10 * batches
+    assert len(queries) <= budget, f"bulk import: {len(queries)} queries"
+
+    # Re-importing updates the same rows in place
+    check_timing(request, "bulk_import", run, 30000, rounds=P95_MIN_ROUNDS)
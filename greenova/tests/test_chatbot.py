@@ -0,0 +1,114 @@
+"""
+Unit tests for the chatbot app in the Greenova project.
+
+These tests cover reply retrieval from training data and predefined
+responses.
+"""
+
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+import json
+
+import pytest
+from chatbot.models import ChatMessage, Conversation, PredefinedResponse, TrainingData
+from chatbot.retrieval import TriggerMatcher
+from chatbot.services import ChatbotService
+from django.test import Client
+from django.urls import reverse
+
+
+def test_trigger_matcher_finds_overlapping_phrases():
+    """Test the automaton reports every trigger inside the text."""
+    matcher = TriggerMatcher(
+        [(1, "reset"), (2, "reset password"), (3, "password"), (4, "password now")]
+    )
+    assert matcher.find("How do I RESET PASSWORD now?") == {1, 2, 3, 4}
+    assert matcher.find("nothing") == set()
+
+
+def test_trigger_matcher_only_matches_whole_words():
+    """Test triggers do not fire inside longer words."""
+    matcher = TriggerMatcher([(1, "hi"), (2, "help me"), (3, "c++")])
+    assert matcher.find("Which of this is it?") == set()
+    assert matcher.find("Hi! Can you help me?") == {1, 2}
+    assert matcher.find("help meeting notes") == set()
+    assert matcher.find("hi_there") == set()
+    assert matcher.find("c++") == {3}
+    assert matcher.find("Is c++x supported?") == {3}
+
+
+@pytest.mark.django_db
+def test_replies_follow_indexed_training_data(
+    django_assert_num_queries, django_capture_on_commit_callbacks
+):
+    """Test replies are ranked from the index and rebuilt after changes."""
+    with django_capture_on_commit_callbacks(execute=True):
+        TrainingData.objects.create(
+            question="How do I add an obligation?", answer="Use the add button."
+        )
+        TrainingData.objects.create(
+            question="How do I delete a project?", answer="Ask a project owner."
+        )
+        PredefinedResponse.objects.create(
+            trigger_phrase="reset password",
+            response_text="Use the reset link.",
+            priority=1,
+        )
+
+    assert ChatbotService._generate_response("delete my project") == (
+        "Ask a project owner."
+    )
+    assert ChatbotService._check_predefined_responses(
+        "How do I Reset Password now?"
+    ) == "Use the reset link."
+    # Once built, the indexes answer without querying the database
+    with django_assert_num_queries(0):
+        ChatbotService._generate_response("add an obligation")
+
+    # Rebuilt only once the change commits
+    with django_capture_on_commit_callbacks(execute=True):
+        TrainingData.objects.create(
+            question="Where are the charts?", answer="On the dashboard."
+        )
+        assert ChatbotService._generate_response("charts") != "On the dashboard."
+    assert ChatbotService._generate_response("charts") == "On the dashboard."
+    assert ChatbotService._generate_response("unrelated") == (
+        "I'm sorry, I don't have an answer for that question."
+    )
+
+
+@pytest.mark.django_db
+def test_stream_message_saves_exchange_and_streams_reply(
+    authenticated_client: Client, regular_user, django_capture_on_commit_callbacks
+):
+    """Test the SSE endpoint saves both messages and streams the reply."""
+    with django_capture_on_commit_callbacks(execute=True):
+        TrainingData.objects.create(
+            question="Where are the charts?", answer="On the dashboard page."
+        )
+    conversation = Conversation.objects.create(user=regular_user)
+    updated_at = conversation.updated_at
+
+    response = authenticated_client.post(
+        reverse("chatbot:stream_message", args=[conversation.id]),
+        data=json.dumps({"message": "charts"}),
+        content_type="application/json",
+    )
+    assert response["Content-Type"] == "text/event-stream"
+    events = [
+        (block.split("\n")[0][len("event: "):], json.loads(block.split("\n")[1][6:]))
+        for block in b"".join(response).decode().strip().split("\n\n")
+    ]
+
+    assert [name for name, _ in events] == ["user"] + ["token"] * 4 + ["done"]
+    assert "".join(data["content"] for name, data in events if name == "token") == (
+        "On the dashboard page."
+    )
+    assert list(
+        ChatMessage.objects.filter(conversation=conversation)
+        .order_by("timestamp")
+        .values_list("is_bot", "content")
+    ) == [(False, "charts"), (True, "On the dashboard page.")]
+    conversation.refresh_from_db()
+    assert conversation.updated_at > updated_at
@@ -9,7 +9,8 @@
 # SPDX-License-Identifier: AGPL-3.0-or-later
 
 import pytest
-from company.models import Company, CompanyMembership
+from company.models import Company, CompanyDocument, CompanyMembership
+from django.core.files.uploadedfile import SimpleUploadedFile
 from django.urls import reverse
 from users.models import User
 
@@ -190,3 +191,27 @@ def test_company_membership_removal(authenticated_client, test_company, regular_
 
     assert response.status_code == HTTP_OK  # HTMX response is 200 OK
     assert not CompanyMembership.objects.filter(id=membership.id).exists()
+
+
+@pytest.mark.django_db
+def test_company_document_names_fit_whatever_the_extension(settings, tmp_path):
+    """Test stored document names keep short extensions and drop long ones."""
+    settings.MEDIA_ROOT = str(tmp_path)
+    company = Company.objects.create(name="Document Company")
+    max_length = CompanyDocument._meta.get_field("file").max_length
+
+    for upload_name, extension in (
+        ("Report.PDF", ".pdf"),
+        ("archive." + "x" * 60, ""),
+        ("notes.tar gz", ""),
+    ):
+        document = CompanyDocument(company=company, name=upload_name)
+        document.store_upload(SimpleUploadedFile(upload_name, upload_name.encode()))
+        document.save()
+
+        stored = document.file.name
+        assert stored == f"company_documents/sha256/{document.sha256[:2]}/" + (
+            f"{document.sha256[2:4]}/{document.sha256}{extension}"
+        )
+        assert len(stored) <= max_length
+        assert document.display_name == upload_name
@@ -0,0 +1,176 @@
+"""
+Unit tests for the core app in the Greenova project.
+
+These tests cover the request instrumentation middleware, which reports
+where a staff request spent its time in the Server-Timing header, the
+background job queue, and the synthetic data generator for load tests.
+"""
+
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+import json
+
+import pytest
+from asgiref.sync import async_to_sync
+from company.models import Company, CompanyMembership
+from core.jobs import _claim_jobs, _fail_jobs, run_pending_jobs
+from core.models import BackgroundJob
+from core.utils import chart_cache
+from django.core.management import call_command
+from django.test import AsyncClient
+from mechanisms.models import EnvironmentalMechanism
+from obligations.models import Obligation
+from projects.models import Project, ProjectMembership
+from users.models import User
+
+HTTP_OK = 200
+
+
+@pytest.mark.django_db
+def test_server_timing_header_breaks_down_chart_requests(admin_client, settings):
+    """Staff responses report query, chart and cache time in Server-Timing."""
+    settings.SERVER_TIMING_HEADER = False
+    project = Project.objects.create(name="Timing Project")
+    mechanism = EnvironmentalMechanism.objects.create(
+        name="Timing Mechanism", project=project
+    )
+    Obligation.objects.create(
+        obligation_number="OBL001",
+        obligation="Timed Obligation",
+        status="not started",
+        primary_environmental_mechanism=mechanism,
+        project=project,
+        procedure="Waste Management",
+    )
+    url = chart_cache.chart_url(
+        "procedure", mechanism.id, params={"procedure": "Waste Management"}
+    )
+
+    response = admin_client.get(url)
+    assert response.status_code == HTTP_OK
+    metrics = {
+        metric.split(";")[0]: metric
+        for metric in response["Server-Timing"].split(", ")
+    }
+    assert {"db", "chart", "cache", "total"} <= set(metrics)
+    assert "queries" in metrics["db"]
+    assert "misses" in metrics["cache"]
+
+
+@pytest.mark.django_db
+def test_server_timing_runs_in_async_mode_under_asgi(admin_user, settings):
+    """Staff ASGI responses are timed too, queries from the sync view included."""
+    settings.SERVER_TIMING_HEADER = False
+    project = Project.objects.create(name="Async Timing Project")
+    mechanism = EnvironmentalMechanism.objects.create(
+        name="Async Mechanism", project=project
+    )
+    Obligation.objects.create(
+        obligation_number="OBL001",
+        obligation="Timed Obligation",
+        status="not started",
+        primary_environmental_mechanism=mechanism,
+        project=project,
+        procedure="Waste Management",
+    )
+    url = chart_cache.chart_url(
+        "procedure", mechanism.id, params={"procedure": "Waste Management"}
+    )
+
+    async def get():
+        client = AsyncClient()
+        await client.aforce_login(admin_user)
+        return await client.get(url)
+
+    response = async_to_sync(get)()
+    assert response.status_code == HTTP_OK
+    db_metric = response["Server-Timing"].split(", ")[0]
+    assert db_metric.startswith("db;")
+    assert 'desc="0 queries"' not in db_metric
+
+
+@pytest.mark.django_db
+def test_queued_recounts_are_deduplicated_and_run_by_worker(settings):
+    """Test saves enqueue one recount job per mechanism for the worker."""
+    settings.BACKGROUND_JOBS_EAGER = False
+    project = Project.objects.create(name="Test Project")
+    mechanism = EnvironmentalMechanism.objects.create(name="Air", project=project)
+    for number in ("OBL001", "OBL002", "OBL003"):
+        Obligation.objects.create(
+            obligation_number=number,
+            obligation=f"Obligation {number}",
+            status="not started",
+            primary_environmental_mechanism=mechanism,
+            project=project,
+        )
+
+    mechanism.refresh_from_db()
+    assert mechanism.not_started_count == 0
+    assert BackgroundJob.objects.filter(
+        name="mechanisms.recount", key=str(mechanism.id)
+    ).count() == 1
+    assert BackgroundJob.objects.filter(name="charts.refresh").count() == 1
+
+    assert run_pending_jobs() == 2
+    mechanism.refresh_from_db()
+    assert mechanism.not_started_count == 3
+    assert not BackgroundJob.objects.exists()
+
+
+@pytest.mark.django_db
+def test_failed_jobs_merge_into_work_queued_meanwhile(settings):
+    """Test a failed job requeued beside a pending duplicate is merged into it."""
+    settings.BACKGROUND_JOBS_EAGER = False
+    project = Project.objects.create(name="Test Project")
+    mechanism = EnvironmentalMechanism.objects.create(name="Air", project=project)
+    BackgroundJob.objects.all().delete()
+    key = str(mechanism.id)
+    BackgroundJob.objects.create(name="mechanisms.recount", key=key)
+
+    jobs = _claim_jobs(limit=10)
+    # The same work is requested again while the claimed job runs
+    BackgroundJob.objects.create(name="mechanisms.recount", key=key)
+    _fail_jobs(jobs, RuntimeError("recount failed"))
+
+    assert list(
+        BackgroundJob.objects.values_list("key", "status", "last_error")
+    ) == [(key, BackgroundJob.STATUS_PENDING, "")]
+
+
+@pytest.mark.django_db
+def test_generate_synthetic_data_builds_tenants_and_manifest(tmp_path):
+    """Test synthetic tenants get members, obligations and a load-test manifest."""
+    manifest_path = tmp_path / "synthetic.json"
+    call_command(
+        "generate_synthetic_data",
+        companies=2,
+        projects_per_company=2,
+        users_per_company=3,
+        mechanisms_per_project=2,
+        obligations_per_mechanism=5,
+        manifest=str(manifest_path),
+    )
+
+    companies = Company.objects.filter(name__startswith="Synthetic Company ")
+    assert companies.count() == 2
+    assert CompanyMembership.objects.filter(company__in=companies).count() == 6
+    assert ProjectMembership.objects.filter(
+        project__name__startswith="Synthetic Project "
+    ).count() == 12
+    obligations = Obligation.objects.filter(
+        project__name__startswith="Synthetic Project "
+    )
+    assert obligations.count() == 40
+    assert len(set(obligations.values_list("obligation_number", flat=True))) == 40
+
+    manifest = json.loads(manifest_path.read_text())
+    assert len(manifest["users"]) == 6
+    first = manifest["users"][0]
+    assert User.objects.get(username=first["username"]).check_password(
+        manifest["password"]
+    )
+    assert all(str(pid) in first["mechanisms"] for pid in first["projects"])
+    assert set(first["obligations"]) <= set(
+        obligations.values_list("obligation_number", flat=True)
+    )
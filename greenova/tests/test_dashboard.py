@@ -0,0 +1,115 @@
+"""
+Unit tests for the live dashboard in the Greenova project.
+
+These tests cover the deltas pushed to open dashboards after obligation
+changes and the WebSocket consumer relaying them. Channels is optional, so
+the module is skipped without it.
+"""
+
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+from datetime import timedelta
+
+import pytest
+
+pytest.importorskip("channels")
+
+# pylint: disable=wrong-import-position
+from asgiref.sync import async_to_sync  # noqa: E402
+from channels.layers import get_channel_layer  # noqa: E402
+from channels.routing import URLRouter  # noqa: E402
+from channels.testing import WebsocketCommunicator  # noqa: E402
+from core.jobs import run_pending_jobs  # noqa: E402
+from core.models import BackgroundJob  # noqa: E402
+from dashboard.live import dashboard_group, live_dashboard_path  # noqa: E402
+from dashboard.routing import websocket_urlpatterns  # noqa: E402
+from django.utils import timezone  # noqa: E402
+from mechanisms.models import EnvironmentalMechanism  # noqa: E402
+from obligations.models import Obligation  # noqa: E402
+from projects.models import Project, ProjectMembership  # noqa: E402
+
+
+@pytest.mark.django_db
+def test_committed_obligation_changes_push_dashboard_deltas(
+    django_capture_on_commit_callbacks, settings
+):
+    """Test committed changes are pushed to their project's dashboards in batches."""
+    settings.DASHBOARD_LIVE_UPDATES = True
+    project = Project.objects.create(name="Live Project")
+    mechanism = EnvironmentalMechanism.objects.create(
+        name="Live Mechanism", project=project
+    )
+    layer = get_channel_layer()
+    channel = async_to_sync(layer.new_channel)()
+    async_to_sync(layer.group_add)(dashboard_group(project.id), channel)
+
+    with django_capture_on_commit_callbacks(execute=True):
+        obligation = Obligation.objects.create(
+            obligation_number="OBL001",
+            obligation="Live Obligation",
+            status="in progress",
+            action_due_date=timezone.now().date() - timedelta(days=1),
+            primary_environmental_mechanism=mechanism,
+            project=project,
+        )
+    message = async_to_sync(layer.receive)(channel)
+    assert message["type"] == "dashboard.update"
+    delta = message["delta"]
+    assert delta["project_id"] == project.id
+    assert delta["stats"]["overdue_count"] == 1
+    [row] = delta["obligations"]
+    assert row["obligation_number"] == "PCEMP-OBL001"
+    assert "Overdue" in row["status_html"]
+
+    # Queued, a burst of changes is pushed as one delta by the worker
+    settings.BACKGROUND_JOBS_EAGER = False
+    BackgroundJob.objects.all().delete()
+    with django_capture_on_commit_callbacks(execute=True):
+        obligation.status = "completed"
+        obligation.save()
+    with django_capture_on_commit_callbacks(execute=True):
+        obligation.delete()
+    assert BackgroundJob.objects.filter(name="dashboard.push").count() == 1
+    run_pending_jobs()
+    delta = async_to_sync(layer.receive)(channel)["delta"]
+    assert delta["stats"]["overdue_count"] == 0
+    assert delta["obligations"] == [
+        {"obligation_number": "PCEMP-OBL001", "deleted": True}
+    ]
+
+
+@pytest.mark.django_db(transaction=True)
+def test_dashboard_socket_admits_project_members_and_staff(regular_user, admin_user):
+    """Test the dashboard WebSocket refuses outsiders and relays deltas."""
+    project = Project.objects.create(name="Live Project")
+    other = Project.objects.create(name="Other Project")
+    ProjectMembership.objects.create(user=regular_user, project=project)
+    application = URLRouter(websocket_urlpatterns)
+
+    async def watch(project_id, user=regular_user):
+        communicator = WebsocketCommunicator(
+            application, live_dashboard_path(project_id)
+        )
+        communicator.scope["user"] = user
+        connected, _ = await communicator.connect()
+        received = None
+        if connected:
+            await get_channel_layer().group_send(
+                dashboard_group(project_id),
+                {"type": "dashboard.update", "delta": {"stats": {"active_count": 3}}},
+            )
+            received = await communicator.receive_json_from()
+        await communicator.disconnect()
+        return connected, received
+
+    assert async_to_sync(watch)(other.id) == (False, None)
+    assert async_to_sync(watch)(project.id) == (
+        True,
+        {"stats": {"active_count": 3}},
+    )
+    # Staff may select any project, so they may watch it too
+    assert async_to_sync(watch)(other.id, admin_user) == (
+        True,
+        {"stats": {"active_count": 3}},
+    )
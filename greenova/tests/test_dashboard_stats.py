@@ -0,0 +1,95 @@
+"""
+Unit tests for the dashboard stats snapshot in the Greenova project.
+
+These tests cover the per-project counts kept in ProjectDashboardStats,
+which go stale when obligations change and are recomputed on read.
+"""
+
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+from datetime import timedelta
+from unittest import mock
+
+import pytest
+from dashboard import models as dashboard_models
+from dashboard.models import (
+    ProjectDashboardStats,
+    get_project_stats,
+    mark_project_stats_stale,
+    refresh_project_stats,
+)
+from django.utils import timezone
+from mechanisms.models import EnvironmentalMechanism
+from obligations.models import Obligation
+from projects.models import Project
+
+
+@pytest.mark.django_db
+def test_dashboard_stats_snapshot_is_recomputed_after_changes(
+    django_capture_on_commit_callbacks,
+):
+    """Test the dashboard snapshot counts obligations and goes stale on change."""
+    project = Project.objects.create(name="Stats Project")
+    mechanism = EnvironmentalMechanism.objects.create(name="Water", project=project)
+    today = timezone.now().date()
+    for number, status, due in (
+        ("OBL001", "not started", today - timedelta(days=2)),
+        ("OBL002", "in progress", today + timedelta(days=3)),
+        ("OBL003", "completed", today - timedelta(days=2)),
+    ):
+        Obligation.objects.create(
+            obligation_number=number,
+            obligation=f"Obligation {number}",
+            status=status,
+            action_due_date=due,
+            primary_environmental_mechanism=mechanism,
+            project=project,
+        )
+
+    stats = get_project_stats([project.pk])[project.pk]
+    assert (stats.total_count, stats.active_count, stats.completed_count) == (3, 2, 1)
+    assert (stats.overdue_count, stats.upcoming_count) == (1, 1)
+    assert stats.active_mechanisms_count == 1
+
+    # Marked only once the change commits
+    with django_capture_on_commit_callbacks(execute=True):
+        Obligation.objects.create(obligation="Later", project=project)
+        assert not ProjectDashboardStats.objects.get(pk=project.pk).is_stale
+    assert ProjectDashboardStats.objects.get(pk=project.pk).is_stale
+
+    stats = get_project_stats([project.pk])[project.pk]
+    assert (stats.total_count, stats.active_count, stats.is_stale) == (4, 3, False)
+
+    # A change marked while a refresh counts is not overwritten by it
+    count = dashboard_models.project_stats_aggregates
+
+    def count_during_change(today):
+        mark_project_stats_stale([project.pk])
+        return count(today)
+
+    with mock.patch.object(
+        dashboard_models, "project_stats_aggregates", count_during_change
+    ):
+        refreshed = refresh_project_stats([project.pk])[project.pk]
+    assert refreshed.is_stale
+    assert ProjectDashboardStats.objects.get(pk=project.pk).is_stale
+
+
+@pytest.mark.django_db
+def test_moved_obligation_leaves_previous_project_snapshot(
+    django_capture_on_commit_callbacks,
+):
+    """Test moving an obligation refreshes the snapshots of both projects."""
+    source = Project.objects.create(name="Source Project")
+    target = Project.objects.create(name="Target Project")
+    obligation = Obligation.objects.create(obligation="Moving", project=source)
+    stats = get_project_stats([source.pk, target.pk])
+    assert (stats[source.pk].total_count, stats[target.pk].total_count) == (1, 0)
+
+    obligation.project = target
+    with django_capture_on_commit_callbacks(execute=True):
+        obligation.save()
+
+    stats = get_project_stats([source.pk, target.pk])
+    assert (stats[source.pk].total_count, stats[target.pk].total_count) == (0, 1)
@@ -0,0 +1,59 @@
+"""
+Unit tests for the feedback app in the Greenova project.
+
+These tests cover Protocol Buffer export and import of bug reports.
+"""
+
+# Copyright 2025 Enveng Group.
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+import io
+
+import pytest
+from core.proto_utils import get_proto_message_type, read_delimited
+from django.core.files.uploadedfile import SimpleUploadedFile
+from django.test import Client
+from django.urls import reverse
+from feedback.models import BugReport
+from feedback.proto import feedback_pb2
+from feedback.proto_utils import read_bug_reports, write_bug_reports
+
+
+def test_message_types_are_registered_at_startup():
+    """Test message types resolve without importing modules on demand."""
+    assert get_proto_message_type("feedback.BugReportProto") is (
+        feedback_pb2.BugReportProto
+    )
+
+
+@pytest.mark.django_db
+def test_bug_reports_round_trip_through_delimited_batches(
+    authenticated_client: Client, regular_user
+):
+    """Test the streamed export can be imported again report by report."""
+    for index in range(3):
+        BugReport.objects.create(
+            title=f"Report {index}",
+            description="Broken",
+            created_by=regular_user,
+        )
+
+    buffer = io.BytesIO()
+    assert write_bug_reports(BugReport.objects.order_by("id"), buffer) == 3
+    buffer.seek(0)
+    assert [report.title for report in read_bug_reports(buffer)] == [
+        "Report 0",
+        "Report 1",
+        "Report 2",
+    ]
+
+    response = authenticated_client.get(reverse("feedback:export_reports"))
+    exported = b"".join(response.streaming_content)
+    protos = list(read_delimited(io.BytesIO(exported), feedback_pb2.BugReportProto))
+    assert [proto.title for proto in protos] == ["Report 0", "Report 1", "Report 2"]
+
+    authenticated_client.post(
+        reverse("feedback:import_report"),
+        {"file": SimpleUploadedFile("bug_reports.pbd", exported)},
+    )
+    assert BugReport.objects.filter(title="Report 1").count() == 2
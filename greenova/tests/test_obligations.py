@@ -8,14 +8,31 @@
 # Copyright 2025 Enveng Group.
 # SPDX-License-Identifier: AGPL-3.0-or-later
 
+from datetime import timedelta
+from unittest import mock
+
 import pytest
-from django.test import Client
+from asgiref.sync import async_to_sync
+from company.models import Company, CompanyMembership
+from core.utils.cache import cached, get_cache_stats, project_scope
+from core.utils.files import file_download_response
+from core.utils.pagination import paginate_keyset
+from dateutil.relativedelta import relativedelta
+from django.core.files.uploadedfile import SimpleUploadedFile
+from django.core.management import call_command
+from django.test import AsyncRequestFactory, Client
 from django.urls import reverse
-from mechanisms.models import EnvironmentalMechanism
-from obligations.models import Obligation
-from projects.models import Project
+from django.utils import timezone
+from mechanisms.models import EnvironmentalMechanism, defer_mechanism_counts
+from obligations import views as obligation_views
+from obligations.models import Obligation, ObligationEvidence
+from obligations.recurring import roll_recurring_dates
+from obligations.search import search_obligations, search_vendor
+from obligations.utils import is_obligation_overdue
+from projects.models import Project, ProjectMembership
 
 HTTP_OK = 200
+HTTP_NOT_MODIFIED = 304
 
 
 @pytest.mark.django_db
@@ -119,3 +136,516 @@ def test_obligation_delete_view(admin_client: Client):
     response = admin_client.post(url)
     assert response.status_code == HTTP_OK
     assert not Obligation.objects.filter(obligation_number="OBL001").exists()
+
+
+@pytest.mark.django_db
+def test_overdue_queryset_matches_python_rule():
+    """Test Obligation.objects.overdue() agrees with is_obligation_overdue."""
+    project = Project.objects.create(name="Test Project")
+    today = timezone.now().date()
+    cases = {
+        "OBL001": ("in progress", today - timedelta(days=1)),
+        "OBL002": ("completed", today - timedelta(days=1)),
+        "OBL003": ("not started", today + timedelta(days=1)),
+        "OBL004": ("not started", None),
+    }
+    for number, (status, due_date) in cases.items():
+        Obligation.objects.create(
+            obligation_number=number,
+            obligation=f"Obligation {number}",
+            status=status,
+            action_due_date=due_date,
+            project=project,
+        )
+
+    overdue_numbers = set(
+        Obligation.objects.overdue().values_list("obligation_number", flat=True)
+    )
+    expected = {
+        obligation.obligation_number
+        for obligation in Obligation.objects.all()
+        if is_obligation_overdue(obligation)
+    }
+    assert overdue_numbers == expected == {"PCEMP-OBL001"}
+
+
+@pytest.mark.django_db
+def test_mechanism_counts_follow_obligation_changes():
+    """Test mechanism counters track status and mechanism transitions."""
+    project = Project.objects.create(name="Test Project")
+    first = EnvironmentalMechanism.objects.create(name="First", project=project)
+    second = EnvironmentalMechanism.objects.create(name="Second", project=project)
+
+    with defer_mechanism_counts():
+        for number in ("OBL001", "OBL002"):
+            Obligation.objects.create(
+                obligation_number=number,
+                obligation=f"Obligation {number}",
+                status="not started",
+                primary_environmental_mechanism=first,
+                project=project,
+            )
+    first.refresh_from_db()
+    assert first.not_started_count == 2
+
+    obligation = Obligation.objects.get(obligation_number="PCEMP-OBL001")
+    obligation.status = "completed"
+    obligation.primary_environmental_mechanism = second
+    obligation.save()
+
+    first.refresh_from_db()
+    second.refresh_from_db()
+    assert (first.not_started_count, first.completed_count) == (1, 0)
+    assert (second.not_started_count, second.completed_count) == (0, 1)
+
+
+@pytest.mark.django_db
+def test_obligation_numbers_are_allocated_from_sequence():
+    """Test numbers continue past existing rows and blocks do not overlap."""
+    project = Project.objects.create(name="Test Project")
+    Obligation.objects.create(
+        obligation_number="PCEMP-041", obligation="Existing", project=project
+    )
+
+    assert Obligation.get_next_obligation_number() == "PCEMP-042"
+    assert Obligation.reserve_obligation_numbers(3) == [
+        "PCEMP-043",
+        "PCEMP-044",
+        "PCEMP-045",
+    ]
+
+    Obligation.objects.create(
+        obligation_number="PCEMP-100", obligation="Imported", project=project
+    )
+    created = Obligation.objects.create(obligation="Generated", project=project)
+    assert created.obligation_number == "PCEMP-101"
+
+
+@pytest.mark.django_db
+def test_project_cache_namespace_is_retired_on_obligation_change(
+    django_capture_on_commit_callbacks, settings
+):
+    """Test saving an obligation invalidates only its project's cache entries."""
+    settings.CACHE_STATS_ENABLED = True
+    project = Project.objects.create(name="Cached Project")
+    other = Project.objects.create(name="Other Project")
+    before = get_cache_stats(["test"])["test"]
+
+    assert cached(project_scope(project.pk), "total", lambda: 1, bucket="test") == 1
+    assert cached(project_scope(project.pk), "total", lambda: 2, bucket="test") == 1
+    assert cached(project_scope(other.pk), "total", lambda: 3, bucket="test") == 3
+
+    with django_capture_on_commit_callbacks(execute=True):
+        Obligation.objects.create(obligation="New", project=project)
+
+    assert cached(project_scope(project.pk), "total", lambda: 4, bucket="test") == 4
+    assert cached(project_scope(other.pk), "total", lambda: 5, bucket="test") == 3
+
+    after = get_cache_stats(["test"])["test"]
+    assert after["hits"] - before["hits"] == 2
+    assert after["misses"] - before["misses"] == 3
+
+
+@pytest.mark.django_db
+def test_projects_at_risk_are_annotated_in_one_query(django_assert_num_queries):
+    """Test at-risk projects carry overdue stats without per-project queries."""
+    today = timezone.now().date()
+    for index, overdue_days in enumerate((3, 1, 0)):
+        project = Project.objects.create(name=f"Project {index}")
+        for days in range(1, overdue_days + 1):
+            Obligation.objects.create(
+                obligation=f"Late {days}",
+                status="not started",
+                action_due_date=today - timedelta(days=days),
+                project=project,
+            )
+        Obligation.objects.create(
+            obligation="Done",
+            status="completed",
+            action_due_date=today - timedelta(days=30),
+            project=project,
+        )
+
+    with django_assert_num_queries(1):
+        rows = [
+            (project.name, project.overdue_count, project.last_due_date)
+            for project in Project.objects.at_risk()
+        ]
+
+    assert rows == [
+        ("Project 0", 3, today - timedelta(days=1)),
+        ("Project 1", 1, today - timedelta(days=1)),
+    ]
+
+
+@pytest.mark.django_db
+def test_search_uses_full_text_index_and_follows_saves():
+    """Test search matches comments, ranks titles first and tracks edits."""
+    if search_vendor() is None:
+        pytest.skip("No full-text index for this database")
+    project = Project.objects.create(name="Search Project")
+    Obligation.objects.create(
+        obligation_number="OBL001",
+        obligation="Monitor dust levels at the site boundary",
+        project=project,
+    )
+    noted = Obligation.objects.create(
+        obligation_number="OBL002",
+        obligation="Water sampling",
+        general_comments="Dust suppression reviewed",
+        project=project,
+    )
+    Obligation.objects.create(
+        obligation_number="OBL003", obligation="Lighting survey", project=project
+    )
+
+    def search(text):
+        results = search_obligations(Obligation.objects.all(), text)
+        return [obligation.obligation_number for obligation in results]
+
+    assert search("dust") == ["PCEMP-OBL001", "PCEMP-OBL002"]
+    assert search("monitoring") == ["PCEMP-OBL001"]
+    assert search("PCEMP-OBL003") == ["PCEMP-OBL003"]
+
+    noted.general_comments = "Reviewed"
+    noted.save()
+    assert search("dust") == ["PCEMP-OBL001"]
+
+    noted.delete()
+    assert search("water") == []
+
+
+@pytest.mark.django_db
+def test_keyset_pages_cover_every_row_once():
+    """Test cursors walk all rows in order, NULLs last, forwards and back."""
+    project = Project.objects.create(name="Paging Project")
+    today = timezone.now().date()
+    for index in range(7):
+        Obligation.objects.create(
+            obligation_number=f"OBL{index:03d}",
+            obligation=f"Obligation {index}",
+            # Two rows share a date and two have none
+            action_due_date=(
+                None if index >= 5 else today + timedelta(days=min(index, 3))
+            ),
+            project=project,
+        )
+    queryset = Obligation.objects.filter(project=project)
+    expected = [
+        obligation.obligation_number
+        for obligation in sorted(
+            queryset,
+            key=lambda obligation: (
+                obligation.action_due_date is None,
+                obligation.action_due_date or today,
+                obligation.obligation_number,
+            ),
+        )
+    ]
+
+    pages = [paginate_keyset(queryset, "action_due_date", per_page=3)]
+    while pages[-1].has_next:
+        pages.append(
+            paginate_keyset(
+                queryset, "action_due_date", cursor=pages[-1].next_cursor, per_page=3
+            )
+        )
+    seen = [obligation.obligation_number for page in pages for obligation in page]
+    assert seen == expected
+    assert [len(page) for page in pages] == [3, 3, 1]
+    assert not pages[0].has_previous
+
+    previous = paginate_keyset(
+        queryset, "action_due_date", cursor=pages[-1].previous_cursor, per_page=3
+    )
+    assert [o.obligation_number for o in previous] == expected[3:6]
+    assert previous.has_next and previous.has_previous
+
+    descending = paginate_keyset(
+        queryset, "obligation_number", descending=True, per_page=3
+    )
+    assert [o.obligation_number for o in descending] == sorted(expected, reverse=True)[:3]
+
+    # Descending keeps NULLs last, forwards and backwards
+    expected_desc = [
+        obligation.obligation_number
+        for obligation in sorted(
+            queryset,
+            key=lambda obligation: (
+                obligation.action_due_date is not None,
+                obligation.action_due_date or today,
+                obligation.obligation_number,
+            ),
+            reverse=True,
+        )
+    ]
+    pages = [
+        paginate_keyset(queryset, "action_due_date", descending=True, per_page=3)
+    ]
+    while pages[-1].has_next:
+        pages.append(
+            paginate_keyset(
+                queryset,
+                "action_due_date",
+                cursor=pages[-1].next_cursor,
+                descending=True,
+                per_page=3,
+            )
+        )
+    seen = [obligation.obligation_number for page in pages for obligation in page]
+    assert seen == expected_desc
+    previous = paginate_keyset(
+        queryset,
+        "action_due_date",
+        cursor=pages[-1].previous_cursor,
+        descending=True,
+        per_page=3,
+    )
+    assert [o.obligation_number for o in previous] == expected_desc[3:6]
+
+
+@pytest.mark.django_db(transaction=True)
+def test_evidence_is_stored_once_and_downloaded_in_ranges(
+    admin_client: Client, settings, tmp_path
+):
+    """Test identical evidence shares one file and downloads honour Range."""
+    settings.MEDIA_ROOT = str(tmp_path)
+    project = Project.objects.create(name="Evidence Project")
+    content = b"%PDF-1.4 evidence " * 100
+    for number in ("OBL001", "OBL002"):
+        obligation = Obligation.objects.create(
+            obligation_number=number,
+            obligation=f"Obligation {number}",
+            status="not started",
+            project=project,
+        )
+        response = admin_client.post(
+            reverse("obligations:upload_evidence", args=[obligation.pk]),
+            {"file": SimpleUploadedFile("report.pdf", content)},
+        )
+        assert response.status_code == 302
+
+    first, second = ObligationEvidence.objects.order_by("id")
+    assert first.file.name == second.file.name
+    assert first.size == len(content)
+    assert first.display_name == "report.pdf"
+    assert len(list(tmp_path.rglob("*.pdf"))) == 1
+
+    url = reverse("obligations:download_evidence", args=[first.id])
+    partial = admin_client.get(url, HTTP_RANGE="bytes=0-3")
+    assert partial.status_code == 206
+    assert b"".join(partial.streaming_content) == b"%PDF"
+    assert partial["Content-Range"] == f"bytes 0-3/{len(content)}"
+
+    # Under ASGI both full and ranged downloads stream without buffering
+    async def read(response):
+        return b"".join([chunk async for chunk in response])
+
+    for headers, expected in (({}, content), ({"Range": "bytes=4-7"}, b"-1.4")):
+        request = AsyncRequestFactory().get(url, headers=headers)
+        response = file_download_response(request, first.file, size=first.size)
+        assert response.is_async
+        assert async_to_sync(read)(response) == expected
+        response.close()
+
+    # The stored file goes only when the last evidence using it does
+    first.delete()
+    assert len(list(tmp_path.rglob("*.pdf"))) == 1
+    second.delete()
+    assert not list(tmp_path.rglob("*.pdf"))
+
+
+@pytest.mark.django_db
+def test_csv_export_streams_and_round_trips_through_bulk_import(
+    admin_client: Client, tmp_path
+):
+    """Test the CSV export re-imports with import_obligations --bulk."""
+    project = Project.objects.create(name="Export Project")
+    mechanism = EnvironmentalMechanism.objects.create(name="Water", project=project)
+    due = timezone.now().date() + timedelta(days=10)
+    for number, status in (("OBL001", "not started"), ("OBL002", "completed")):
+        Obligation.objects.create(
+            obligation_number=number,
+            obligation=f"Obligation {number}",
+            status=status,
+            primary_environmental_mechanism=mechanism,
+            project=project,
+            procedure="Monitoring",
+            action_due_date=due,
+        )
+
+    response = admin_client.get(
+        reverse("obligations:export") + f"?format=csv&project_id={project.id}"
+    )
+    assert response.status_code == HTTP_OK
+    content = b"".join(response.streaming_content)
+    header, *rows = content.decode().splitlines()
+    assert header.startswith("obligation__number,project,")
+    assert len(rows) == 2
+
+    export_file = tmp_path / "obligations.csv"
+    export_file.write_bytes(content)
+    Obligation.objects.all().delete()
+    call_command(
+        "import_obligations", str(export_file), project=project.name, bulk=True
+    )
+
+    imported = Obligation.objects.order_by("obligation_number")
+    assert [(o.obligation_number, o.status) for o in imported] == [
+        ("PCEMP-OBL001", "not started"),
+        ("PCEMP-OBL002", "completed"),
+    ]
+    assert {o.action_due_date for o in imported} == {due}
+    assert {o.primary_environmental_mechanism_id for o in imported} == {mechanism.id}
+
+
+@pytest.mark.django_db
+def test_export_streams_chunk_by_chunk_under_asgi(admin_user):
+    """Test ASGI exports get an async iterator rather than a buffered list."""
+    project = Project.objects.create(name="ASGI Export Project")
+    mechanism = EnvironmentalMechanism.objects.create(name="Air", project=project)
+    for number in ("OBL001", "OBL002", "OBL003"):
+        Obligation.objects.create(
+            obligation_number=number,
+            obligation=f"Obligation {number}",
+            primary_environmental_mechanism=mechanism,
+            project=project,
+        )
+
+    async def read(response):
+        return [chunk async for chunk in response]
+
+    request = AsyncRequestFactory().get(
+        reverse("obligations:export"), {"format": "csv", "project_id": project.id}
+    )
+    request.user = admin_user
+    response = obligation_views.export_obligations(request)
+    assert response.status_code == HTTP_OK
+    assert response.is_async
+    content = b"".join(async_to_sync(read)(response))
+    assert len(content.decode().splitlines()) == 4
+
+
+@pytest.mark.django_db
+def test_recurring_rollover_advances_lapsed_forecasts_in_bulk():
+    """Test lapsed recurring forecasts roll on without saving each row."""
+    project = Project.objects.create(name="Recurring Project")
+    today = timezone.now().date()
+    rows = {
+        "OBL001": ("monthly", today - timedelta(days=3), None),
+        "OBL002": ("Weekly", None, today + timedelta(days=5)),
+        "OBL003": ("monthly", today + timedelta(days=2), None),
+    }
+    for number, (frequency, forecast, due) in rows.items():
+        Obligation.objects.create(
+            obligation_number=number,
+            obligation=f"Obligation {number}",
+            status="not started",
+            project=project,
+            recurring_obligation=True,
+            recurring_frequency=frequency,
+            action_due_date=due,
+        )
+        # Bypass pre_save so the stored forecast is the lapsed one
+        Obligation.objects.filter(obligation_number=f"PCEMP-{number}").update(
+            recurring_forcasted_date=forecast
+        )
+
+    assert roll_recurring_dates([project.id]) == 2
+    forecasts = dict(
+        Obligation.objects.values_list("obligation_number", "recurring_forcasted_date")
+    )
+    assert forecasts["PCEMP-OBL001"] == today + relativedelta(months=1)
+    assert forecasts["PCEMP-OBL002"] == today + timedelta(days=12)
+    assert forecasts["PCEMP-OBL003"] == today + timedelta(days=2)
+
+    # Completing a loaded recurring obligation restarts it from tracked values
+    obligation = Obligation.objects.get(obligation_number="PCEMP-OBL003")
+    obligation.status = "completed"
+    obligation.save()
+    obligation.refresh_from_db()
+    assert obligation.status == "not started"
+    assert obligation.recurring_forcasted_date == today + timedelta(days=2) + (
+        relativedelta(months=1)
+    )
+
+
+@pytest.mark.django_db
+def test_summary_partial_is_cached_until_project_data_changes(
+    admin_client, django_capture_on_commit_callbacks, settings
+):
+    """Test HTMX summary swaps are served from the fragment cache or a 304."""
+    settings.CACHE_STATS_ENABLED = True
+    project = Project.objects.create(name="Fragment Project")
+    mechanism = EnvironmentalMechanism.objects.create(
+        name="Fragment Mechanism", project=project
+    )
+    obligation = Obligation.objects.create(
+        obligation_number="OBL001",
+        obligation="Fragment Obligation",
+        status="not started",
+        primary_environmental_mechanism=mechanism,
+        project=project,
+    )
+    url = reverse("obligations:summary") + f"?mechanism_id={mechanism.id}"
+
+    with mock.patch.object(
+        obligation_views, "render_to_string", wraps=obligation_views.render_to_string
+    ) as render:
+        first = admin_client.get(url, HTTP_HX_REQUEST="true")
+        second = admin_client.get(url, HTTP_HX_REQUEST="true")
+        assert first.status_code == HTTP_OK
+        assert "Fragment Obligation" in first.content.decode()
+        assert second.content == first.content
+        assert render.call_count == 1
+
+        revalidated = admin_client.get(
+            url, HTTP_HX_REQUEST="true", HTTP_IF_NONE_MATCH=first["ETag"]
+        )
+        assert revalidated.status_code == HTTP_NOT_MODIFIED
+        assert render.call_count == 1
+
+        obligation.obligation = "Renamed Obligation"
+        with django_capture_on_commit_callbacks(execute=True):
+            obligation.save()
+        changed = admin_client.get(
+            url, HTTP_HX_REQUEST="true", HTTP_IF_NONE_MATCH=first["ETag"]
+        )
+        assert changed.status_code == HTTP_OK
+        assert changed["ETag"] != first["ETag"]
+        assert "Renamed Obligation" in changed.content.decode()
+        assert render.call_count == 2
+
+    assert get_cache_stats(["fragments"])["fragments"]["hits"] >= 1
+
+
+@pytest.mark.django_db
+def test_user_summary_follows_membership_changes(
+    admin_client, admin_user, django_capture_on_commit_callbacks
+):
+    """Test the cached overdue summary of a user is retired by new memberships."""
+    company = Company.objects.create(name="Summary Company")
+    CompanyMembership.objects.create(user=admin_user, company=company, role="manager")
+    overdue = timezone.now().date() - timedelta(days=1)
+    for name in ("Joined", "Later"):
+        project = Project.objects.create(name=f"{name} Project")
+        Obligation.objects.create(
+            obligation=f"{name} Obligation",
+            status="not started",
+            action_due_date=overdue,
+            responsibility="manager",
+            project=project,
+        )
+    ProjectMembership.objects.create(
+        user=admin_user, project=Project.objects.get(name="Joined Project")
+    )
+    url = reverse("obligations:summary")
+
+    first = admin_client.get(url, HTTP_HX_REQUEST="true").content.decode()
+    assert "Joined Obligation" in first
+    assert "Later Obligation" not in first
+
+    with django_capture_on_commit_callbacks(execute=True):
+        ProjectMembership.objects.create(user=admin_user, project=project)
+    second = admin_client.get(url, HTTP_HX_REQUEST="true").content.decode()
+    assert "Later Obligation" in second
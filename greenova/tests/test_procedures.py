@@ -8,13 +8,21 @@
 # Copyright 2025 Enveng Group.
 # SPDX-License-Identifier: AGPL-3.0-or-later
 
+from datetime import timedelta
+from unittest import mock
+
 import pytest
+from core.utils import chart_cache
 from django.urls import reverse
+from django.utils import timezone
 from mechanisms.models import EnvironmentalMechanism
 from obligations.models import Obligation
-from projects.models import Project
+from procedures.figures import get_procedure_stats
+from projects.models import Project, ProjectMembership
 
 HTTP_OK = 200
+HTTP_NOT_MODIFIED = 304
+HTTP_NOT_FOUND = 404
 
 
 @pytest.mark.django_db
@@ -39,3 +47,164 @@ def test_procedure_charts_interactivity(authenticated_client):
     response = authenticated_client.get(url, HTTP_HX_REQUEST="true")
     assert response.status_code == HTTP_OK
     assert "Test Obligation" in response.content.decode()
+
+
+@pytest.mark.django_db
+def test_procedure_chart_images_render_once_until_data_changes(
+    authenticated_client, regular_user
+):
+    """Chart images are cached and revalidated until an obligation changes."""
+    project = Project.objects.create(name="Chart Cache Project")
+    ProjectMembership.objects.create(user=regular_user, project=project)
+    mechanism = EnvironmentalMechanism.objects.create(
+        name="Chart Cache Mechanism", project=project
+    )
+    obligation = Obligation.objects.create(
+        obligation_number="OBL001",
+        obligation="Test Obligation",
+        status="not started",
+        primary_environmental_mechanism=mechanism,
+        project=project,
+        procedure="Cultural Heritage Management",
+    )
+
+    url = chart_cache.chart_url(
+        "procedure", mechanism.id, params={"procedure": obligation.procedure}
+    )
+
+    with mock.patch.object(
+        chart_cache, "figure_to_bytes", wraps=chart_cache.figure_to_bytes
+    ) as render:
+        first = authenticated_client.get(url)
+        second = authenticated_client.get(url)
+        assert first.status_code == HTTP_OK
+        assert first["Content-Type"] == "image/png"
+        assert first.content == second.content
+        assert render.call_count == 1
+
+        # The browser copy is still valid, so nothing is sent or rendered
+        revalidated = authenticated_client.get(url, HTTP_IF_NONE_MATCH=first["ETag"])
+        assert revalidated.status_code == HTTP_NOT_MODIFIED
+        assert render.call_count == 1
+
+        obligation.status = "completed"
+        obligation.save()
+        changed = authenticated_client.get(url, HTTP_IF_NONE_MATCH=first["ETag"])
+        assert changed.status_code == HTTP_OK
+        assert changed["ETag"] != first["ETag"]
+        assert render.call_count == 2
+
+
+@pytest.mark.django_db
+def test_procedure_chart_data_mode_skips_matplotlib(
+    authenticated_client, regular_user
+):
+    """The JSON series of a chart is served without rendering an image."""
+    project = Project.objects.create(name="Chart Data Project")
+    ProjectMembership.objects.create(user=regular_user, project=project)
+    mechanism = EnvironmentalMechanism.objects.create(
+        name="Chart Data Mechanism", project=project
+    )
+    Obligation.objects.create(
+        obligation_number="OBL002",
+        obligation="Test Obligation",
+        status="in progress",
+        primary_environmental_mechanism=mechanism,
+        project=project,
+        procedure="Waste Management",
+    )
+
+    url = chart_cache.chart_data_url(
+        chart_cache.chart_url(
+            "procedure", mechanism.id, params={"procedure": "Waste Management"}
+        )
+    )
+    with mock.patch.object(chart_cache, "figure_to_bytes") as render:
+        response = authenticated_client.get(url)
+
+    assert response.status_code == HTTP_OK
+    assert render.call_count == 0
+    series = response.json()
+    assert series["type"] == "pie"
+    assert dict(zip(series["labels"], series["values"])) == {
+        "Not Started": 0,
+        "In Progress": 1,
+        "Completed": 0,
+    }
+
+
+@pytest.mark.django_db
+def test_charts_of_other_tenants_are_not_found(authenticated_client, regular_user):
+    """Non-members get a 404 for a project's charts, as do all-project charts."""
+    project = Project.objects.create(name="Other Tenant")
+    mechanism = EnvironmentalMechanism.objects.create(
+        name="Other Mechanism", project=project
+    )
+    Obligation.objects.create(
+        obligation_number="OBL003",
+        obligation="Other Obligation",
+        status="not started",
+        primary_environmental_mechanism=mechanism,
+        project=project,
+        procedure="Waste Management",
+    )
+    urls = [
+        chart_cache.chart_url(
+            "procedure", mechanism.id, params={"procedure": "Waste Management"}
+        ),
+        chart_cache.chart_url("responsibility", mechanism.id),
+        chart_cache.chart_url("mechanism", mechanism.id),
+        chart_cache.chart_url("mechanism-overall", project.id),
+        chart_cache.chart_url("obligation-status", project.id),
+        chart_cache.chart_url("obligation-status"),
+    ]
+    for url in urls:
+        assert authenticated_client.get(url).status_code == HTTP_NOT_FOUND, url
+
+    ProjectMembership.objects.create(user=regular_user, project=project)
+    for url in urls[:-1]:
+        assert authenticated_client.get(url).status_code == HTTP_OK, url
+    # The all-projects chart stays staff-only
+    assert authenticated_client.get(urls[-1]).status_code == HTTP_NOT_FOUND
+
+
+@pytest.mark.django_db
+def test_procedure_stats_come_from_one_query(django_assert_num_queries):
+    """Every procedure's status and overdue counts are read in one query."""
+    project = Project.objects.create(name="Stats Project")
+    mechanism = EnvironmentalMechanism.objects.create(
+        name="Stats Mechanism", project=project
+    )
+    yesterday = timezone.now().date() - timedelta(days=1)
+    rows = [
+        ("OBL001", "Noise", "not started", yesterday),
+        ("OBL002", "Noise", "completed", yesterday),
+        ("OBL003", "Noise", "in progress", None),
+        ("OBL004", "Dust", "in progress", yesterday),
+        ("OBL005", "", "not started", yesterday),
+    ]
+    for number, procedure, status, due in rows:
+        Obligation.objects.create(
+            obligation_number=number,
+            obligation=f"Obligation {number}",
+            status=status,
+            primary_environmental_mechanism=mechanism,
+            project=project,
+            procedure=procedure,
+            action_due_date=due,
+        )
+
+    with django_assert_num_queries(1):
+        stats = get_procedure_stats(
+            Obligation.objects.filter(primary_environmental_mechanism=mechanism)
+        )
+
+    assert list(stats) == ["Dust", "Noise"]
+    assert stats["Noise"] == {
+        "not_started": 1,
+        "in_progress": 1,
+        "completed": 1,
+        "overdue": 1,
+        "total": 3,
+    }
+    assert stats["Dust"]["overdue"] == 1
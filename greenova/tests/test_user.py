@@ -11,9 +11,14 @@
 
 import pytest
 from company.models import CompanyMembership
+from core.middleware import ProjectSelectionMiddleware
+from django.contrib.auth import get_user_model
+from django.contrib.sessions.middleware import SessionMiddleware
 from django.urls import reverse
 from django.utils import timezone
 from obligations.models import Obligation
+from projects.models import Project
+from projects.templatetags.project_tags import get_user_role
 from users.models import Profile
 
 HTTP_OK = 200
@@ -311,3 +316,73 @@ def test_profile_image_accessbility(self, authenticated_client, regular_user):
         else:
             # Otherwise check for profile initial
             assert '<div class="profile-initial"' in content
+
+
+@pytest.mark.django_db
+class TestUserProjectRoles:
+    """Test suite for the per-request project membership map."""
+
+    def test_roles_for_many_projects_cost_one_query(
+        self, regular_user, django_assert_num_queries
+    ):
+        """Test role lookups across projects share one membership query."""
+        projects = [Project.objects.create(name=f"Project {i}") for i in range(5)]
+        for project, role in zip(projects, ("owner", "manager", "member")):
+            project.add_member(regular_user, role=role)
+
+        # A fresh user object, as each request gets from the session
+        user = get_user_model().objects.get(pk=regular_user.pk)
+        with django_assert_num_queries(1):
+            roles = [get_user_role(project, user) for project in projects]
+        assert roles == ["owner", "manager", "member", "viewer", "viewer"]
+
+        projects[0].remove_member(user)
+        assert projects[0].get_user_role(user) == "viewer"
+        assert not projects[0].has_member(user)
+
+    def test_project_selection_is_validated_and_written_once(
+        self, rf, regular_user
+    ):
+        """Test only member projects are selected and unchanged ones not saved."""
+        project = Project.objects.create(name="Member Project")
+        other = Project.objects.create(name="Other Project")
+        project.add_member(regular_user)
+        middleware = ProjectSelectionMiddleware(lambda request: None)
+
+        def select(project_id, session=None):
+            request = rf.get("/", {"project_id": project_id})
+            request.user = get_user_model().objects.get(pk=regular_user.pk)
+            if session is None:
+                SessionMiddleware(lambda request: None).process_request(request)
+            else:
+                request.session = session
+            middleware.process_request(request)
+            return request
+
+        request = select(project.pk)
+        assert request.selected_project_id == str(project.pk)
+        assert request.session.modified
+
+        request.session.modified = False
+        repeated = select(project.pk, request.session)
+        assert repeated.selected_project_id == str(project.pk)
+        assert not repeated.session.modified
+
+        refused = select(other.pk, request.session)
+        assert refused.selected_project_id == str(project.pk)
+        assert not refused.session.modified
+
+        # A stored selection goes once the user leaves the project
+        project.remove_member(regular_user)
+        removed = select("", request.session)
+        assert removed.selected_project_id is None
+        assert "selected_project_id" not in removed.session
+
+    def test_staff_may_select_any_project(self, rf, admin_user):
+        """Test staff and superusers select projects they are not members of."""
+        project = Project.objects.create(name="Unjoined Project")
+        request = rf.get("/", {"project_id": project.pk})
+        request.user = admin_user
+        SessionMiddleware(lambda request: None).process_request(request)
+        ProjectSelectionMiddleware(lambda request: None).process_request(request)
+        assert request.selected_project_id == str(project.pk)
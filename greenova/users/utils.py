@@ -24,4 +24,4 @@ def calculate_overdue_obligations(user_id: int) -> list[Obligation]:
         .select_related("project")
         .distinct()
     )
-    return [obligation for obligation in obligations if obligation.is_overdue]
+    return list(obligations.overdue())
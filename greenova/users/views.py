@@ -86,14 +86,9 @@ def profile_view(request: HttpRequest) -> HttpResponse:
             .distinct()
         )
 
-        # Get obligations that are overdue
-        overdue_obligations = [
-            obligation for obligation in obligations if obligation.is_overdue
-        ]
-
         context: dict[str, Any] = {
             "profile": profile,
-            "overdue_count": len(overdue_obligations),
+            "overdue_count": obligations.overdue().count(),
         }
 
     if request.htmx:
@@ -0,0 +1,140 @@
+"""
+Locust scenarios exercising Greenova's HTMX flows.
+
+Users come from the manifest written by
+``manage.py generate_synthetic_data --manifest``; each simulated user logs
+in as the next manifest user and then mixes project selection (the
+``project_id`` query string resolved by ProjectSelectionMiddleware),
+obligation filters, procedure charts, evidence uploads and chat messages.
+
+    LOCUST_MANIFEST=synthetic.json locust -f loadtests/locustfile.py \\
+        --host http://127.0.0.1:8000
+
+``loadtests/run_matrix.py`` runs these scenarios headless against several
+gunicorn configurations and tabulates the results.
+"""
+
+import itertools
+import json
+import os
+import random
+import threading
+
+from locust import HttpUser, between, task
+
+MANIFEST_PATH = os.environ.get("LOCUST_MANIFEST", "synthetic.json")
+# Size of each uploaded evidence file
+EVIDENCE_KB = int(os.environ.get("LOCUST_EVIDENCE_KB", "256"))
+STATUSES = ("not started", "in progress", "completed", "overdue")
+CHAT_MESSAGES = (
+    "How do I add an obligation?",
+    "Which obligations are overdue?",
+    "Where are the procedure charts?",
+)
+HTMX_HEADERS = {"HX-Request": "true"}
+
+with open(MANIFEST_PATH, encoding="utf-8") as manifest_file:
+    MANIFEST = json.load(manifest_file)
+
+_users = itertools.cycle(MANIFEST["users"])
+_users_lock = threading.Lock()
+
+
+def next_manifest_user():
+    with _users_lock:
+        return next(_users)
+
+
+class GreenovaUser(HttpUser):
+    """A project member browsing, filtering, uploading and chatting."""
+
+    wait_time = between(1, 5)
+
+    def on_start(self):
+        self.account = next_manifest_user()
+        self.client.get("/accounts/login/", name="login")
+        self.client.post(
+            "/accounts/login/",
+            {
+                "login": self.account["username"],
+                "password": MANIFEST["password"],
+                "csrfmiddlewaretoken": self.csrf_token,
+            },
+            headers={"Referer": f"{self.host}/accounts/login/"},
+            name="login",
+        )
+        self.project_id = random.choice(self.account["projects"])
+
+    @property
+    def csrf_token(self):
+        return self.client.cookies.get("csrftoken", "")
+
+    def post_headers(self, **headers):
+        return {"X-CSRFToken": self.csrf_token, "Referer": self.host, **headers}
+
+    def mechanism_id(self):
+        return random.choice(self.account["mechanisms"][str(self.project_id)])
+
+    @task(3)
+    def select_project(self):
+        self.project_id = random.choice(self.account["projects"])
+        self.client.get(
+            f"/dashboard/?project_id={self.project_id}",
+            headers=HTMX_HEADERS,
+            name="/dashboard/?project_id=[id]",
+        )
+
+    @task(5)
+    def filter_obligations(self):
+        params = {
+            "mechanism_id": self.mechanism_id(),
+            "project_id": self.project_id,
+            "status": random.choice(STATUSES),
+        }
+        self.client.get(
+            "/obligations/summary/",
+            params=params,
+            headers=HTMX_HEADERS,
+            name="/obligations/summary/ [filter]",
+        )
+
+    @task(2)
+    def list_obligations(self):
+        self.client.get(
+            "/obligations/list/",
+            params={"project_id": self.project_id},
+            headers=HTMX_HEADERS,
+            name="/obligations/list/",
+        )
+
+    @task(2)
+    def procedure_charts(self):
+        self.client.get(
+            f"/procedures/charts/{self.mechanism_id()}/",
+            headers=HTMX_HEADERS,
+            name="/procedures/charts/[id]/",
+        )
+
+    @task(1)
+    def upload_evidence(self):
+        number = random.choice(self.account["obligations"])
+        content = os.urandom(EVIDENCE_KB * 1024)
+        self.client.post(
+            f"/obligations/evidence/upload/{number}/",
+            files={"file": (f"evidence-{number}.pdf", content, "application/pdf")},
+            data={"description": "Load test evidence"},
+            headers=self.post_headers(),
+            name="/obligations/evidence/upload/[number]/",
+        )
+
+    @task(2)
+    def chat(self):
+        conversation_id = self.account["conversation_id"]
+        if conversation_id is None:
+            return
+        self.client.post(
+            f"/chatbot/conversation/{conversation_id}/send/",
+            data=json.dumps({"message": random.choice(CHAT_MESSAGES)}),
+            headers=self.post_headers(**{"Content-Type": "application/json"}),
+            name="/chatbot/conversation/[id]/send/",
+        )
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""
+Run the Locust scenarios against several gunicorn configurations.
+
+For every combination of ``--workers`` and ``--worker-classes`` a gunicorn
+server is started with gunicorn.conf.py (GUNICORN_WORKERS and
+GUNICORN_WORKER_CLASS set accordingly), Locust runs headless against it,
+and the server is stopped. Locust's CSV reports are kept per configuration
+under ``--output``, and a summary table of requests per second, failures
+and p50/p95/p99 latency is printed and written to ``summary.md``.
+
+    python loadtests/run_matrix.py --manifest synthetic.json \\
+        --workers 1 2 4 --worker-classes sync uvicorn.workers.UvicornWorker
+"""
+
+import argparse
+import csv
+import os
+import signal
+import subprocess
+import sys
+import time
+import urllib.error
+import urllib.request
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parent.parent
+APP_DIR = REPO_ROOT / "greenova"
+LOCUSTFILE = Path(__file__).resolve().parent / "locustfile.py"
+# Uvicorn workers serve the ASGI application, the others WSGI
+ASGI_WORKER_PREFIX = "uvicorn."
+
+
+def application_for(worker_class: str) -> str:
+    if worker_class.startswith(ASGI_WORKER_PREFIX):
+        return "greenova.asgi:application"
+    return "greenova.wsgi:application"
+
+
+def wait_until_up(url: str, timeout: float) -> None:
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            urllib.request.urlopen(url, timeout=2)  # nosec B310 - local URL
+            return
+        except urllib.error.HTTPError:
+            return  # Any HTTP answer means the server is accepting requests
+        except OSError:
+            time.sleep(0.5)
+    raise RuntimeError(f"Server at {url} did not come up within {timeout}s")
+
+
+def run_configuration(args, workers: int, worker_class: str) -> dict:
+    label = f"{workers}x{worker_class.rsplit('.', 1)[-1]}"
+    prefix = Path(args.output) / label
+    prefix.parent.mkdir(parents=True, exist_ok=True)
+    host = f"http://127.0.0.1:{args.port}"
+    env = {
+        **os.environ,
+        "GUNICORN_BIND": f"127.0.0.1:{args.port}",
+        "GUNICORN_WORKERS": str(workers),
+        "GUNICORN_WORKER_CLASS": worker_class,
+    }
+    server = subprocess.Popen(  # nosec B603 - fixed argument list
+        [
+            sys.executable,
+            "-m",
+            "gunicorn",
+            "-c",
+            str(REPO_ROOT / "gunicorn.conf.py"),
+            application_for(worker_class),
+        ],
+        cwd=APP_DIR,
+        env=env,
+    )
+    try:
+        wait_until_up(f"{host}/accounts/login/", args.startup_timeout)
+        subprocess.run(  # nosec B603 - fixed argument list
+            [
+                sys.executable,
+                "-m",
+                "locust",
+                "-f",
+                str(LOCUSTFILE),
+                "--headless",
+                "--host",
+                host,
+                "--users",
+                str(args.users),
+                "--spawn-rate",
+                str(args.spawn_rate),
+                "--run-time",
+                args.run_time,
+                "--csv",
+                str(prefix),
+                "--only-summary",
+            ],
+            env={**os.environ, "LOCUST_MANIFEST": args.manifest},
+            check=False,
+        )
+    finally:
+        server.send_signal(signal.SIGTERM)
+        server.wait(timeout=30)
+    return read_totals(label, Path(f"{prefix}_stats.csv"))
+
+
+def read_totals(label: str, stats_path: Path) -> dict:
+    """Return the 'Aggregated' row of a Locust stats CSV."""
+    with stats_path.open(encoding="utf-8", newline="") as stats_file:
+        for row in csv.DictReader(stats_file):
+            if row["Name"] == "Aggregated":
+                return {
+                    "configuration": label,
+                    "rps": float(row["Requests/s"]),
+                    "failures": int(row["Failure Count"]),
+                    "requests": int(row["Request Count"]),
+                    "p50": row["50%"],
+                    "p95": row["95%"],
+                    "p99": row["99%"],
+                }
+    raise RuntimeError(f"No aggregated row in {stats_path}")
+
+
+def format_summary(results: list) -> str:
+    lines = [
+        "| Configuration | Requests | Req/s | Failures | p50 ms | p95 ms | p99 ms |",
+        "| --- | ---: | ---: | ---: | ---: | ---: | ---: |",
+    ]
+    for result in results:
+        lines.append(
+            f"| {result['configuration']} | {result['requests']} "
+            f"| {result['rps']:.1f} | {result['failures']} | {result['p50']} "
+            f"| {result['p95']} | {result['p99']} |"
+        )
+    return "\n".join(lines)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument(
+        "--manifest", required=True, help="generate_synthetic_data manifest"
+    )
+    parser.add_argument("--workers", type=int, nargs="+", default=[1, 2, 4])
+    parser.add_argument(
+        "--worker-classes",
+        nargs="+",
+        default=["sync", "uvicorn.workers.UvicornWorker"],
+    )
+    parser.add_argument("--users", type=int, default=50, help="Concurrent users")
+    parser.add_argument("--spawn-rate", type=float, default=5)
+    parser.add_argument("--run-time", default="2m")
+    parser.add_argument("--port", type=int, default=8765)
+    parser.add_argument("--startup-timeout", type=float, default=60)
+    parser.add_argument("--output", default="loadtest-results")
+    args = parser.parse_args()
+    args.manifest = str(Path(args.manifest).resolve())
+
+    results = [
+        run_configuration(args, workers, worker_class)
+        for worker_class in args.worker_classes
+        for workers in args.workers
+    ]
+    summary = format_summary(results)
+    Path(args.output, "summary.md").write_text(summary + "\n", encoding="utf-8")
+    print(summary)
+
+
+if __name__ == "__main__":
+    main()